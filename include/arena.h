@@ -0,0 +1,122 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Region allocator. Memory is carved sequentially from large blocks and
+ * can only be released all at once, which makes it a good fit for
+ * sentence graphs that are built up and thrown away together.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define ARENA_BLOCK_SIZE 65536
+#define ARENA_ALIGNMENT 16
+
+/// ===========================================================================
+/// Structure declarations
+/// ===========================================================================
+
+struct ArenaBlock_s;
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Blocks are kept in a singly linked list, newest first. Only the head
+ * block is ever allocated from; older blocks are full.
+ */
+struct ArenaBlock_s
+{
+	struct ArenaBlock_s* next;
+	size_t size;
+	size_t used;
+};
+
+struct Arena_s
+{
+	struct ArenaBlock_s* head;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct Arena_s* Arena;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates an empty arena. No block is allocated until the first
+ * call to Arena_alloc().
+ *
+ * @return Returns a malloc'd Arena.
+ */
+Arena Arena_create();
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees every block owned by the arena, and the arena itself. All
+ * pointers previously returned by the arena become invalid.
+ *
+ * @param arena Arena to free.
+ */
+void Arena_free(Arena arena);
+
+/**
+ * Releases everything allocated from the arena but keeps its most recent
+ * block around, so that a parse-and-discard loop does not go back to
+ * malloc on every iteration.
+ *
+ * @param arena Arena to reset.
+ */
+void Arena_reset(Arena arena);
+
+/**
+ * Moves every block of other into arena, then frees other. Pointers
+ * allocated from other stay valid and are now released with arena.
+ *
+ * @param arena Arena that takes over the blocks.
+ * @param other Arena to empty and free.
+ */
+void Arena_merge(Arena arena, Arena other);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Allocates size bytes aligned to ARENA_ALIGNMENT. The memory is
+ * not zeroed.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Number of bytes.
+ * @return Returns a pointer owned by the arena.
+ */
+void* Arena_alloc(Arena arena, size_t size);
+
+/**
+ * Copies len characters of the string into the arena and null-terminates
+ * the copy.
+ *
+ * @param arena Arena to allocate from.
+ * @param string String to copy, need not be null-terminated.
+ * @param len Number of characters to copy.
+ * @return Returns the copy, owned by the arena.
+ */
+char* Arena_copyString(Arena arena, const char* string, size_t len);
+
+#endif
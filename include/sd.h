@@ -1,14 +1,280 @@
 /**
  * @author Michael Bianconi
  * @since 04-18-2019
+ *
+ * Derivations in SD, the natural deduction system with an introduction
+ * and an elimination rule for each operator, reiteration, and
+ * subproofs. Since negation is a flag on a sentence, ~~P is P, and
+ * negation introduction and elimination differ only in whether the
+ * sentence they derive is negated.
+ *
+ * Citations:
+ *   R i; &I i, j; &E i; vI i; vE i, j-k, l-m; >I j-k; >E i, j;
+ *   =I j-k, l-m; =E i, j; ~I j-k; ~E j-k
+ * where i and j are lines and j-k is a subproof. A ~I or ~E subproof
+ * contains some Q and ~Q.
  */
 
 #ifndef SD_H
 #define SD_H
 
 #include "sentence.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 
 /// ===========================================================================
-/// Function definitions - SD Rules
+/// Definitions
 /// ===========================================================================
 
+// Suggested limits for SD_derive(): nested goals, and goals tried in all
+#define SD_DEPTH 12
+#define SD_NODES 1000000
+
+// Lock stripes of the table of failed goals
+#define SD_SHARDS 64
+
+// Goals a thread tries between updates of the shared count
+#define SD_BATCH 64
+
+/// ===========================================================================
+/// Enum definitions
+/// ===========================================================================
+
+enum SDRule
+{
+	SD_PREMISE,
+	SD_ASSUMPTION,
+	SD_REITERATION,
+	SD_AND_INTRO,
+	SD_AND_ELIM,
+	SD_OR_INTRO,
+	SD_OR_ELIM,
+	SD_IMPLIES_INTRO,
+	SD_IMPLIES_ELIM,
+	SD_IFF_INTRO,
+	SD_IFF_ELIM,
+	SD_NOT_INTRO,
+	SD_NOT_ELIM
+};
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * A cited line, with first == last, or a subproof from its assumption to
+ * its last line. Lines are numbered from 1, as they are written.
+ */
+struct SDCitation_s
+{
+	size_t first;
+	size_t last;
+};
+
+/**
+ * depth is the number of subproofs the line is in. An assumption is in
+ * the subproof it opens.
+ */
+struct SDLine_s
+{
+	Sentence sentence;
+	enum SDRule rule;
+	uint32_t depth;
+	uint8_t numCitations;
+	struct SDCitation_s citations[3];
+};
+
+struct SDDerivation_s
+{
+	size_t size;
+	size_t buffer;
+	struct SDLine_s* lines;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef enum SDRule SDRule;
+typedef struct SDCitation_s SDCitation;
+typedef struct SDLine_s SDLine;
+typedef struct SDDerivation_s* SDDerivation;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a derivation with no lines.
+ *
+ * @return Returns a malloc'd SDDerivation.
+ */
+SDDerivation SDDerivation_create();
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the derivation, but not its sentences.
+ *
+ * @param derivation Derivation to free.
+ */
+void SDDerivation_free(SDDerivation derivation);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Appends a line.
+ *
+ * @param derivation Derivation to append to.
+ * @param sentence Sentence of the line.
+ * @param rule Rule that justifies it.
+ * @param depth Number of subproofs the line is in.
+ * @param citations Cited lines and subproofs, may be NULL if
+ *        numCitations is 0.
+ * @param numCitations Number of citations, at most 3.
+ */
+void SDDerivation_add(
+	SDDerivation derivation,
+	const Sentence sentence,
+	const SDRule rule,
+	const uint32_t depth,
+	const SDCitation* citations,
+	const uint8_t numCitations);
+
+/// ===========================================================================
+/// Function declarations - SD Rules
+/// ===========================================================================
+
+/**
+ * Searches for a derivation of the goal from the premises. The search
+ * works backwards from the goal: it takes the goal out of an available
+ * line with elimination rules, builds it with the introduction rule of
+ * its main operator, splits on an available disjunction, or assumes its
+ * negation. Subproofs are searched in turn to the same limits.
+ *
+ * The depth limit is raised one step at a time up to maxDepth, so the
+ * first derivation found is among the shallowest. Goals that failed
+ * under the same assumptions are remembered, by the address of the
+ * hash-consed sentence, and not searched again with less depth.
+ *
+ * @param set Set that owns the premises and goal, and receives the
+ *        sentences the search tries.
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param goal Sentence to derive.
+ * @param maxDepth Largest depth of nested goals to try.
+ * @param maxNodes Largest number of goals to try, over all depths.
+ * @return Returns a malloc'd SDDerivation whose last line is the goal at
+ *         depth 0, or NULL if none was found within the limits.
+ */
+SDDerivation SD_derive(
+	SentenceSet set,
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence goal,
+	const size_t maxDepth,
+	const size_t maxNodes);
+
+/**
+ * Same as SD_derive(), but searches with several threads. Alternatives
+ * that the search would try one after another are handed to idle
+ * threads, which replay the choices that lead to them and search on;
+ * goals that fail are shared, and the first derivation found stops every
+ * thread. Which derivation is found may vary from run to run, and the
+ * node limit is checked less often.
+ *
+ * @pre The set is not shared.
+ * @param set Set that owns the premises and goal, and receives the
+ *        sentences the search tries.
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param goal Sentence to derive.
+ * @param maxDepth Largest depth of nested goals to try.
+ * @param maxNodes Largest number of goals to try, over all threads.
+ * @param threads Number of threads to use, or 0 for one per core.
+ * @return Returns a malloc'd SDDerivation whose last line is the goal at
+ *         depth 0, or NULL if none was found within the limits.
+ */
+SDDerivation SD_deriveParallel(
+	SentenceSet set,
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence goal,
+	const size_t maxDepth,
+	const size_t maxNodes,
+	size_t threads);
+
+/**
+ * Checks that every line of the derivation is justified by its rule and
+ * citations, in time linear in its length. Premises must come before
+ * every other line, a line may be one subproof deeper than the line
+ * before it only if it is an assumption, and cited lines and subproofs
+ * must be accessible: not inside a subproof that has been closed. A
+ * cited subproof must be closed, and its last line must not be in a
+ * subproof of its own. A ~I or ~E subproof must itself contain some Q
+ * and ~Q, not in a subproof of its own. &I, >E and =E may cite their
+ * lines in either order, and vE and =I their subproofs.
+ *
+ * @pre Every sentence of the derivation is a member of one SentenceSet.
+ * @param derivation Derivation to check.
+ * @return Returns 0 if every line is justified, or else the number of
+ *         the first line that is not, counting from 1.
+ */
+size_t SDDerivation_check(const SDDerivation derivation);
+
+/**
+ * Checks that the derivation is correct, that its premises are among
+ * the given ones, and that it ends with the goal outside every subproof.
+ *
+ * @pre Every sentence, given or in the derivation, is a member of one
+ *      SentenceSet.
+ * @param derivation Derivation to check.
+ * @param premises Premises it may use, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param goal Sentence it must derive.
+ * @return Returns 1 if the derivation derives the goal, 0 otherwise.
+ */
+uint8_t SDDerivation_proves(
+	const SDDerivation derivation,
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence goal);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Reads a rule from its name, as written by SDRule_toString().
+ *
+ * @param name Name to read.
+ * @param rule Receives the rule.
+ * @return Returns 1 if the name is a rule, 0 otherwise.
+ */
+uint8_t SDRule_parse(const char* name, SDRule* rule);
+
+/**
+ * Returns the name of the rule, as written in derivations.
+ *
+ * @param rule Rule to convert.
+ * @return Returns a string literal.
+ */
+char* SDRule_toString(SDRule rule);
+
+/**
+ * Writes the derivation, one numbered line each, with a bar for each
+ * subproof the line is in and the rule and citations on the right. The
+ * file is not flushed.
+ *
+ * @param file File to write to.
+ * @param derivation Derivation to write.
+ * @return Returns the number of characters written.
+ */
+size_t SDDerivation_write(FILE* file, const SDDerivation derivation);
+
+#endif
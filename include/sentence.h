@@ -6,6 +6,8 @@
 #ifndef SENTENCE_H
 #define SENTENCE_H
 
+#include "arena.h"
+#include "symbol.h"
 #include <stdlib.h>
 #include <stdint.h>
 
@@ -13,12 +15,15 @@
 /// Definitions
 /// ===========================================================================
 #define SENTENCESET_BUFFER 5
+#define SENTENCESET_SHARD_BITS 8
+#define SENTENCESET_SHARDS (1 << SENTENCESET_SHARD_BITS)
 
 /// ===========================================================================
 /// Structure declarations
 /// ===========================================================================
 
 struct Sentence_s;
+struct SentenceSetShared_s;
 
 /// ===========================================================================
 /// Enum definitions
@@ -53,7 +58,8 @@ enum SentenceOperator
 
 /**
  * Holds either a variable or a sentence pointer. Atomic sentences hold
- * variables, compound sentences hold sentence pointers.
+ * variables, compound sentences hold sentence pointers. Variables point
+ * into the symbol table and must not be modified or freed.
  */
 union SentenceBuffer
 {
@@ -68,26 +74,72 @@ union SentenceBuffer
 /**
  * Note: sentences that only make use of one buffer (atomic sentences)
  * will always only use the left buffer.
+ *
+ * Atomic sentences also store the symbol id of their variable, so that
+ * Symbol_name(id) == left.variable. Compound sentences leave id unset.
  */
 struct Sentence_s
 {
 	uint8_t negated;
 	enum SentenceType type;
 	enum SentenceOperator op;
+	uint32_t id;
 	union SentenceBuffer left;
 	union SentenceBuffer right;
 };
 
+/**
+ * One slot of a SentenceSet's hash table. Empty slots have a NULL
+ * sentence.
+ */
+struct SentenceSetEntry_s
+{
+	struct Sentence_s* sentence;
+	uint32_t hash;
+};
+
 /**
  * Since sentences are essentially graphs, freeing them correctly
  * can be difficult. Each time a Sentence is created, add it to
  * a set, then free the whole set at once using SentenceSet_free().
+ *
+ * Sets are hash-consed: the set holds exactly one sentence for each
+ * distinct structure, and the left and right sentences of a member are
+ * members too. Two members are equal if and only if they are the same
+ * pointer. Members are allocated from the set's arena; sentences created
+ * elsewhere and passed to SentenceSet_add() are copied in, and kept
+ * alive until the set is freed.
+ *
+ * Members are created for every subsentence, so the set also lists the
+ * sentences it was given as a whole: added holds the members passed to
+ * SentenceSet_add() or parsed into the set, each once, in the order they
+ * were first added, and addedCount is their number. Members added by
+ * threads of a shared set are listed when the threads leave.
+ *
+ * shared is NULL unless the set is between SentenceSet_share() and
+ * SentenceSet_unshare().
  */
 struct SentenceSet_s
 {
 	size_t size;
 	size_t buffer;
 	struct Sentence_s** sentences;
+	Arena arena;
+
+	size_t tableSize;
+	struct SentenceSetEntry_s* table;
+
+	uint8_t arenaOnly;
+	size_t ownedSize;
+	size_t ownedCount;
+	struct Sentence_s** owned;
+
+	size_t addedSize;
+	size_t addedCount;
+	struct Sentence_s** added;
+	struct SentenceMap_s* addedIndex;
+
+	struct SentenceSetShared_s* shared;
 };
 
 /// ===========================================================================
@@ -99,6 +151,27 @@ typedef enum SentenceOperator SentenceOperator;
 typedef union SentenceBuffer SentenceBuffer;
 typedef struct Sentence_s* Sentence;
 typedef struct SentenceSet_s* SentenceSet;
+typedef struct SentenceVisitor_s SentenceVisitor;
+
+/// ===========================================================================
+/// Structure definitions - Visitors
+/// ===========================================================================
+
+/**
+ * Callbacks for Sentence_visit(). Any callback may be NULL.
+ *
+ * pre is called before a sentence's children are visited; returning 0
+ * skips the children. in is called between the left and right sentences
+ * of a compound sentence. post is called last, even if the children
+ * were skipped.
+ */
+struct SentenceVisitor_s
+{
+	uint8_t (*pre)(const Sentence sentence, void* data);
+	void (*in)(const Sentence sentence, void* data);
+	void (*post)(const Sentence sentence, void* data);
+	void* data;
+};
 
 /// ===========================================================================
 /// Function declarations - Constructors
@@ -129,6 +202,38 @@ Sentence Sentence_createCompound(
 	const Sentence right,
 	const uint8_t negated);
 
+/**
+ * Same as Sentence_createAtomic(), but the sentence is allocated from
+ * the arena. Such sentences must not be passed to Sentence_free().
+ *
+ * @param arena Arena to allocate from, or NULL to use malloc.
+ * @param var Variable to set.
+ * @param negated 1 if sentence is negated, 0 otherwise.
+ * @return Returns a Sentence owned by the arena.
+ */
+Sentence Sentence_createAtomicIn(
+	Arena arena,
+	const char* var,
+	const uint8_t negated);
+
+/**
+ * Same as Sentence_createCompound(), but the sentence is allocated
+ * from the arena. Such sentences must not be passed to Sentence_free().
+ *
+ * @param arena Arena to allocate from, or NULL to use malloc.
+ * @param op Operator to use. Should not be NEGATION.
+ * @param left The sentence to store in the left buffer.
+ * @param right The sentence to store in the right buffer.
+ * @param negated 1 if the sentence is negated, 0 otherwise.
+ * @return Returns a Sentence owned by the arena.
+ */
+Sentence Sentence_createCompoundIn(
+	Arena arena,
+	const SentenceOperator op,
+	const Sentence left,
+	const Sentence right,
+	const uint8_t negated);
+
 /**
  * Creates a new SentenceSet with an arbitrary length buffer
  * defined by SENTENCESET_BUFFER.
@@ -137,20 +242,97 @@ Sentence Sentence_createCompound(
  */
 SentenceSet SentenceSet_create();
 
+/**
+ * Creates a new SentenceSet that never frees sentences one at a time.
+ * Sentences passed to SentenceSet_add() must have been allocated from
+ * set->arena (or outlive the set), since the set does not take ownership
+ * of them.
+ *
+ * @return Returns a malloc'd SentenceSet.
+ */
+SentenceSet SentenceSet_createArena();
+
+/**
+ * Returns the set's atomic sentence with the given variable, creating
+ * and adding it if it does not exist yet.
+ *
+ * @param set Set that owns the sentence.
+ * @param var Variable to set.
+ * @param negated 1 if sentence is negated, 0 otherwise.
+ * @return Returns a Sentence owned by the set.
+ */
+Sentence SentenceSet_createAtomic(
+	SentenceSet set,
+	const char* var,
+	const uint8_t negated);
+
+/**
+ * Same as SentenceSet_createAtomic(), but takes the variable's
+ * symbol id.
+ *
+ * @param set Set that owns the sentence.
+ * @param id Symbol id of the variable.
+ * @param negated 1 if sentence is negated, 0 otherwise.
+ * @return Returns a Sentence owned by the set.
+ */
+Sentence SentenceSet_createVariable(
+	SentenceSet set,
+	const uint32_t id,
+	const uint8_t negated);
+
+/**
+ * Returns the set's compound sentence with the given structure, creating
+ * and adding it if it does not exist yet.
+ *
+ * @pre left and right are members of the set.
+ * @param set Set that owns the sentence.
+ * @param op Operator to use. Should not be NEGATION.
+ * @param left The sentence to store in the left buffer.
+ * @param right The sentence to store in the right buffer.
+ * @param negated 1 if the sentence is negated, 0 otherwise.
+ * @return Returns a Sentence owned by the set.
+ */
+Sentence SentenceSet_createCompound(
+	SentenceSet set,
+	const SentenceOperator op,
+	const Sentence left,
+	const Sentence right,
+	const uint8_t negated);
+
+/**
+ * Returns the set's sentence with the same structure as the given one
+ * and the given negation flag, creating and adding it if it does not
+ * exist yet. Pass !sentence->negated to negate it, since negation is a
+ * flag and ~~P is P.
+ *
+ * @pre sentence is a member of the set.
+ * @param set Set that owns the sentence.
+ * @param sentence Sentence to negate or un-negate.
+ * @param negated 1 if the result is negated, 0 otherwise.
+ * @return Returns a Sentence owned by the set.
+ */
+Sentence SentenceSet_negate(
+	SentenceSet set,
+	const Sentence sentence,
+	const uint8_t negated);
+
 /// ===========================================================================
 /// Function declarations - Destructors
 /// ===========================================================================
 
 /**
  * Frees the given sentence but <i>not</i> it's left and right
- * buffers.
+ * buffers. Variable names belong to the symbol table and are
+ * never freed.
  *
  * @param sentence Sentence to free.
  */
 void Sentence_free(Sentence sentence);
 
 /**
- * Frees all sentences (and the set itself).
+ * Frees all sentences (and the set itself), including the sentences
+ * handed to SentenceSet_add() unless the set was created with
+ * SentenceSet_createArena().
  *
  * @param set Set to free.
  */
@@ -162,13 +344,28 @@ void SentenceSet_free(SentenceSet set);
 
 /**
  * Adds the Sentence to the set, if it doesn't already exist in
- * the set.
+ * the set. Its left and right sentences are added as well.
+ *
+ * The set keeps the given sentence alive until it is freed, but the
+ * member it stores may be a different pointer with the same structure;
+ * see SentenceSet_find(). The member is listed in the set's added
+ * sentences, even if it was already in the set.
  *
  * @param set Set to add to.
  * @param sentence Sentence being added.
  */
 void SentenceSet_add(SentenceSet set, const Sentence sentence);
 
+/**
+ * Finds the member with the same structure as the given sentence.
+ * Expected O(1) when the sentence's children are members.
+ *
+ * @param set Set to search.
+ * @param sentence Sentence to look for.
+ * @return Returns the member, or NULL if the set has no equal sentence.
+ */
+Sentence SentenceSet_find(const SentenceSet set, const Sentence sentence);
+
 /**
  * Checks if the given sentence exists in the set, either directly (having
  * the same address) or indirectly (having the same components).
@@ -179,13 +376,67 @@ void SentenceSet_add(SentenceSet set, const Sentence sentence);
  */
 uint8_t SentenceSet_contains(const SentenceSet set, const Sentence sentence);
 
+/// ===========================================================================
+/// Function declarations - Concurrency
+/// ===========================================================================
+
+/**
+ * Lets several threads add to the set at the same time. Until
+ * SentenceSet_unshare() is called, the members that existed before are
+ * read without locking, and new members go to lock-striped tables, so
+ * every thread sees the same member for equal sentences.
+ *
+ * Members created while the set is shared are not in set->sentences, and
+ * set->size does not count them, until the set is unshared.
+ *
+ * @param set Set to share.
+ */
+void SentenceSet_share(SentenceSet set);
+
+/**
+ * Registers the calling thread with a shared set. A thread must join
+ * before it adds to the set, and may be joined to one set at a time.
+ * New members are allocated from a private arena, so threads do not
+ * contend for memory.
+ *
+ * @param set Shared set to join.
+ */
+void SentenceSet_join(SentenceSet set);
+
+/**
+ * Hands the calling thread's arena and new members over to the set. The
+ * thread must not add to the set after leaving, but its members stay
+ * valid.
+ *
+ * @param set Set the thread joined.
+ */
+void SentenceSet_leave(SentenceSet set);
+
+/**
+ * Ends shared mode. Members created by the threads are appended to
+ * set->sentences, after their children, in the order they were created.
+ *
+ * @pre Every thread that joined the set has left it.
+ * @param set Set to unshare.
+ */
+void SentenceSet_unshare(SentenceSet set);
+
 /// ===========================================================================
 /// Function declarations - Utility
 /// ===========================================================================
 
 /**
- * Recursively checks if the two sentences have the same
- * structure and children.
+ * Returns the symbol of the operator, or "" for NO_OP.
+ *
+ * @param op Operator to convert.
+ * @return Returns a string literal.
+ */
+char* SentenceOperator_toString(SentenceOperator op);
+
+/**
+ * Checks if the two sentences have the same structure and children.
+ * Shared subsentences are compared by address only. Uses an explicit
+ * stack, so depth is limited only by available memory.
  *
  * @param a First Sentence.
  * @param b Second Sentence.
@@ -194,24 +445,99 @@ uint8_t SentenceSet_contains(const SentenceSet set, const Sentence sentence);
 uint8_t Sentence_equals(const Sentence a, const Sentence b);
 
 /**
- * Recursively prints the sentence such that
- * all inner sentences are also printed.
+ * Prints the sentence such that all inner sentences are also printed.
+ * Same as Sentence_write(stdout, sentence, FORMAT_FULL); stdout is
+ * not flushed.
  *
  * @param sentence Sentence to print.
  */
 void Sentence_print(const Sentence sentence);
 
+/**
+ * Walks the sentence depth-first, left to right, calling the visitor's
+ * callbacks on every node. Subsentences that are shared are visited
+ * once per occurrence. Uses an explicit stack, so depth is limited only
+ * by available memory.
+ *
+ * @param sentence Root of the walk.
+ * @param visitor Callbacks to call.
+ */
+void Sentence_visit(const Sentence sentence, const SentenceVisitor* visitor);
+
+/**
+ * Same as Sentence_visit(), but every distinct node is visited once:
+ * a subsentence reached a second time is skipped entirely.
+ *
+ * @param sentence Root of the walk.
+ * @param visitor Callbacks to call.
+ */
+void Sentence_visitUnique(
+	const Sentence sentence,
+	const SentenceVisitor* visitor);
+
+/**
+ * Generate a Sentence from the given string in a single left to right
+ * pass. Every subsentence is added to the set, and equal subsentences
+ * share one node; the sentence itself is listed in the set's added
+ * sentences, see SentenceSet_add(). The input is not modified.
+ *
+ * @param in Null-terminated string to read from.
+ * @param set Set that takes ownership of the created sentences.
+ * @return Returns the <i>root</i> sentence, or NULL if the input is
+ *         malformed (unbalanced parens, missing operands, etc).
+ */
+Sentence Sentence_parse(const char* in, SentenceSet set);
+
+/**
+ * Same as Sentence_parse(), but reads exactly len characters, so the
+ * input need not be null-terminated. The buffer is only read, never
+ * written or copied, which makes it safe to parse read-only memory
+ * such as a mmap'd file or a slice of a larger shared buffer.
+ *
+ * @param in Characters to read from.
+ * @param len Number of characters to read.
+ * @param set Set that takes ownership of the created sentences.
+ * @return Returns the <i>root</i> sentence, or NULL if the input is
+ *         malformed or contains a null character.
+ */
+Sentence Sentence_parseBuffer(
+	const char* in,
+	const size_t len,
+	SentenceSet set);
+
+/**
+ * Parses one line of a file of sentences, as the readers in
+ * sentencestream.h and sentenceparallel.h do. Lines holding nothing but
+ * spaces, tabs and carriage returns are blank and are skipped; otherwise
+ * a trailing carriage return is dropped and the rest is parsed with
+ * Sentence_parseBuffer().
+ *
+ * @param line Characters of the line, without its newline.
+ * @param len Number of characters in the line.
+ * @param set Set that takes ownership of the created sentences.
+ * @param sentence Receives the sentence, or NULL if the line is
+ *        malformed. Untouched for blank lines.
+ * @return Returns 0 if the line is blank, 1 otherwise.
+ */
+uint8_t Sentence_parseLine(
+	const char* line,
+	const size_t len,
+	SentenceSet set,
+	Sentence* sentence);
+
 /**
  * Generate a Sentence from the given character array.
+ * Equivalent to Sentence_parse(in, *set).
  *
  * @param in Character array to read from.
- * @param set Set buffer, should be NULL or uninitialized.
- * @return Returns the <i>root</i> sentence.
+ * @param set Pointer to an initialized set.
+ * @return Returns the <i>root</i> sentence, or NULL if malformed.
  */
 Sentence Sentence_parseString(char* in, SentenceSet* set);
 
 /**
- * Prints every sentence in the set.
+ * Prints every sentence in the set, one per line.
+ * Same as SentenceSet_write(stdout, set, FORMAT_FULL).
  *
  * @param set Set to print.
  */
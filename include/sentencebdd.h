@@ -0,0 +1,304 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Reduced ordered binary decision diagrams. A manager holds the nodes of
+ * every BDD built in it, and keeps one node for each variable and pair
+ * of children, so two BDDs of one manager represent equivalent sentences
+ * exactly when they are the same handle. Sentences built in one manager
+ * share their nodes and the cache of earlier operations.
+ *
+ * Handles returned by the manager hold a reference, which is dropped
+ * with SentenceBDD_release(). Nodes that no held handle reaches are
+ * reclaimed between operations. Variables can be reordered by sifting,
+ * on request or whenever the manager grows past a limit; handles stay
+ * valid and keep their meaning across reordering.
+ *
+ * A manager must be used by one thread at a time.
+ */
+
+#ifndef SENTENCEBDD_H
+#define SENTENCEBDD_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define SENTENCEBDD_FALSE 0
+#define SENTENCEBDD_TRUE 1
+
+// Entries in the operation cache, as a power of two
+#define SENTENCEBDD_CACHE_BITS 18
+
+// Nodes a manager may hold before it first collects or reorders; after
+// that, twice the number it kept the last time
+#define SENTENCEBDD_MIN_NODES (1 << 16)
+
+// Sifting stops moving a variable once the manager is this much larger
+// than the smallest size seen for it
+#define SENTENCEBDD_MAX_GROWTH 1.2
+
+/// ===========================================================================
+/// Structure declarations
+/// ===========================================================================
+
+struct SentenceBDDManager_s;
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceBDDManager_s* SentenceBDDManager;
+typedef uint32_t SentenceBDD;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a manager with no variables.
+ *
+ * @return Returns a malloc'd SentenceBDDManager.
+ */
+SentenceBDDManager SentenceBDDManager_create();
+
+/**
+ * Builds the BDD of a sentence. Variables the manager has not seen are
+ * placed below the others, in the order they are met.
+ *
+ * @param manager Manager to build in.
+ * @param sentence Sentence to build.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_fromSentence(
+	SentenceBDDManager manager,
+	const Sentence sentence);
+
+/**
+ * Builds the BDD of the conjunction of the sentences.
+ *
+ * @param manager Manager to build in.
+ * @param sentences Sentences, may be NULL if numSentences is 0.
+ * @param numSentences Number of sentences.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_fromSentences(
+	SentenceBDDManager manager,
+	const Sentence* sentences,
+	const size_t numSentences);
+
+/**
+ * Builds the BDD of the conjunction of the sentences added to the set;
+ * see SentenceSet_add().
+ *
+ * @param manager Manager to build in.
+ * @param set Set to build.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_fromSet(
+	SentenceBDDManager manager,
+	const SentenceSet set);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the manager and every BDD in it.
+ *
+ * @param manager Manager to free.
+ */
+void SentenceBDDManager_free(SentenceBDDManager manager);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Returns the level of a symbol's variable, 0 being the top.
+ *
+ * @param manager Manager to search.
+ * @param symbol Symbol id.
+ * @return Returns the level, or UINT32_MAX if the symbol has no variable.
+ */
+uint32_t SentenceBDDManager_level(
+	const SentenceBDDManager manager,
+	const uint32_t symbol);
+
+/**
+ * Returns the number of nodes held by the manager, counting the nodes
+ * that are no longer reachable until they are collected.
+ *
+ * @param manager Manager to measure.
+ * @return Returns the number of nodes.
+ */
+size_t SentenceBDDManager_size(const SentenceBDDManager manager);
+
+/**
+ * Turns automatic reordering on or off. It is off by default.
+ *
+ * @param manager Manager to change.
+ * @param enabled 1 to reorder by sifting when the manager grows, 0 not to.
+ */
+void SentenceBDDManager_setAutoReorder(
+	SentenceBDDManager manager,
+	const uint8_t enabled);
+
+/**
+ * Moves the symbols' variables to the top levels, in the given order,
+ * creating the ones that do not exist yet. Existing BDDs are rebuilt in
+ * place under the new order.
+ *
+ * @param manager Manager to reorder.
+ * @param symbols Distinct symbol ids, from the top level down.
+ * @param numSymbols Number of symbols.
+ */
+void SentenceBDDManager_setOrder(
+	SentenceBDDManager manager,
+	const uint32_t* symbols,
+	const size_t numSymbols);
+
+/**
+ * Adds a reference to a handle.
+ *
+ * @param manager Manager of the BDD.
+ * @param bdd Handle to hold.
+ */
+void SentenceBDD_ref(SentenceBDDManager manager, const SentenceBDD bdd);
+
+/**
+ * Drops a reference to a handle.
+ *
+ * @param manager Manager of the BDD.
+ * @param bdd Handle to release.
+ */
+void SentenceBDD_release(SentenceBDDManager manager, const SentenceBDD bdd);
+
+/// ===========================================================================
+/// Function declarations - Operations
+/// ===========================================================================
+
+/**
+ * Returns the BDD of a variable or its negation.
+ *
+ * @param manager Manager to build in.
+ * @param symbol Symbol id of the variable.
+ * @param negated 1 for the negation, 0 otherwise.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_variable(
+	SentenceBDDManager manager,
+	const uint32_t symbol,
+	const uint8_t negated);
+
+/**
+ * Returns the negation of a BDD.
+ *
+ * @param manager Manager of the BDD.
+ * @param f BDD to negate.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_not(SentenceBDDManager manager, const SentenceBDD f);
+
+/**
+ * Combines two BDDs with a binary operator.
+ *
+ * @param manager Manager of the BDDs.
+ * @param op Operator to apply. Should not be NO_OP.
+ * @param f Left operand.
+ * @param g Right operand.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_apply(
+	SentenceBDDManager manager,
+	const SentenceOperator op,
+	const SentenceBDD f,
+	const SentenceBDD g);
+
+/**
+ * Returns the BDD of "if f then g else h".
+ *
+ * @param manager Manager of the BDDs.
+ * @param f Condition.
+ * @param g Value where f is true.
+ * @param h Value where f is false.
+ * @return Returns a held handle.
+ */
+SentenceBDD SentenceBDD_ite(
+	SentenceBDDManager manager,
+	const SentenceBDD f,
+	const SentenceBDD g,
+	const SentenceBDD h);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Checks if the BDD has a model, and finds one by walking a single path.
+ *
+ * @param manager Manager of the BDD.
+ * @param f BDD to check.
+ * @param values Receives a model, indexed by symbol id, with the
+ *        manager's other variables false. May be NULL.
+ * @return Returns 1 if the BDD is satisfiable, 0 otherwise.
+ */
+uint8_t SentenceBDD_isSatisfiable(
+	const SentenceBDDManager manager,
+	const SentenceBDD f,
+	uint8_t* values);
+
+/**
+ * Checks if the BDD is true under every assignment.
+ *
+ * @param manager Manager of the BDD.
+ * @param f BDD to check.
+ * @return Returns 1 if the BDD is a tautology, 0 otherwise.
+ */
+uint8_t SentenceBDD_isTautology(
+	const SentenceBDDManager manager,
+	const SentenceBDD f);
+
+/**
+ * Counts the models of the BDD over all of the manager's variables, in
+ * time linear in the size of the BDD.
+ *
+ * @param manager Manager of the BDD.
+ * @param f BDD to count.
+ * @return Returns the number of models, or UINT64_MAX if there are at
+ *         least that many.
+ */
+uint64_t SentenceBDD_countModels(
+	const SentenceBDDManager manager,
+	const SentenceBDD f);
+
+/**
+ * Returns the number of nodes of the BDD, including the terminals.
+ *
+ * @param manager Manager of the BDD.
+ * @param f BDD to measure.
+ * @return Returns the number of nodes.
+ */
+size_t SentenceBDD_size(const SentenceBDDManager manager, const SentenceBDD f);
+
+/**
+ * Reclaims the nodes that no held handle reaches.
+ *
+ * @param manager Manager to collect.
+ */
+void SentenceBDDManager_collect(SentenceBDDManager manager);
+
+/**
+ * Reorders the variables by sifting: each variable in turn, largest
+ * level first, is moved through every level and left where the
+ * manager was smallest.
+ *
+ * @param manager Manager to reorder.
+ */
+void SentenceBDDManager_reorder(SentenceBDDManager manager);
+
+#endif
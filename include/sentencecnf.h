@@ -0,0 +1,150 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Clause form of sentences, by the Tseitin encoding. Every compound
+ * subsentence gets a fresh variable defined to be equivalent to it, so
+ * the clauses grow linearly with the sentence rather than exponentially
+ * as with distribution. The clauses are satisfiable exactly when the
+ * asserted sentences are, and every model of them is a model of the
+ * sentences.
+ *
+ * Literals are 2 * variable, plus 1 if negated.
+ */
+
+#ifndef SENTENCECNF_H
+#define SENTENCECNF_H
+
+#include "sentence.h"
+#include "sentencemap.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define CNF_NONE UINT32_MAX
+
+#define CNF_LITERAL(variable, negated) ((uint32_t)(variable) << 1 | (negated))
+#define CNF_VARIABLE(literal) ((literal) >> 1)
+#define CNF_IS_NEGATED(literal) ((literal) & 1)
+#define CNF_NEGATE(literal) ((literal) ^ 1)
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Clause n is literals[clauses[n]] up to literals[clauses[n+1]]; clauses
+ * always holds numClauses + 1 offsets.
+ *
+ * symbols holds the symbol id of each variable, or SYMBOL_NONE for the
+ * variables that define subsentences. variables maps symbol ids back to
+ * variables, plus 1, with 0 for symbols that have none yet. encoded maps
+ * encoded sentences to their literal, plus 1.
+ */
+struct SentenceCNF_s
+{
+	uint32_t numVariables;
+	uint32_t maxVariables;
+	uint32_t* symbols;
+
+	size_t numLiterals;
+	size_t maxLiterals;
+	uint32_t* literals;
+
+	size_t numClauses;
+	size_t maxClauses;
+	size_t* clauses;
+
+	size_t numSymbols;
+	uint32_t* variables;
+	SentenceMap encoded;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceCNF_s* SentenceCNF;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates an empty clause set.
+ *
+ * @return Returns a malloc'd SentenceCNF.
+ */
+SentenceCNF SentenceCNF_create();
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the clause set.
+ *
+ * @param cnf Clause set to free.
+ */
+void SentenceCNF_free(SentenceCNF cnf);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Creates a variable.
+ *
+ * @param cnf Clause set to add to.
+ * @param symbol Symbol id the variable stands for, or SYMBOL_NONE.
+ * @return Returns the new variable.
+ */
+uint32_t SentenceCNF_newVariable(SentenceCNF cnf, const uint32_t symbol);
+
+/**
+ * Returns the variable of a symbol, creating it if it does not exist yet.
+ *
+ * @param cnf Clause set to search.
+ * @param symbol Symbol id.
+ * @return Returns the variable.
+ */
+uint32_t SentenceCNF_variable(SentenceCNF cnf, const uint32_t symbol);
+
+/**
+ * Adds a clause.
+ *
+ * @param cnf Clause set to add to.
+ * @param literals Literals of the clause.
+ * @param size Number of literals; 0 adds the empty clause.
+ */
+void SentenceCNF_addClause(
+	SentenceCNF cnf,
+	const uint32_t* literals,
+	const size_t size);
+
+/**
+ * Returns a literal that is equivalent to the sentence, adding the
+ * clauses that define it. Subsentences that were encoded before are
+ * reused, so encoding many sentences that share nodes stays linear.
+ * Sentences are remembered by address, and must not be freed while the
+ * clause set is in use.
+ *
+ * @param cnf Clause set to add to.
+ * @param sentence Sentence to encode.
+ * @return Returns the literal.
+ */
+uint32_t SentenceCNF_encode(SentenceCNF cnf, const Sentence sentence);
+
+/**
+ * Encodes the sentence and adds it as a unit clause, so every model of
+ * the clauses makes it true.
+ *
+ * @param cnf Clause set to add to.
+ * @param sentence Sentence to assert.
+ */
+void SentenceCNF_assert(SentenceCNF cnf, const Sentence sentence);
+
+#endif
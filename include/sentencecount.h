@@ -0,0 +1,102 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Model counting and enumeration. The sentences are put in clause form,
+ * and the counter splits the clauses into components that share no
+ * variables. The count of each component is computed once and cached,
+ * and the counts of independent components are multiplied. Variables
+ * that no clause constrains double the count without being branched on.
+ *
+ * Models are counted over the variables that occur in the sentences.
+ * They are reported as arrays indexed by symbol id, with Symbol_count()
+ * entries.
+ */
+
+#ifndef SENTENCECOUNT_H
+#define SENTENCECOUNT_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+// Words of component keys the cache may hold; past that, the older half
+// of the cache is dropped
+#define SENTENCECOUNT_CACHE_WORDS (1 << 24)
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+/**
+ * Receives one model. values is only valid during the call.
+ *
+ * @return Returns 1 to continue, 0 to stop the enumeration.
+ */
+typedef uint8_t (*SentenceModelCallback)(const uint8_t* values, void* data);
+
+/// ===========================================================================
+/// Function declarations
+/// ===========================================================================
+
+/**
+ * Counts the assignments that make all of the sentences true.
+ *
+ * @param sentences Sentences, may be NULL if numSentences is 0.
+ * @param numSentences Number of sentences.
+ * @return Returns the number of models, or UINT64_MAX if there are
+ *         at least that many.
+ */
+uint64_t Sentence_countModels(
+	const Sentence* sentences,
+	const size_t numSentences);
+
+/**
+ * Calls the callback once for each assignment that makes all of the
+ * sentences true. Models are listed in order, as binary numbers whose
+ * digits are the variables by ascending symbol id, false before true.
+ * Subtrees of the search without models are cut off by the counter, so
+ * the work grows with the number of models rather than with the truth
+ * table.
+ *
+ * @param sentences Sentences, may be NULL if numSentences is 0.
+ * @param numSentences Number of sentences.
+ * @param callback Receives each model.
+ * @param data Passed to the callback.
+ * @return Returns the number of models passed to the callback.
+ */
+uint64_t Sentence_enumerateModels(
+	const Sentence* sentences,
+	const size_t numSentences,
+	SentenceModelCallback callback,
+	void* data);
+
+/**
+ * Same as Sentence_countModels(), over the sentences added to the set;
+ * see SentenceSet_add(). The set must not be shared.
+ *
+ * @param set Set whose models to count.
+ * @return Returns the number of models, or UINT64_MAX if there are
+ *         at least that many.
+ */
+uint64_t SentenceSet_countModels(const SentenceSet set);
+
+/**
+ * Same as Sentence_enumerateModels(), over the sentences added to the
+ * set; see SentenceSet_add(). The set must not be shared.
+ *
+ * @param set Set whose models to list.
+ * @param callback Receives each model.
+ * @param data Passed to the callback.
+ * @return Returns the number of models passed to the callback.
+ */
+uint64_t SentenceSet_enumerateModels(
+	const SentenceSet set,
+	SentenceModelCallback callback,
+	void* data);
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Truth-table evaluation of sentences. A sentence over n variables is
+ * checked against all 2^n assignments, SENTENCEEVAL_BLOCK of them at a
+ * time: each variable's column of the truth table is a fixed bit
+ * pattern, so every operator costs a few bitwise instructions per block
+ * rather than one branch per assignment.
+ *
+ * Assignments are arrays indexed by symbol id, with Symbol_count()
+ * entries; a nonzero entry means the variable is true.
+ */
+
+#ifndef SENTENCEEVAL_H
+#define SENTENCEEVAL_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+// 64-bit words per block. The loops over the words of a block are
+// vectorized when compiled for AVX2 (4 words) or AVX-512 (8 words).
+#define SENTENCEEVAL_WORD_BITS 2
+#define SENTENCEEVAL_WORDS (1 << SENTENCEEVAL_WORD_BITS)
+#define SENTENCEEVAL_BLOCK (64 * SENTENCEEVAL_WORDS)
+
+// Blocks a thread takes at a time; checks with fewer blocks than this
+// run on the calling thread only
+#define SENTENCEEVAL_BATCH 256
+
+// Checks over more variables than this are handed to the SAT solver of
+// sentencesat.h instead of enumerating the truth table
+#define SENTENCEEVAL_MAX_TABLE 24
+
+/// ===========================================================================
+/// Function declarations
+/// ===========================================================================
+
+/**
+ * Evaluates the sentence under one assignment.
+ *
+ * @param sentence Sentence to evaluate.
+ * @param values Truth value of each variable, indexed by symbol id.
+ * @return Returns 1 if the sentence is true, 0 otherwise.
+ */
+uint8_t Sentence_evaluate(const Sentence sentence, const uint8_t* values);
+
+/**
+ * Checks if the sentence is true under every assignment.
+ *
+ * @param sentence Sentence to check.
+ * @return Returns 1 if the sentence is a tautology, 0 otherwise.
+ */
+uint8_t Sentence_isTautology(const Sentence sentence);
+
+/**
+ * Checks if the sentence is false under every assignment.
+ *
+ * @param sentence Sentence to check.
+ * @return Returns 1 if the sentence is a contradiction, 0 otherwise.
+ */
+uint8_t Sentence_isContradiction(const Sentence sentence);
+
+/**
+ * Checks if the sentences have the same truth value under every
+ * assignment.
+ *
+ * @param a First Sentence.
+ * @param b Second Sentence.
+ * @return Returns 1 if the sentences are equivalent, 0 otherwise.
+ */
+uint8_t Sentence_areEquivalent(const Sentence a, const Sentence b);
+
+/**
+ * Checks if the conclusion is true under every assignment that makes all
+ * of the premises true.
+ *
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param conclusion Conclusion, or NULL for a contradiction, in which
+ *        case the premises entail it only if they are inconsistent.
+ * @return Returns 1 if the premises entail the conclusion, 0 otherwise.
+ */
+uint8_t Sentence_entails(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion);
+
+/**
+ * Searches the truth table for an assignment that makes all of the
+ * premises true and the conclusion false, stopping at the first one
+ * found. Large tables are split across threads; tables of more than
+ * SENTENCEEVAL_MAX_TABLE variables are searched by the SAT solver.
+ *
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param conclusion Conclusion, or NULL for a contradiction.
+ * @param threads Number of threads to use, or 0 for one per core.
+ * @param values Receives the counterexample, indexed by symbol id; only
+ *        the entries of the sentences' variables are written. May be
+ *        NULL.
+ * @return Returns 1 if a counterexample was found, 0 otherwise.
+ */
+uint8_t Sentence_findCounterexample(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion,
+	size_t threads,
+	uint8_t* values);
+
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Binary on-disk format for SentenceSets, designed to be mmap'd and used
+ * in place. A file holds a table of variable names and the set's members
+ * as a flat array of PackedSentence nodes, so shared subsentences are
+ * stored once. Loading maps the file and validates it; no memory is
+ * allocated per node.
+ *
+ * Layout, in host byte order:
+ *
+ *   struct SentenceFileHeader_s   header
+ *   uint32_t[numVariables + 1]    offsets of the names in the name table
+ *   PackedSentence[numNodes]      nodes, children before parents
+ *   char[namesSize]               null-terminated names
+ *
+ * Atomic nodes store an index into the file's own variable table rather
+ * than a symbol id, since symbol ids differ between processes.
+ */
+
+#ifndef SENTENCEFILE_H
+#define SENTENCEFILE_H
+
+#include "sentence.h"
+#include "sentencepack.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define SENTENCEFILE_MAGIC "LDMSET\0\0"
+#define SENTENCEFILE_VERSION 1
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+struct SentenceFileHeader_s
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t numVariables;
+	uint32_t numNodes;
+	uint32_t reserved;
+	uint64_t namesSize;
+};
+
+/**
+ * Read-only view of a mapped file. Node n of the view is member n of
+ * the saved set.
+ */
+struct SentenceImage_s
+{
+	void* map;
+	size_t mapSize;
+	uint32_t numVariables;
+	uint32_t numNodes;
+	const uint32_t* offsets;
+	const PackedSentence* nodes;
+	const char* names;
+	uint32_t* symbols;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceImage_s* SentenceImage;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Maps a file written by SentenceSet_save().
+ *
+ * @param path File to load.
+ * @return Returns a malloc'd SentenceImage, or NULL if the file cannot
+ *         be read or is not a valid sentence file.
+ */
+SentenceImage SentenceImage_load(const char* path);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Unmaps the file and frees the image.
+ *
+ * @param image Image to free.
+ */
+void SentenceImage_free(SentenceImage image);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Returns the name of one of the file's variables, read directly from
+ * the mapped file.
+ *
+ * @param image Image to read from.
+ * @param variable Variable index stored in an atomic node.
+ * @return Returns the null-terminated name, or NULL if the file has no
+ *         such variable.
+ */
+const char* SentenceImage_variable(
+	const SentenceImage image,
+	const uint32_t variable);
+
+/**
+ * Rebuilds one node as a sentence owned by the set. Only the nodes
+ * reachable from it are visited.
+ *
+ * @param image Image to read from.
+ * @param index Index of the node.
+ * @param set Set that receives the sentence.
+ * @return Returns the sentence, or NULL if the file has no such node.
+ */
+Sentence SentenceImage_toSentence(
+	SentenceImage image,
+	const uint32_t index,
+	SentenceSet set);
+
+/**
+ * Rebuilds every node of the image into the set, in order.
+ *
+ * @param image Image to read from.
+ * @param set Set that receives the sentences.
+ */
+void SentenceImage_toSet(SentenceImage image, SentenceSet set);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Writes the set to a file in the binary format.
+ *
+ * @param set Set to save.
+ * @param path File to write, replaced if it exists.
+ * @return Returns 1 on success, 0 if the file could not be written.
+ */
+uint8_t SentenceSet_save(const SentenceSet set, const char* path);
+
+#endif
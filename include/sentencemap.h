@@ -0,0 +1,91 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Hash map keyed by sentence address. Used to memoize per-node results
+ * when walking sentences that share subsentences, so each distinct node
+ * is visited once.
+ */
+
+#ifndef SENTENCEMAP_H
+#define SENTENCEMAP_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+struct SentenceMapEntry_s
+{
+	const struct Sentence_s* key;
+	void* value;
+};
+
+/**
+ * Open-addressing table. Empty slots have a NULL key.
+ */
+struct SentenceMap_s
+{
+	size_t size;
+	size_t tableSize;
+	struct SentenceMapEntry_s* table;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceMap_s* SentenceMap;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates an empty map.
+ *
+ * @return Returns a malloc'd SentenceMap.
+ */
+SentenceMap SentenceMap_create();
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the map. Keys and values are not freed.
+ *
+ * @param map Map to free.
+ */
+void SentenceMap_free(SentenceMap map);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Maps the sentence to the value, replacing any previous value.
+ *
+ * @param map Map to update.
+ * @param key Sentence to use as key, compared by address.
+ * @param value Value to store.
+ */
+void SentenceMap_put(SentenceMap map, const Sentence key, void* value);
+
+/**
+ * Looks up the value stored for the sentence.
+ *
+ * @param map Map to search.
+ * @param key Sentence to look up, compared by address.
+ * @param value Set to the stored value if found, may be NULL.
+ * @return Returns 1 if the sentence is in the map, 0 otherwise.
+ */
+uint8_t SentenceMap_get(
+	const SentenceMap map,
+	const Sentence key,
+	void** value);
+
+#endif
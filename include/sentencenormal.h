@@ -0,0 +1,131 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Normal forms of sentences, built as members of a SentenceSet.
+ *
+ * Negation normal form (NNF) rewrites conditionals and biconditionals
+ * with &, v and negation, and pushes negations down to the variables:
+ *
+ *     P > Q      becomes  ~P v Q
+ *     P = Q      becomes  (P & Q) v (~P & ~Q)
+ *     ~(P & Q)   becomes  ~P v ~Q, and so on.
+ *
+ * Negation is a flag, so double negations cancel as they are pushed. On
+ * the way up, P & P and P v P become P, and P & (P v Q), P v (P & Q) and
+ * their mirror images become P.
+ *
+ * Disjunctive (DNF) and conjunctive (CNF) normal form go on to
+ * distribute & over v, or v over &. The result is a chain of terms,
+ * each a chain of literals. Literals within a term are ordered by
+ * variable, terms by length and then by their literals; repeated
+ * literals and terms, and terms that contain another term, are dropped.
+ * So equivalent inputs often end up as the same member. Distribution can
+ * grow exponentially, so it gives up once a result would have more terms
+ * than the budget.
+ *
+ * Every step is memoized per member, so a sentence that shares
+ * subsentences is transformed in time proportional to its distinct
+ * members, not to the size of the tree it unfolds to. The memos last as
+ * long as the normalizer, so normalizing many premises shares the work.
+ */
+
+#ifndef SENTENCENORMAL_H
+#define SENTENCENORMAL_H
+
+#include "sentence.h"
+#include "sentencemap.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+// Default most terms in a DNF or CNF
+#define NORMAL_BUDGET 4096
+
+/// ===========================================================================
+/// Enum definitions
+/// ===========================================================================
+
+enum NormalForm
+{
+	NORMAL_NNF,
+	NORMAL_DNF,
+	NORMAL_CNF
+};
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * positive maps members to their NNF, negative maps them to the NNF of
+ * their negation, and distributed maps NNF members to their DNF or CNF.
+ */
+struct SentenceNormalizer_s
+{
+	SentenceSet set;
+	enum NormalForm form;
+	size_t budget;
+
+	SentenceMap positive;
+	SentenceMap negative;
+	SentenceMap distributed;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef enum NormalForm NormalForm;
+typedef struct SentenceNormalizer_s* SentenceNormalizer;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a normalizer.
+ *
+ * @param set Set that owns the sentences to normalize, and receives the
+ *        results.
+ * @param form Normal form to produce.
+ * @param budget Most terms in a DNF or CNF, ignored for NNF.
+ * @return Returns a malloc'd SentenceNormalizer.
+ */
+SentenceNormalizer SentenceNormalizer_create(
+	SentenceSet set,
+	NormalForm form,
+	size_t budget);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the normalizer, but not its set.
+ *
+ * @param normalizer Normalizer to free.
+ */
+void SentenceNormalizer_free(SentenceNormalizer normalizer);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Returns the normal form of the sentence, which is equivalent to it.
+ * Uses explicit stacks, so deep sentences are fine.
+ *
+ * @param normalizer Normalizer to use.
+ * @param sentence Member to normalize.
+ * @return Returns the member in normal form, or NULL if a DNF or CNF
+ *         would go over the budget.
+ */
+Sentence SentenceNormalizer_apply(
+	SentenceNormalizer normalizer,
+	const Sentence sentence);
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * An inverted index over a SentenceSet that answers "which members have
+ * this subformula as their left or right sentence?" and "which of the
+ * sentences added to the set contain it?" without walking the set.
+ *
+ * Since the set is hash-consed, each distinct subformula is one member,
+ * and each variable is at most two atomic members, with and without
+ * negation. The roots of a member are the sentences in set->added that
+ * contain it, such as the premises parsed into the set; see
+ * SentenceSet_add(). A root may also be part of another root.
+ *
+ * Lookups take time proportional to the size of the result. Updating
+ * takes time proportional to the members added since the last update,
+ * and to the members that the newly added sentences contain.
+ */
+
+#ifndef SENTENCEOCCURRENCE_H
+#define SENTENCEOCCURRENCE_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Structure declarations
+/// ===========================================================================
+
+struct SentenceOccurrences_s;
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceOccurrences_s* SentenceOccurrences;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Indexes every member of the set.
+ *
+ * @param set Set to index, which must not be shared.
+ * @return Returns a malloc'd SentenceOccurrences.
+ */
+SentenceOccurrences SentenceOccurrences_create(SentenceSet set);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the index, but not its set.
+ *
+ * @param occurrences Index to free.
+ */
+void SentenceOccurrences_free(SentenceOccurrences occurrences);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Indexes the members created in the set, and the sentences added to it,
+ * since the index was created or last updated. Arrays returned before
+ * the update are no longer valid.
+ *
+ * @param occurrences Index to update. Its set must not be shared.
+ */
+void SentenceOccurrences_update(SentenceOccurrences occurrences);
+
+/**
+ * Lists the members whose left or right sentence is the given one, each
+ * once, in the order they were added.
+ *
+ * @param occurrences Index to search.
+ * @param sentence Member to look up.
+ * @param size Receives the number of parents.
+ * @return Returns an array owned by the index, or NULL if the sentence
+ *         is not an indexed member or has no parents.
+ */
+const Sentence* SentenceOccurrences_parents(
+	const SentenceOccurrences occurrences,
+	const Sentence sentence,
+	size_t* size);
+
+/**
+ * Lists the added sentences that contain the given member, in the order
+ * they were added. An added sentence contains itself.
+ *
+ * @param occurrences Index to search.
+ * @param sentence Member to look up.
+ * @param size Receives the number of added sentences.
+ * @return Returns an array owned by the index, or NULL if the sentence
+ *         is not an indexed member.
+ */
+const Sentence* SentenceOccurrences_roots(
+	const SentenceOccurrences occurrences,
+	const Sentence sentence,
+	size_t* size);
+
+/**
+ * Finds the atomic member for a variable, whose parents and roots are
+ * where the variable occurs.
+ *
+ * @param occurrences Index to search.
+ * @param id Symbol id of the variable.
+ * @param negated 1 for the negated member, 0 otherwise.
+ * @return Returns the member, or NULL if none is indexed.
+ */
+Sentence SentenceOccurrences_variable(
+	const SentenceOccurrences occurrences,
+	uint32_t id,
+	uint8_t negated);
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Compact, index-based storage for sentences. Nodes live in one
+ * contiguous array and refer to their children by 32-bit index, and the
+ * negation flag, type and operator share a single byte. A node is 12
+ * bytes, against 32 for a struct Sentence_s.
+ *
+ * Nodes are always stored after their children, so a single forward
+ * pass over the array visits every node bottom-up.
+ */
+
+#ifndef SENTENCEPACK_H
+#define SENTENCEPACK_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define SENTENCEPACK_NONE UINT32_MAX
+
+/**
+ * Layout of PackedSentence.flags: bit 0 is the negation flag, bit 1 is
+ * set for compound sentences, and bits 2-4 hold the SentenceOperator.
+ */
+#define PACKED_NEGATED 0x01
+#define PACKED_COMPOUND 0x02
+#define PACKED_OP_SHIFT 2
+#define PACKED_OP_MASK 0x1c
+
+#define PACKED_FLAGS(type, op, negated) \
+	((uint8_t)(((type) == COMPOUND ? PACKED_COMPOUND : 0) \
+	| ((op) << PACKED_OP_SHIFT) | ((negated) ? PACKED_NEGATED : 0)))
+
+#define PACKED_IS_NEGATED(node) ((node).flags & PACKED_NEGATED)
+#define PACKED_IS_COMPOUND(node) ((node).flags & PACKED_COMPOUND)
+#define PACKED_OP(node) \
+	((SentenceOperator)(((node).flags & PACKED_OP_MASK) >> PACKED_OP_SHIFT))
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Atomic nodes store the symbol id of their variable in left, and leave
+ * right unused. Compound nodes store the indices of their children.
+ */
+struct PackedSentence_s
+{
+	uint32_t left;
+	uint32_t right;
+	uint8_t flags;
+};
+
+struct SentencePack_s
+{
+	uint32_t size;
+	uint32_t buffer;
+	struct PackedSentence_s* nodes;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct PackedSentence_s PackedSentence;
+typedef struct SentencePack_s* SentencePack;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates an empty pack.
+ *
+ * @return Returns a malloc'd SentencePack.
+ */
+SentencePack SentencePack_create();
+
+/**
+ * Packs every member of the set. Member n of the set becomes node n of
+ * the pack.
+ *
+ * @param set Set to pack.
+ * @return Returns a malloc'd SentencePack.
+ */
+SentencePack SentencePack_fromSet(const SentenceSet set);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the pack and its nodes.
+ *
+ * @param pack Pack to free.
+ */
+void SentencePack_free(SentencePack pack);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Appends an atomic node.
+ *
+ * @param pack Pack to append to.
+ * @param id Symbol id of the variable.
+ * @param negated 1 if the node is negated, 0 otherwise.
+ * @return Returns the index of the new node.
+ */
+uint32_t SentencePack_addAtomic(
+	SentencePack pack,
+	const uint32_t id,
+	const uint8_t negated);
+
+/**
+ * Appends a compound node.
+ *
+ * @pre left and right are indices of existing nodes.
+ * @param pack Pack to append to.
+ * @param op Operator to use.
+ * @param left Index of the left node.
+ * @param right Index of the right node.
+ * @param negated 1 if the node is negated, 0 otherwise.
+ * @return Returns the index of the new node.
+ */
+uint32_t SentencePack_addCompound(
+	SentencePack pack,
+	const SentenceOperator op,
+	const uint32_t left,
+	const uint32_t right,
+	const uint8_t negated);
+
+/**
+ * Appends the sentence and all of its subsentences. Subsentences shared
+ * within the sentence are stored once.
+ *
+ * @param pack Pack to append to.
+ * @param sentence Sentence to pack.
+ * @return Returns the index of the sentence's root node.
+ */
+uint32_t SentencePack_add(SentencePack pack, const Sentence sentence);
+
+/**
+ * Rebuilds the node at the given index as a sentence owned by the set.
+ *
+ * @param pack Pack to read from.
+ * @param index Index of the root node.
+ * @param set Set that receives the sentence and its subsentences.
+ * @return Returns the sentence.
+ */
+Sentence SentencePack_toSentence(
+	const SentencePack pack,
+	const uint32_t index,
+	SentenceSet set);
+
+/**
+ * Rebuilds a node from any array of packed nodes, such as one mapped
+ * from a file, as a sentence owned by the set.
+ *
+ * @param nodes Nodes to read from, children before parents.
+ * @param index Index of the root node.
+ * @param symbols Maps the ids stored in atomic nodes to symbol ids, or
+ *        NULL if they already are symbol ids.
+ * @param set Set that receives the sentence and its subsentences.
+ * @return Returns the sentence.
+ */
+Sentence SentencePack_build(
+	const PackedSentence* nodes,
+	const uint32_t index,
+	const uint32_t* symbols,
+	SentenceSet set);
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Multi-threaded parsing of corpora with one sentence per line. The
+ * corpus is cut into chunks at line boundaries, and a pool of threads
+ * parses the chunks into one shared SentenceSet, so equal subsentences
+ * found by different threads still share one member.
+ */
+
+#ifndef SENTENCEPARALLEL_H
+#define SENTENCEPARALLEL_H
+
+#include "sentence.h"
+#include "sentencestream.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+// Chunks per thread, so threads that finish early can take more work
+#define SENTENCEPARALLEL_CHUNKS 8
+
+// Smallest chunk worth handing to a thread, in bytes
+#define SENTENCEPARALLEL_MIN_CHUNK (1 << 14)
+
+/// ===========================================================================
+/// Function declarations
+/// ===========================================================================
+
+/**
+ * Parses every non-blank line of the corpus into the set. Lines end with
+ * '\n', optionally preceded by '\r'; the corpus does not have to be null
+ * terminated. Afterwards set->sentences lists children before parents,
+ * but the order of unrelated members depends on thread timing.
+ *
+ * The callback is called from the worker threads, in no particular
+ * order, and must be thread-safe.
+ *
+ * @pre The set is not shared.
+ * @param set Set that receives the sentences.
+ * @param corpus Text to parse.
+ * @param len Length of the corpus.
+ * @param threads Number of threads to use, or 0 for one per core.
+ * @param callback Function to call per line, may be NULL.
+ * @param data Passed to the callback.
+ * @return Returns the number of malformed lines.
+ */
+size_t SentenceSet_parseParallel(
+	SentenceSet set,
+	const char* corpus,
+	const size_t len,
+	size_t threads,
+	SentenceCallback callback,
+	void* data);
+
+/**
+ * Same as SentenceSet_parseParallel(), but maps the corpus from a file.
+ *
+ * @param set Set that receives the sentences.
+ * @param path File to parse.
+ * @param threads Number of threads to use, or 0 for one per core.
+ * @param callback Function to call per line, may be NULL.
+ * @param data Passed to the callback.
+ * @return Returns the number of malformed lines, or SIZE_MAX if the file
+ *         cannot be read.
+ */
+size_t SentenceSet_parseFileParallel(
+	SentenceSet set,
+	const char* path,
+	size_t threads,
+	SentenceCallback callback,
+	void* data);
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Schematic patterns, such as "P > Q" or "~(P & Q)", and an index that
+ * finds every member of a SentenceSet that matches a pattern.
+ *
+ * A pattern is a sentence whose variables starting with an uppercase
+ * letter are metavariables. A metavariable matches any sentence, and
+ * every occurrence of it must match the same one. A negated metavariable
+ * ~P matches any sentence S, binding P to ~S; since negation is a flag
+ * and ~~S is S, P & ~P matches both a & ~a and (~a) & a. The rest of the
+ * pattern must match exactly, negation flags included.
+ *
+ * The index is a discrimination tree: each member is filed under the
+ * symbols of its top SENTENCEINDEX_DEPTH levels, read in preorder, so
+ * members with the same top levels share a path. A pattern is looked up
+ * in a single walk of the tree, where a metavariable passes over one
+ * whole subsentence, and the members found are then matched in full to
+ * bind the metavariables.
+ */
+
+#ifndef SENTENCEPATTERN_H
+#define SENTENCEPATTERN_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+// Levels of a sentence the index tells apart; deeper levels are checked
+// when matching
+#define SENTENCEINDEX_DEPTH 4
+
+/// ===========================================================================
+/// Structure declarations
+/// ===========================================================================
+
+struct SentenceIndex_s;
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * variables lists the symbol ids of the metavariables, in the order they
+ * first occur, left to right. Bindings are given in the same order.
+ * items is the pattern's path through the index.
+ */
+struct SentencePattern_s
+{
+	Sentence sentence;
+	uint32_t* variables;
+	size_t numVariables;
+	uint64_t* items;
+	size_t numItems;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentencePattern_s* SentencePattern;
+typedef struct SentenceIndex_s* SentenceIndex;
+
+/**
+ * Receives one match. bindings is only valid during the call.
+ *
+ * @return Returns 1 to continue, 0 to stop the search.
+ */
+typedef uint8_t (*SentenceMatchCallback)(
+	const Sentence sentence,
+	const Sentence* bindings,
+	void* data);
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Compiles a pattern. The pattern does not have to be in the set of the
+ * sentences it is matched against.
+ *
+ * @param sentence Pattern to compile, which must outlive the result.
+ * @return Returns a malloc'd SentencePattern.
+ */
+SentencePattern SentencePattern_create(const Sentence sentence);
+
+/**
+ * Indexes every member of the set.
+ *
+ * @param set Set to index, which must not be shared.
+ * @return Returns a malloc'd SentenceIndex.
+ */
+SentenceIndex SentenceIndex_create(SentenceSet set);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the pattern, but not its sentence.
+ *
+ * @param pattern Pattern to free.
+ */
+void SentencePattern_free(SentencePattern pattern);
+
+/**
+ * Frees the index, but not its set.
+ *
+ * @param index Index to free.
+ */
+void SentenceIndex_free(SentenceIndex index);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Indexes the members added to the set since the index was created or
+ * last updated.
+ *
+ * @param index Index to update. Its set must not be shared.
+ */
+void SentenceIndex_update(SentenceIndex index);
+
+/**
+ * Returns the number of members indexed.
+ *
+ * @param index Index to measure.
+ * @return Returns the number of members.
+ */
+size_t SentenceIndex_size(const SentenceIndex index);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Matches one sentence against the pattern.
+ *
+ * @param set Set that owns the sentence. Receives the sentences that
+ *        negated metavariables are bound to, only if bindings is given;
+ *        matching alone never changes the set.
+ * @param pattern Pattern to match.
+ * @param sentence Sentence to match.
+ * @param bindings Receives a sentence per metavariable, may be NULL.
+ * @return Returns 1 if the sentence matches, 0 otherwise.
+ */
+uint8_t SentencePattern_match(
+	SentenceSet set,
+	const SentencePattern pattern,
+	const Sentence sentence,
+	Sentence* bindings);
+
+/**
+ * Finds every indexed member that matches the pattern, in no particular
+ * order. Members added to the set but not yet indexed are not found.
+ *
+ * @param index Index to search. If there is a callback, its set receives
+ *        the sentences that negated metavariables are bound to; they are
+ *        indexed on the next update.
+ * @param pattern Pattern to match.
+ * @param callback Function to call per match, may be NULL.
+ * @param data Passed to the callback.
+ * @return Returns the number of matches passed to the callback.
+ */
+size_t SentenceIndex_match(
+	SentenceIndex index,
+	const SentencePattern pattern,
+	SentenceMatchCallback callback,
+	void* data);
+
+#endif
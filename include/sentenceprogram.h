@@ -0,0 +1,132 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Sentences compiled to flat postfix programs, for evaluating the same
+ * sentence against many assignments. A program runs on a small value
+ * stack; subsentences that occur more than once are computed once,
+ * stored in a slot, and fetched from it afterwards.
+ *
+ * Assignments are arrays indexed by symbol id, as in sentenceeval.h.
+ */
+
+#ifndef SENTENCEPROGRAM_H
+#define SENTENCEPROGRAM_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Enum definitions
+/// ===========================================================================
+
+/**
+ * Binary operators pop the right operand, then the left, and push the
+ * result. STORE leaves its value on the stack.
+ */
+enum SentenceOpcode
+{
+	OPCODE_LOAD,	// Push variable operand
+	OPCODE_FETCH,	// Push slot operand
+	OPCODE_STORE,	// Copy the top of the stack to slot operand
+	OPCODE_NOT,
+	OPCODE_AND,
+	OPCODE_OR,
+	OPCODE_IMPLIES,
+	OPCODE_IFF
+};
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+struct SentenceInstruction_s
+{
+	uint32_t opcode;
+	uint32_t operand;
+};
+
+/**
+ * The operand of a LOAD is an index into variables, which holds the
+ * symbol ids of the sentence's variables, sorted.
+ */
+struct SentenceProgram_s
+{
+	struct SentenceInstruction_s* code;
+	size_t size;
+
+	uint32_t* variables;
+	size_t numVariables;
+
+	size_t numSlots;
+	size_t maxStack;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef enum SentenceOpcode SentenceOpcode;
+typedef struct SentenceInstruction_s SentenceInstruction;
+typedef struct SentenceProgram_s* SentenceProgram;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Compiles the sentence. The program does not refer to the sentence, so
+ * the sentence may be freed afterwards.
+ *
+ * @param sentence Sentence to compile.
+ * @return Returns a malloc'd SentenceProgram.
+ */
+SentenceProgram SentenceProgram_compile(const Sentence sentence);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the program.
+ *
+ * @param program Program to free.
+ */
+void SentenceProgram_free(SentenceProgram program);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Runs the program under one assignment. Programs are read only, so
+ * several threads may run the same program at once.
+ *
+ * @param program Program to run.
+ * @param values Truth value of each variable, indexed by symbol id.
+ * @return Returns 1 if the sentence is true, 0 otherwise.
+ */
+uint8_t SentenceProgram_evaluate(
+	const SentenceProgram program,
+	const uint8_t* values);
+
+/**
+ * Runs the program under many assignments. Assignments are taken 64 at
+ * a time, one bit each, so every instruction is executed once per 64
+ * assignments.
+ *
+ * @param program Program to run.
+ * @param assignments count assignments, each indexed by symbol id.
+ * @param count Number of assignments.
+ * @param stride Bytes from one assignment to the next.
+ * @param results Receives 1 or 0 per assignment.
+ */
+void SentenceProgram_evaluateBatch(
+	const SentenceProgram program,
+	const uint8_t* assignments,
+	const size_t count,
+	const size_t stride,
+	uint8_t* results);
+
+#endif
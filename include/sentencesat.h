@@ -0,0 +1,154 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Conflict-driven clause learning SAT solver over SentenceCNF clause
+ * sets, and satisfiability, validity and entailment checks built on it.
+ *
+ * The solver watches two literals per clause, so only clauses whose
+ * watched literal became false are visited during propagation. Conflicts
+ * are analyzed to the first unique implication point and the learned
+ * clause is minimized. Decisions follow VSIDS activity with phase
+ * saving, restarts follow the Luby sequence, and half of the learned
+ * clauses are dropped whenever they outgrow a limit.
+ */
+
+#ifndef SENTENCESAT_H
+#define SENTENCESAT_H
+
+#include "sentence.h"
+#include "sentencecnf.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+// Conflicts in the first Luby restart interval
+#define SENTENCESAT_RESTART 100
+
+// Decay of variable and clause activity per conflict
+#define SENTENCESAT_VAR_DECAY 0.95
+#define SENTENCESAT_CLAUSE_DECAY 0.999
+
+/// ===========================================================================
+/// Structure declarations
+/// ===========================================================================
+
+struct SentenceSolver_s;
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceSolver_s* SentenceSolver;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a solver for a clause set. Clauses and variables added to the
+ * clause set later are picked up by the next call to
+ * SentenceSolver_solve().
+ *
+ * @param cnf Clause set to solve. Must outlive the solver.
+ * @return Returns a malloc'd SentenceSolver.
+ */
+SentenceSolver SentenceSolver_create(const SentenceCNF cnf);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the solver, but not its clause set.
+ *
+ * @param solver Solver to free.
+ */
+void SentenceSolver_free(SentenceSolver solver);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Searches for a model of the clauses in which every assumption is
+ * true. Assumptions only hold for this call; clauses learned under them
+ * remain valid afterwards.
+ *
+ * @param solver Solver to run.
+ * @param assumptions Literals to assume, may be NULL if numAssumptions
+ *        is 0.
+ * @param numAssumptions Number of assumptions.
+ * @return Returns 1 if a model was found, 0 if there is none.
+ */
+uint8_t SentenceSolver_solve(
+	SentenceSolver solver,
+	const uint32_t* assumptions,
+	const size_t numAssumptions);
+
+/**
+ * Returns the value of a literal in the model found by the last
+ * successful call to SentenceSolver_solve().
+ *
+ * @param solver Solver that found the model.
+ * @param literal Literal to look up.
+ * @return Returns 1 if the literal is true, 0 otherwise.
+ */
+uint8_t SentenceSolver_value(const SentenceSolver solver, const uint32_t literal);
+
+/**
+ * Writes the model found by the last successful call to
+ * SentenceSolver_solve() as an assignment.
+ *
+ * @param solver Solver that found the model.
+ * @param values Receives the value of each symbol that has a variable,
+ *        indexed by symbol id.
+ */
+void SentenceSolver_model(const SentenceSolver solver, uint8_t* values);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Checks if some assignment makes the sentence true.
+ *
+ * @param sentence Sentence to check.
+ * @param values Receives a model, indexed by symbol id; only the entries
+ *        of the sentence's variables are written. May be NULL.
+ * @return Returns 1 if the sentence is satisfiable, 0 otherwise.
+ */
+uint8_t SentenceSAT_isSatisfiable(const Sentence sentence, uint8_t* values);
+
+/**
+ * Checks if every assignment makes the sentence true.
+ *
+ * @param sentence Sentence to check.
+ * @param values Receives a refuting assignment, as for
+ *        SentenceSAT_isSatisfiable(). May be NULL.
+ * @return Returns 1 if the sentence is valid, 0 otherwise.
+ */
+uint8_t SentenceSAT_isValid(const Sentence sentence, uint8_t* values);
+
+/**
+ * Checks if the conclusion is true under every assignment that makes all
+ * of the premises true.
+ *
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param conclusion Conclusion, or NULL for a contradiction.
+ * @param values Receives an assignment that makes the premises true and
+ *        the conclusion false, if there is one, as for
+ *        SentenceSAT_isSatisfiable(). May be NULL.
+ * @return Returns 1 if the premises entail the conclusion, 0 otherwise.
+ */
+uint8_t SentenceSAT_entails(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion,
+	uint8_t* values);
+
+#endif
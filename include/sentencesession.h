@@ -0,0 +1,108 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Entailment sessions, for asking many questions of one set of premises.
+ * The premises are encoded into clauses once. Each conclusion is encoded
+ * on its own and checked by assuming it false, so the solver keeps
+ * everything it learned from earlier questions.
+ */
+
+#ifndef SENTENCESESSION_H
+#define SENTENCESESSION_H
+
+#include "sentence.h"
+#include "sentencecnf.h"
+#include "sentencemap.h"
+#include "sentencesat.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * entailed holds the conclusions known to follow from the premises.
+ * Adding premises never invalidates them.
+ */
+struct SentenceSession_s
+{
+	SentenceCNF cnf;
+	SentenceSolver solver;
+	SentenceMap entailed;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceSession_s* SentenceSession;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a session and encodes the premises.
+ *
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @return Returns a malloc'd SentenceSession.
+ */
+SentenceSession SentenceSession_create(
+	const Sentence* premises,
+	const size_t numPremises);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the session, but not the sentences it was given.
+ *
+ * @param session Session to free.
+ */
+void SentenceSession_free(SentenceSession session);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Adds a premise. Sentences given to the session are remembered by
+ * address, and must not be freed while it is in use.
+ *
+ * @param session Session to add to.
+ * @param premise Premise to add.
+ */
+void SentenceSession_addPremise(SentenceSession session, const Sentence premise);
+
+/**
+ * Checks if the premises can all be true at once.
+ *
+ * @param session Session to check.
+ * @param values Receives a model of the premises, indexed by symbol id.
+ *        May be NULL.
+ * @return Returns 1 if the premises are consistent, 0 otherwise.
+ */
+uint8_t SentenceSession_isConsistent(SentenceSession session, uint8_t* values);
+
+/**
+ * Checks if the premises entail the conclusion. Subsentences shared with
+ * the premises or earlier conclusions are not encoded again, and
+ * conclusions that were entailed before are answered without solving.
+ *
+ * @param session Session to ask.
+ * @param conclusion Conclusion to check.
+ * @param values Receives an assignment that makes the premises true and
+ *        the conclusion false, if there is one, indexed by symbol id.
+ *        May be NULL.
+ * @return Returns 1 if the premises entail the conclusion, 0 otherwise.
+ */
+uint8_t SentenceSession_entails(
+	SentenceSession session,
+	const Sentence conclusion,
+	uint8_t* values);
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Streaming parser for files with one sentence per line. Input is read
+ * in large chunks and every line is parsed straight out of the chunk,
+ * so memory use is bounded by the chunk size and the longest line, not
+ * by the size of the file.
+ */
+
+#ifndef SENTENCESTREAM_H
+#define SENTENCESTREAM_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define SENTENCESTREAM_CHUNK (1 << 20)
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Reads lines from a file descriptor. buffer[start, end) holds data that
+ * has been read but not consumed; scanned marks how much of it is known
+ * to contain no newline.
+ */
+struct SentenceReader_s
+{
+	int fd;
+	uint8_t ownsFd;
+	uint8_t eof;
+	uint8_t error;
+	char* buffer;
+	size_t capacity;
+	size_t start;
+	size_t end;
+	size_t scanned;
+	size_t line;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceReader_s* SentenceReader;
+
+/**
+ * Called once per non-blank line. sentence is NULL if the line is
+ * malformed; line is the 1-based line number.
+ */
+typedef void (*SentenceCallback)(
+	const Sentence sentence,
+	const size_t line,
+	void* data);
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a reader over an open file descriptor. The descriptor is not
+ * closed when the reader is freed.
+ *
+ * @param fd Descriptor to read from.
+ * @return Returns a malloc'd SentenceReader.
+ */
+SentenceReader SentenceReader_create(const int fd);
+
+/**
+ * Opens a file for reading.
+ *
+ * @param path File to read.
+ * @return Returns a malloc'd SentenceReader, or NULL if the file cannot
+ *         be opened.
+ */
+SentenceReader SentenceReader_open(const char* path);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the reader, closing the file if it was opened by
+ * SentenceReader_open().
+ *
+ * @param reader Reader to free.
+ */
+void SentenceReader_free(SentenceReader reader);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Parses the next non-blank line into the set. reader->line holds its
+ * line number afterwards.
+ *
+ * @param reader Reader to read from.
+ * @param set Set that receives the sentence.
+ * @param sentence Set to the parsed sentence, or NULL if the line is
+ *        malformed.
+ * @return Returns 1 if a line was read, 0 at the end of the input or on
+ *         a read error (reader->error is set).
+ */
+uint8_t SentenceReader_next(
+	SentenceReader reader,
+	SentenceSet set,
+	Sentence* sentence);
+
+/**
+ * Parses every remaining line into the set, calling the callback for
+ * each one. Malformed lines are reported and skipped.
+ *
+ * @param reader Reader to read from.
+ * @param set Set that receives the sentences.
+ * @param callback Function to call per line, may be NULL.
+ * @param data Passed to the callback.
+ * @return Returns the number of malformed lines.
+ */
+size_t SentenceReader_parseAll(
+	SentenceReader reader,
+	SentenceSet set,
+	SentenceCallback callback,
+	void* data);
+
+#endif
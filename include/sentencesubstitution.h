@@ -0,0 +1,128 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Substitution of sentences for variables, or for any subsentence, that
+ * builds the result in a SentenceSet instead of copying. Since the set is
+ * hash-consed, every subsentence the substitution leaves unchanged is the
+ * same member in the result as in the original.
+ *
+ * A substitution replaces all of its sentences at once: the sentences it
+ * puts in are not substituted into again. Replacing a sentence S also
+ * replaces its negation ~S with the negation of the replacement, so
+ * substituting ~b for a turns ~a into b.
+ *
+ * Results are memoized per member for as long as the substitution is not
+ * changed, so applying it to sentences that share subsentences, within
+ * one call or across calls, visits each distinct member once.
+ */
+
+#ifndef SENTENCESUBSTITUTION_H
+#define SENTENCESUBSTITUTION_H
+
+#include "sentence.h"
+#include "sentencemap.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * replacements maps members to what replaces them, as put. A negated
+ * member with no entry of its own takes the negated replacement of its
+ * unnegated base, which is looked up when the substitution is applied.
+ * memo maps every member the substitution has been applied to onto its
+ * result.
+ */
+struct SentenceSubstitution_s
+{
+	SentenceSet set;
+	SentenceMap replacements;
+	SentenceMap memo;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef struct SentenceSubstitution_s* SentenceSubstitution;
+
+/// ===========================================================================
+/// Function declarations - Constructors
+/// ===========================================================================
+
+/**
+ * Creates a substitution that replaces nothing.
+ *
+ * @param set Set that owns the sentences substituted into, and receives
+ *        the results.
+ * @return Returns a malloc'd SentenceSubstitution.
+ */
+SentenceSubstitution SentenceSubstitution_create(SentenceSet set);
+
+/// ===========================================================================
+/// Function declarations - Destructors
+/// ===========================================================================
+
+/**
+ * Frees the substitution, but not its set.
+ *
+ * @param substitution Substitution to free.
+ */
+void SentenceSubstitution_free(SentenceSubstitution substitution);
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Replaces a member by another. Replaces any earlier replacement for the
+ * same member, and clears the memo.
+ *
+ * If the member is not negated, its negation is also replaced by the
+ * negated replacement, unless a replacement is put for the negation
+ * itself, before or after. Nothing is added to the set until the
+ * substitution is applied.
+ *
+ * @param substitution Substitution to change.
+ * @param from Member to replace.
+ * @param to Member to replace it with.
+ */
+void SentenceSubstitution_put(
+	SentenceSubstitution substitution,
+	const Sentence from,
+	const Sentence to);
+
+/**
+ * Same as SentenceSubstitution_put(), replacing the variable's atomic
+ * sentence.
+ *
+ * @param substitution Substitution to change.
+ * @param id Symbol id of the variable.
+ * @param to Member to replace it with.
+ */
+void SentenceSubstitution_putVariable(
+	SentenceSubstitution substitution,
+	uint32_t id,
+	const Sentence to);
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Applies the substitution. Uses an explicit stack, so deep sentences
+ * are fine.
+ *
+ * @param substitution Substitution to apply.
+ * @param sentence Member to substitute into.
+ * @return Returns the member with every replacement made, which is the
+ *         sentence itself if none applies.
+ */
+Sentence SentenceSubstitution_apply(
+	SentenceSubstitution substitution,
+	const Sentence sentence);
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Semantic tableaux (truth trees). The tree is grown from sentences that
+ * are required to be true or false, by decomposing each operator, and a
+ * branch closes when it requires something to be both. The sentences
+ * are consistent exactly when some branch stays open, and the literals
+ * on that branch are a model.
+ *
+ * Rules that do not branch are applied before rules that do, and a
+ * branching rule is skipped when the branch already satisfies it. Only
+ * one branch is held at a time: branches share everything above the
+ * point where they split, and what a branch added is undone when the
+ * next is tried.
+ */
+
+#ifndef SENTENCETABLEAU_H
+#define SENTENCETABLEAU_H
+
+#include "sentence.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Function declarations
+/// ===========================================================================
+
+/**
+ * Checks if some assignment makes all of the sentences true.
+ *
+ * @param sentences Sentences, may be NULL if numSentences is 0.
+ * @param numSentences Number of sentences.
+ * @param values Receives the literals of an open branch, indexed by
+ *        symbol id, with the sentences' other variables false. May be
+ *        NULL.
+ * @return Returns 1 if the tree has an open branch, 0 if it closes.
+ */
+uint8_t SentenceTableau_isSatisfiable(
+	const Sentence* sentences,
+	const size_t numSentences,
+	uint8_t* values);
+
+/**
+ * Checks if every assignment makes the sentence true, by closing the
+ * tree of its negation.
+ *
+ * @param sentence Sentence to check.
+ * @param values Receives a refuting assignment, as for
+ *        SentenceTableau_isSatisfiable(). May be NULL.
+ * @return Returns 1 if the sentence is valid, 0 otherwise.
+ */
+uint8_t SentenceTableau_isValid(const Sentence sentence, uint8_t* values);
+
+/**
+ * Checks if the conclusion is true under every assignment that makes all
+ * of the premises true, by closing the tree of the premises and the
+ * negated conclusion.
+ *
+ * @param premises Premises, may be NULL if numPremises is 0.
+ * @param numPremises Number of premises.
+ * @param conclusion Conclusion, or NULL for a contradiction.
+ * @param values Receives an assignment that makes the premises true and
+ *        the conclusion false, if there is one, as for
+ *        SentenceTableau_isSatisfiable(). May be NULL.
+ * @return Returns 1 if the premises entail the conclusion, 0 otherwise.
+ */
+uint8_t SentenceTableau_entails(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion,
+	uint8_t* values);
+
+#endif
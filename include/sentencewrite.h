@@ -0,0 +1,136 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Serialization of sentences to strings and files. Output is produced
+ * in one pass and written in large chunks; nothing is flushed.
+ */
+
+#ifndef SENTENCEWRITE_H
+#define SENTENCEWRITE_H
+
+#include "sentence.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define SENTENCEWRITE_CHUNK 4096
+
+/// ===========================================================================
+/// Enum definitions
+/// ===========================================================================
+
+/**
+ * FORMAT_FULL wraps every compound sentence in parens, as Sentence_print()
+ * does: "((a & b) > ~(c v d))". Note that "(~a & b)" reads back as
+ * "~(a & b)", so only FORMAT_MINIMAL is guaranteed to round trip
+ * through the parser.
+ *
+ * FORMAT_MINIMAL only writes the parens the parser needs to read the
+ * sentence back: "(a & b) > ~(c v d)". Since operators associate to the
+ * right, right-hand compound sentences need none; negated atoms that are
+ * not last in their group are written "(~a)".
+ */
+enum SentenceFormat
+{
+	FORMAT_FULL,
+	FORMAT_MINIMAL
+};
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Caller-owned, growable string. Zero-initialize it before first use and
+ * free(data) when done. data is always null-terminated once non-NULL.
+ */
+struct SentenceText_s
+{
+	char* data;
+	size_t length;
+	size_t capacity;
+};
+
+/// ===========================================================================
+/// Typedefs
+/// ===========================================================================
+
+typedef enum SentenceFormat SentenceFormat;
+typedef struct SentenceText_s SentenceText;
+
+/// ===========================================================================
+/// Function declarations - Utility
+/// ===========================================================================
+
+/**
+ * Computes how many characters the sentence takes in the given format,
+ * not counting a null terminator.
+ *
+ * @param sentence Sentence to measure.
+ * @param format Format to use.
+ * @return Returns the length.
+ */
+size_t Sentence_length(const Sentence sentence, const SentenceFormat format);
+
+/**
+ * Writes the sentence into a fixed-size array, snprintf style: at most
+ * size - 1 characters are written, followed by a null terminator.
+ *
+ * @param sentence Sentence to write.
+ * @param format Format to use.
+ * @param out Array to write to, may be NULL if size is 0.
+ * @param size Size of the array.
+ * @return Returns the full length of the sentence, which is larger than
+ *         or equal to size if the output was truncated.
+ */
+size_t Sentence_toString(
+	const Sentence sentence,
+	const SentenceFormat format,
+	char* out,
+	const size_t size);
+
+/**
+ * Appends the sentence to the text, growing it as needed.
+ *
+ * @param text Text to append to.
+ * @param sentence Sentence to write.
+ * @param format Format to use.
+ */
+void Sentence_append(
+	SentenceText* text,
+	const Sentence sentence,
+	const SentenceFormat format);
+
+/**
+ * Writes the sentence to the file. The file is not flushed.
+ *
+ * @param file File to write to.
+ * @param sentence Sentence to write.
+ * @param format Format to use.
+ * @return Returns the number of characters written.
+ */
+size_t Sentence_write(
+	FILE* file,
+	const Sentence sentence,
+	const SentenceFormat format);
+
+/**
+ * Writes every member of the set to the file, one per line. The file is
+ * not flushed.
+ *
+ * @param file File to write to.
+ * @param set Set to write.
+ * @param format Format to use.
+ * @return Returns the number of characters written.
+ */
+size_t SentenceSet_write(
+	FILE* file,
+	const SentenceSet set,
+	const SentenceFormat format);
+
+#endif
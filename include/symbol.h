@@ -0,0 +1,60 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Process-wide symbol table. Every distinct variable name is stored once
+ * and given a dense id, starting at 0 in order of first appearance, so
+ * variables can be compared as integers and used directly as indices.
+ */
+
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define SYMBOL_NONE UINT32_MAX
+
+/// ===========================================================================
+/// Function declarations - Accessors
+/// ===========================================================================
+
+/**
+ * Returns the id of the name, adding it to the table if it is new.
+ *
+ * @param name Name to intern, need not be null-terminated.
+ * @param len Number of characters in the name.
+ * @return Returns the id of the name.
+ */
+uint32_t Symbol_intern(const char* name, size_t len);
+
+/**
+ * Returns the id of the name without adding it.
+ *
+ * @param name Name to look up, need not be null-terminated.
+ * @param len Number of characters in the name.
+ * @return Returns the id, or SYMBOL_NONE if the name was never interned.
+ */
+uint32_t Symbol_find(const char* name, size_t len);
+
+/**
+ * Returns the name of an id. The string lives as long as the process
+ * and must not be modified or freed.
+ *
+ * @param id Id returned by Symbol_intern().
+ * @return Returns the null-terminated name.
+ */
+const char* Symbol_name(uint32_t id);
+
+/**
+ * Returns the number of interned names. Every id is less than this.
+ *
+ * @return Returns the number of names.
+ */
+uint32_t Symbol_count();
+
+#endif
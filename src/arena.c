@@ -0,0 +1,150 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for arena.h.
+ */
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+/**
+ * Rounds n up to the next multiple of alignment, which must be a power
+ * of two.
+ */
+static size_t _align(size_t n, size_t alignment)
+{
+	return (n + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * Size of the block header, padded so the first allocation in a block
+ * is aligned.
+ */
+static size_t _headerSize()
+{
+	return _align(sizeof(struct ArenaBlock_s), ARENA_ALIGNMENT);
+}
+
+/**
+ * Allocates a new block with room for at least size bytes and makes it
+ * the head of the arena.
+ */
+static struct ArenaBlock_s* _newBlock(Arena arena, size_t size)
+{
+	if (size < ARENA_BLOCK_SIZE) size = ARENA_BLOCK_SIZE;
+	struct ArenaBlock_s* block = malloc(_headerSize() + size);
+	block->next = arena->head;
+	block->size = size;
+	block->used = 0;
+	arena->head = block;
+	return block;
+}
+
+/**
+ * Carves size bytes from the head block at the given alignment, starting
+ * a new block if the head is full.
+ */
+static void* _alloc(Arena arena, size_t size, size_t alignment)
+{
+	struct ArenaBlock_s* block = arena->head;
+	size_t offset = block == NULL ? 0 : _align(block->used, alignment);
+
+	if (block == NULL || offset > block->size || block->size - offset < size)
+	{
+		block = _newBlock(arena, size);
+		offset = 0;
+	}
+
+	block->used = offset + size;
+	return (char*) block + _headerSize() + offset;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+Arena Arena_create()
+{
+	Arena arena = malloc(sizeof(struct Arena_s));
+	arena->head = NULL;
+	return arena;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void Arena_free(Arena arena)
+{
+	struct ArenaBlock_s* block = arena->head;
+
+	while (block != NULL)
+	{
+		struct ArenaBlock_s* next = block->next;
+		free(block);
+		block = next;
+	}
+
+	free(arena);
+}
+
+void Arena_reset(Arena arena)
+{
+	if (arena->head == NULL) return;
+
+	struct ArenaBlock_s* block = arena->head->next;
+
+	while (block != NULL)
+	{
+		struct ArenaBlock_s* next = block->next;
+		free(block);
+		block = next;
+	}
+
+	arena->head->next = NULL;
+	arena->head->used = 0;
+}
+
+void Arena_merge(Arena arena, Arena other)
+{
+	struct ArenaBlock_s* first = other->head;
+	free(other);
+	if (first == NULL) return;
+
+	struct ArenaBlock_s* last = first;
+	while (last->next != NULL) last = last->next;
+
+	// Keep arena's head block first, since it is the one allocated from
+	if (arena->head == NULL)
+	{
+		arena->head = first;
+	}
+	else
+	{
+		last->next = arena->head->next;
+		arena->head->next = first;
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void* Arena_alloc(Arena arena, size_t size)
+{
+	return _alloc(arena, size, ARENA_ALIGNMENT);
+}
+
+char* Arena_copyString(Arena arena, const char* string, size_t len)
+{
+	char* copy = _alloc(arena, len + 1, 1);
+	memcpy(copy, string, len);
+	copy[len] = '\0';
+	return copy;
+}
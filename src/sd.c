@@ -0,0 +1,1431 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sd.h.
+ *
+ * The search writes lines into the derivation as it goes, and cuts them
+ * off again when a branch fails, so the derivation is always the lines
+ * of the current branch. A line is available while it is not inside a
+ * closed subproof; the lines map gives the latest available line of each
+ * sentence, and each line remembers the entry it replaced, so closing a
+ * subproof or cutting lines off restores the map in reverse order.
+ *
+ * Cited lines may be anywhere they are available, as in SD. Only the
+ * last line of a subproof must be its conclusion, so a conclusion from
+ * outside the subproof is reiterated.
+ *
+ * Every point where the search picks among alternatives is a choice, and
+ * the path lists the choices taken by the current branch. A task is a
+ * path: a worker replays it from the root, taking only the recorded
+ * alternative at each of its choices, then searches on as usual. While
+ * some worker is idle, alternatives are handed out as tasks instead of
+ * being tried, on the worker's own deque; idle workers take the oldest
+ * task of another deque, which is the nearest the root. A goal whose
+ * alternatives were not all tried is not recorded as failed.
+ */
+
+#include "sd.h"
+#include "sentencemap.h"
+#include "sentencewrite.h"
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+#define _NONE SIZE_MAX
+
+/**
+ * A goal, and the assumptions it is sought under.
+ */
+struct _Goal
+{
+	Sentence goal;
+	uint64_t context;
+};
+
+/**
+ * A goal that could not be derived with remaining depth or less. Empty
+ * slots have a NULL goal.
+ */
+struct _Failure
+{
+	Sentence goal;
+	uint64_t context;
+	size_t remaining;
+};
+
+/**
+ * One lock stripe of the failed goals.
+ */
+struct _Shard
+{
+	pthread_mutex_t lock;
+	struct _Failure* failures;
+	size_t numFailures;
+	size_t tableSize;
+};
+
+/**
+ * A choice on the path: where it was made, by the kind of choice, the
+ * goal and the number of lines, and which alternative was taken.
+ */
+struct _Step
+{
+	Sentence goal;
+	size_t lines;
+	uint32_t alternative;
+	uint8_t kind;
+};
+
+struct _Task
+{
+	size_t depth;
+	size_t size;
+	struct _Step* steps;
+};
+
+/**
+ * The owner pushes and pops at the tail, other workers steal at the head.
+ */
+struct _Deque
+{
+	pthread_mutex_t lock;
+	struct _Task** tasks;
+	size_t head;
+	size_t tail;
+	size_t buffer;
+};
+
+/**
+ * State shared by the workers. The search runs in rounds, one per depth
+ * limit: each round starts with a single task, the empty path, and ends
+ * when no task of it is queued or running. pending, queued, idle, nodes
+ * and stop are accessed atomically; the rest of the round state is
+ * guarded by lock.
+ */
+struct _Shared
+{
+	SentenceSet set;
+	Sentence* premises;
+	size_t numPremises;
+	Sentence goal;
+	size_t maxDepth;
+	size_t maxNodes;
+	size_t threads;
+	size_t batch;
+
+	struct _Shard shards[SD_SHARDS];
+	struct _Deque* deques;
+
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	size_t depth;
+	uint8_t done;
+	SDDerivation result;
+
+	size_t pending;
+	size_t queued;
+	size_t idle;
+	size_t nodes;
+	uint8_t stop;
+};
+
+/**
+ * One worker's search. contexts[i] hashes the assumptions of the
+ * outermost i subproofs. prefix is the path of the task being replayed.
+ */
+struct _Search
+{
+	struct _Shared* shared;
+	size_t worker;
+	SentenceSet set;
+	SDDerivation derivation;
+
+	SentenceMap lines;
+	size_t* shadows;
+	uint8_t* available;
+	size_t buffer;
+
+	size_t* starts;
+	uint64_t* contexts;
+	size_t numStarts;
+	size_t maxStarts;
+
+	struct _Goal* goals;
+	size_t numGoals;
+	size_t maxGoals;
+
+	struct _Step* path;
+	size_t pathSize;
+	size_t maxPath;
+	const struct _Step* prefix;
+	size_t prefixSize;
+	size_t depth;
+
+	size_t nodes;
+	size_t cuts;
+};
+
+// Kinds of choices
+enum
+{
+	_STRATEGY,
+	_EXTRACT,
+	_DISJUNCT,
+	_CASES,
+	_CONTRADICTION
+};
+
+/// ===========================================================================
+/// Static functions - Lines
+/// ===========================================================================
+
+static SDCitation _line(size_t line)
+{
+	return (SDCitation) {line + 1, line + 1};
+}
+
+static SDCitation _range(size_t first, size_t last)
+{
+	return (SDCitation) {first + 1, last + 1};
+}
+
+/**
+ * Returns the latest available line of the sentence, or _NONE.
+ */
+static size_t _find(struct _Search* s, const Sentence sentence)
+{
+	void* value = NULL;
+	SentenceMap_get(s->lines, sentence, &value);
+	return value ? (size_t) (uintptr_t) value - 1 : _NONE;
+}
+
+/**
+ * Appends an available line in the current subproof.
+ */
+static size_t _add(
+	struct _Search* s,
+	const Sentence sentence,
+	const SDRule rule,
+	const SDCitation* citations,
+	const uint8_t numCitations)
+{
+	SDDerivation d = s->derivation;
+	size_t line = d->size;
+	SDDerivation_add(d, sentence, rule, s->numStarts, citations, numCitations);
+
+	if (line >= s->buffer)
+	{
+		s->buffer = d->buffer;
+		s->shadows = realloc(s->shadows, s->buffer * sizeof(size_t));
+		s->available = realloc(s->available, s->buffer);
+	}
+
+	void* value = NULL;
+	SentenceMap_get(s->lines, sentence, &value);
+	s->shadows[line] = (size_t) (uintptr_t) value;
+	s->available[line] = 1;
+	SentenceMap_put(s->lines, sentence, (void*) (uintptr_t) (line + 1));
+	return line;
+}
+
+/**
+ * Makes the line unavailable. Lines must be hidden latest first.
+ */
+static void _hide(struct _Search* s, size_t line)
+{
+	if (!s->available[line]) return;
+	s->available[line] = 0;
+	SentenceMap_put(s->lines, s->derivation->lines[line].sentence,
+		(void*) (uintptr_t) s->shadows[line]);
+}
+
+/**
+ * Removes the lines from mark on.
+ */
+static void _truncate(struct _Search* s, size_t mark)
+{
+	while (s->derivation->size > mark)
+	{
+		_hide(s, --s->derivation->size);
+	}
+}
+
+/**
+ * Opens a subproof.
+ *
+ * @return Returns the line of the assumption.
+ */
+static size_t _assume(struct _Search* s, const Sentence assumption)
+{
+	if (s->numStarts + 1 >= s->maxStarts)
+	{
+		s->maxStarts *= 2;
+		s->starts = realloc(s->starts, s->maxStarts * sizeof(size_t));
+		s->contexts = realloc(s->contexts, s->maxStarts * sizeof(uint64_t));
+	}
+
+	uint64_t hash = s->contexts[s->numStarts] ^ (uintptr_t) assumption;
+	hash = (hash ^ (hash >> 31)) * 0x7fb5d329728ea185ULL;
+	hash = (hash ^ (hash >> 27)) * 0x81dadef4bc2dd44dULL;
+
+	s->starts[s->numStarts] = s->derivation->size;
+	s->contexts[++s->numStarts] = hash ^ (hash >> 33);
+	return _add(s, assumption, SD_ASSUMPTION, NULL, 0);
+}
+
+/**
+ * Closes the innermost subproof, hiding its lines.
+ */
+static void _close(struct _Search* s)
+{
+	size_t start = s->starts[--s->numStarts];
+
+	for (size_t i = s->derivation->size; i-- > start;)
+	{
+		_hide(s, i);
+	}
+}
+
+/**
+ * Makes the sentence of an available line the last line of the
+ * innermost subproof.
+ */
+static size_t _conclude(struct _Search* s, size_t line)
+{
+	size_t start = s->starts[s->numStarts - 1];
+
+	if (line + 1 == s->derivation->size && line >= start) return line;
+
+	SDCitation citation = _line(line);
+	return _add(s, s->derivation->lines[line].sentence,
+		SD_REITERATION, &citation, 1);
+}
+
+/// ===========================================================================
+/// Static functions - Failures
+/// ===========================================================================
+
+static uint64_t _hash(const Sentence goal, uint64_t context)
+{
+	uint64_t hash = ((uintptr_t) goal >> 4) * 0x9e3779b97f4a7c15ULL ^ context;
+	return hash ^ (hash >> 29);
+}
+
+static size_t _slot(
+	const struct _Shard* shard,
+	const Sentence goal,
+	uint64_t context)
+{
+	size_t i = (size_t) (_hash(goal, context) >> 8) & (shard->tableSize - 1);
+
+	while (shard->failures[i].goal
+		&& (shard->failures[i].goal != goal
+			|| shard->failures[i].context != context))
+	{
+		i = (i + 1) & (shard->tableSize - 1);
+	}
+
+	return i;
+}
+
+static struct _Shard* _shard(
+	const struct _Search* s,
+	const Sentence goal,
+	uint64_t context)
+{
+	return &s->shared->shards[_hash(goal, context) % SD_SHARDS];
+}
+
+static uint8_t _failed(
+	const struct _Search* s,
+	const Sentence goal,
+	uint64_t context,
+	size_t remaining)
+{
+	struct _Shard* shard = _shard(s, goal, context);
+	pthread_mutex_lock(&shard->lock);
+	size_t i = _slot(shard, goal, context);
+	uint8_t failed = shard->failures[i].goal
+		&& shard->failures[i].remaining >= remaining;
+	pthread_mutex_unlock(&shard->lock);
+	return failed;
+}
+
+static void _fail(
+	const struct _Search* s,
+	const Sentence goal,
+	uint64_t context,
+	size_t remaining)
+{
+	struct _Shard* shard = _shard(s, goal, context);
+	pthread_mutex_lock(&shard->lock);
+
+	if (2 * (shard->numFailures + 1) > shard->tableSize)
+	{
+		struct _Failure* old = shard->failures;
+		size_t oldSize = shard->tableSize;
+		shard->tableSize *= 2;
+		shard->failures = calloc(shard->tableSize, sizeof(struct _Failure));
+
+		for (size_t i = 0; i < oldSize; i++)
+		{
+			if (!old[i].goal) continue;
+			shard->failures[_slot(shard, old[i].goal, old[i].context)] = old[i];
+		}
+
+		free(old);
+	}
+
+	size_t i = _slot(shard, goal, context);
+	if (!shard->failures[i].goal) shard->numFailures++;
+	if (shard->failures[i].remaining < remaining || !shard->failures[i].goal)
+	{
+		shard->failures[i] = (struct _Failure) {goal, context, remaining};
+	}
+
+	pthread_mutex_unlock(&shard->lock);
+}
+
+/// ===========================================================================
+/// Static functions - Tasks
+/// ===========================================================================
+
+static void _push(struct _Shared* shared, size_t worker, struct _Task* task)
+{
+	struct _Deque* deque = &shared->deques[worker];
+	__atomic_add_fetch(&shared->pending, 1, __ATOMIC_RELAXED);
+	pthread_mutex_lock(&deque->lock);
+
+	if (deque->tail == deque->buffer)
+	{
+		deque->buffer *= 2;
+		deque->tasks = realloc(deque->tasks,
+			deque->buffer * sizeof(struct _Task*));
+	}
+
+	deque->tasks[deque->tail++] = task;
+	pthread_mutex_unlock(&deque->lock);
+	__atomic_add_fetch(&shared->queued, 1, __ATOMIC_RELAXED);
+
+	pthread_mutex_lock(&shared->lock);
+	pthread_cond_broadcast(&shared->wake);
+	pthread_mutex_unlock(&shared->lock);
+}
+
+/**
+ * Pops the worker's newest task, or else steals another worker's oldest.
+ */
+static struct _Task* _take(struct _Shared* shared, size_t worker)
+{
+	for (size_t n = 0; n < shared->threads; n++)
+	{
+		struct _Deque* deque = &shared->deques[(worker + n) % shared->threads];
+		struct _Task* task = NULL;
+		pthread_mutex_lock(&deque->lock);
+
+		if (deque->head < deque->tail)
+		{
+			task = n == 0 ? deque->tasks[--deque->tail]
+				: deque->tasks[deque->head++];
+			if (deque->head == deque->tail) deque->head = deque->tail = 0;
+		}
+
+		pthread_mutex_unlock(&deque->lock);
+
+		if (task)
+		{
+			__atomic_sub_fetch(&shared->queued, 1, __ATOMIC_RELAXED);
+			return task;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Starts the next round, with the empty path one level deeper, or ends
+ * the search. Called with the lock held once no task is pending.
+ */
+static void _round(struct _Shared* shared)
+{
+	if (__atomic_load_n(&shared->stop, __ATOMIC_RELAXED)
+		|| shared->depth >= shared->maxDepth)
+	{
+		shared->done = 1;
+		pthread_cond_broadcast(&shared->wake);
+		return;
+	}
+
+	struct _Task* task = malloc(sizeof(struct _Task));
+	task->depth = ++shared->depth;
+	task->size = 0;
+	task->steps = NULL;
+
+	pthread_mutex_unlock(&shared->lock);
+	_push(shared, 0, task);
+	pthread_mutex_lock(&shared->lock);
+}
+
+/**
+ * Checks if the search was cancelled or ran out of nodes, counting one
+ * more node otherwise.
+ */
+static uint8_t _stopped(struct _Search* s)
+{
+	struct _Shared* shared = s->shared;
+	if (__atomic_load_n(&shared->stop, __ATOMIC_RELAXED)) return 1;
+	if (++s->nodes < shared->batch) return 0;
+
+	size_t nodes = __atomic_add_fetch(&shared->nodes, s->nodes,
+		__ATOMIC_RELAXED);
+	s->nodes = 0;
+	if (nodes <= shared->maxNodes) return 0;
+
+	__atomic_store_n(&shared->stop, 1, __ATOMIC_RELAXED);
+	return 1;
+}
+
+/**
+ * Adds a choice to the path.
+ *
+ * @return Returns its index on the path.
+ */
+static size_t _enter(struct _Search* s, const Sentence goal, uint8_t kind)
+{
+	if (s->pathSize == s->maxPath)
+	{
+		s->maxPath *= 2;
+		s->path = realloc(s->path, s->maxPath * sizeof(struct _Step));
+	}
+
+	s->path[s->pathSize] = (struct _Step) {goal, s->derivation->size, 0, kind};
+	return s->pathSize++;
+}
+
+/**
+ * Removes a choice that failed, and the choices after it, from the path.
+ */
+static void _leave(struct _Search* s, size_t choice)
+{
+	s->pathSize = choice;
+}
+
+/**
+ * Decides if this worker tries an alternative of a choice now. While
+ * replaying a task, only the alternative on its path is tried; after
+ * that, alternatives are handed out while another worker is idle.
+ *
+ * @return Returns 1 to try the alternative, 0 to skip it.
+ */
+static uint8_t _explore(struct _Search* s, size_t choice, uint32_t alternative)
+{
+	struct _Shared* shared = s->shared;
+	struct _Step* step = &s->path[choice];
+	s->pathSize = choice + 1;
+	step->alternative = alternative;
+
+	if (choice < s->prefixSize)
+	{
+		const struct _Step* taken = &s->prefix[choice];
+		if (taken->goal == step->goal && taken->lines == step->lines
+			&& taken->kind == step->kind && taken->alternative == alternative)
+		{
+			return 1;
+		}
+
+		s->cuts++;
+		return 0;
+	}
+
+	if (shared->threads == 1
+		|| __atomic_load_n(&shared->idle, __ATOMIC_RELAXED)
+			<= __atomic_load_n(&shared->queued, __ATOMIC_RELAXED))
+	{
+		return 1;
+	}
+
+	struct _Task* task = malloc(sizeof(struct _Task));
+	task->depth = s->depth;
+	task->size = choice + 1;
+	task->steps = malloc(task->size * sizeof(struct _Step));
+	memcpy(task->steps, s->path, task->size * sizeof(struct _Step));
+	_push(shared, s->worker, task);
+
+	s->cuts++;
+	return 0;
+}
+
+/// ===========================================================================
+/// Static functions - Search
+/// ===========================================================================
+
+static size_t _prove(struct _Search* s, const Sentence goal, size_t remaining);
+
+/**
+ * Checks if elimination rules could take the goal out of the sentence:
+ * the goal is a conjunct, the consequent of a conditional, or a side of
+ * a biconditional, or is in one of those.
+ */
+static uint8_t _reaches(const Sentence sentence, const Sentence goal)
+{
+	Sentence stack[64];
+	size_t size = 0;
+	stack[size++] = sentence;
+
+	while (size > 0)
+	{
+		Sentence current = stack[--size];
+		if (current == goal) return 1;
+		if (current->type == ATOMIC || current->negated) continue;
+		if (size + 2 > sizeof(stack) / sizeof(Sentence)) return 1;
+
+		switch (current->op)
+		{
+			case AND:
+			case MATERIAL_BICONDITIONAL:
+				stack[size++] = current->left.sentence;
+				stack[size++] = current->right.sentence;
+				break;
+			case MATERIAL_CONDITIONAL:
+				stack[size++] = current->right.sentence;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Lists the sentence and the sentences that elimination rules could take
+ * out of it, outermost first.
+ *
+ * @return Returns a malloc'd array.
+ */
+static Sentence* _parts(const Sentence sentence, size_t* size)
+{
+	size_t buffer = 8;
+	Sentence* parts = malloc(buffer * sizeof(Sentence));
+	parts[0] = sentence;
+	*size = 1;
+
+	for (size_t i = 0; i < *size; i++)
+	{
+		Sentence current = parts[i];
+		if (current->type == ATOMIC || current->negated) continue;
+		if (current->op == OR) continue;
+
+		if (*size + 2 > buffer)
+		{
+			buffer *= 2;
+			parts = realloc(parts, buffer * sizeof(Sentence));
+		}
+
+		if (current->op != MATERIAL_CONDITIONAL)
+		{
+			parts[(*size)++] = current->left.sentence;
+		}
+
+		parts[(*size)++] = current->right.sentence;
+	}
+
+	return parts;
+}
+
+/**
+ * Derives the goal from an available line by &E, >E and =E.
+ */
+static size_t _extract(
+	struct _Search* s,
+	size_t line,
+	const Sentence goal,
+	size_t remaining)
+{
+	Sentence sentence = s->derivation->lines[line].sentence;
+	if (sentence == goal) return line;
+	if (sentence->type == ATOMIC || sentence->negated) return _NONE;
+
+	size_t mark = s->derivation->size;
+	Sentence left = sentence->left.sentence;
+	Sentence right = sentence->right.sentence;
+	SDCitation citations[2] = {_line(line)};
+
+	size_t choice = _enter(s, goal, _EXTRACT);
+
+	if (sentence->op == AND)
+	{
+		Sentence parts[2] = {left, right};
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			if (!_reaches(parts[i], goal) || !_explore(s, choice, i)) continue;
+
+			size_t part = _find(s, parts[i]);
+			if (part == _NONE)
+			{
+				part = _add(s, parts[i], SD_AND_ELIM, citations, 1);
+			}
+
+			size_t result = _extract(s, part, goal, remaining);
+			if (result != _NONE) return result;
+			_truncate(s, mark);
+		}
+	}
+
+	else if (sentence->op == MATERIAL_CONDITIONAL
+		|| sentence->op == MATERIAL_BICONDITIONAL)
+	{
+		SDRule rule = sentence->op == MATERIAL_CONDITIONAL
+			? SD_IMPLIES_ELIM : SD_IFF_ELIM;
+		Sentence from[2] = {left, right};
+		Sentence to[2] = {right, left};
+		size_t sides = rule == SD_IMPLIES_ELIM ? 1 : 2;
+
+		for (uint32_t i = 0; i < sides; i++)
+		{
+			if (!_reaches(to[i], goal) || remaining == 0) continue;
+			if (!_explore(s, choice, i)) continue;
+
+			size_t premise = _prove(s, from[i], remaining - 1);
+			if (premise == _NONE) continue;
+
+			citations[1] = _line(premise);
+			size_t part = _add(s, to[i], rule, citations, 2);
+			size_t result = _extract(s, part, goal, remaining);
+			if (result != _NONE) return result;
+			_truncate(s, mark);
+		}
+	}
+
+	_leave(s, choice);
+	return _NONE;
+}
+
+/**
+ * Opens a subproof on the assumption and derives the goal as its last
+ * line. The subproof is left open.
+ *
+ * @return Returns the last line, or _NONE with the subproof closed and
+ *         its lines removed.
+ */
+static size_t _subproof(
+	struct _Search* s,
+	const Sentence assumption,
+	const Sentence goal,
+	size_t remaining)
+{
+	size_t mark = s->derivation->size;
+	_assume(s, assumption);
+
+	size_t line = _prove(s, goal, remaining);
+	if (line != _NONE) return _conclude(s, line);
+
+	_close(s);
+	_truncate(s, mark);
+	return _NONE;
+}
+
+/**
+ * Derives some Q and ~Q in the innermost subproof: at once if both are
+ * available, or else by deriving both for each Q that elimination rules
+ * could take out of an available line, latest line first.
+ *
+ * @return Returns 1 with the lines of Q and ~Q, or 0.
+ */
+static uint8_t _contradiction(
+	struct _Search* s,
+	size_t remaining,
+	size_t lines[2])
+{
+	SDDerivation d = s->derivation;
+	size_t size = d->size;
+
+	for (size_t i = size; i-- > 0;)
+	{
+		if (!s->available[i]) continue;
+
+		Sentence line = d->lines[i].sentence;
+		lines[0] = i;
+		lines[1] = _find(s, SentenceSet_negate(s->set, line, !line->negated));
+		if (lines[1] != _NONE) return 1;
+	}
+
+	SentenceMap tried = SentenceMap_create();
+	size_t choice = _enter(s, NULL, _CONTRADICTION);
+	uint32_t alternative = 0;
+	uint8_t found = 0;
+
+	for (size_t i = size; i-- > 0 && !found;)
+	{
+		if (!s->available[i] || _find(s, d->lines[i].sentence) != i) continue;
+
+		size_t numParts;
+		Sentence* parts = _parts(d->lines[i].sentence, &numParts);
+
+		for (size_t j = 0; j < numParts && !found; j++)
+		{
+			Sentence q = parts[j];
+			Sentence notQ = SentenceSet_negate(s->set, q, !q->negated);
+			if (SentenceMap_get(tried, q->negated ? notQ : q, NULL)) continue;
+			SentenceMap_put(tried, q->negated ? notQ : q, NULL);
+			if (!_explore(s, choice, alternative++)) continue;
+
+			size_t mark = d->size;
+			lines[0] = _prove(s, q, remaining);
+			lines[1] = lines[0] == _NONE ? _NONE : _prove(s, notQ, remaining);
+			found = lines[1] != _NONE;
+			if (!found) _truncate(s, mark);
+		}
+
+		free(parts);
+	}
+
+	SentenceMap_free(tried);
+	if (!found) _leave(s, choice);
+	return found;
+}
+
+/**
+ * Derives the goal by ~I or ~E, from a subproof that assumes its
+ * negation.
+ */
+static size_t _indirect(struct _Search* s, const Sentence goal, size_t remaining)
+{
+	size_t mark = s->derivation->size;
+	size_t first = _assume(s,
+		SentenceSet_negate(s->set, goal, !goal->negated));
+
+	size_t lines[2];
+
+	if (_contradiction(s, remaining, lines))
+	{
+		// The subproof itself must contain Q and ~Q
+		for (size_t i = 0; i < 2; i++)
+		{
+			if (lines[i] >= first) continue;
+
+			SDCitation citation = _line(lines[i]);
+			_add(s, s->derivation->lines[lines[i]].sentence,
+				SD_REITERATION, &citation, 1);
+		}
+
+		SDCitation citation = _range(first, s->derivation->size - 1);
+		_close(s);
+		return _add(s, goal, goal->negated ? SD_NOT_INTRO : SD_NOT_ELIM,
+			&citation, 1);
+	}
+
+	_close(s);
+	_truncate(s, mark);
+	return _NONE;
+}
+
+/**
+ * Derives the goal by the introduction rule of its main operator.
+ */
+static size_t _introduce(struct _Search* s, const Sentence goal, size_t remaining)
+{
+	size_t mark = s->derivation->size;
+	Sentence left = goal->left.sentence;
+	Sentence right = goal->right.sentence;
+	SDCitation citations[2];
+
+	if (goal->op == AND)
+	{
+		size_t l = _prove(s, left, remaining);
+		size_t r = l == _NONE ? _NONE : _prove(s, right, remaining);
+
+		if (r == _NONE)
+		{
+			_truncate(s, mark);
+			return _NONE;
+		}
+
+		citations[0] = _line(l);
+		citations[1] = _line(r);
+		return _add(s, goal, SD_AND_INTRO, citations, 2);
+	}
+
+	if (goal->op == OR)
+	{
+		size_t choice = _enter(s, goal, _DISJUNCT);
+		size_t line = _NONE;
+
+		if (_explore(s, choice, 0)) line = _prove(s, left, remaining);
+		if (line == _NONE && _explore(s, choice, 1))
+		{
+			line = _prove(s, right, remaining);
+		}
+
+		if (line == _NONE)
+		{
+			_leave(s, choice);
+			return _NONE;
+		}
+
+		citations[0] = _line(line);
+		return _add(s, goal, SD_OR_INTRO, citations, 1);
+	}
+
+	size_t first = s->derivation->size;
+	size_t last = _subproof(s, left, right, remaining);
+	if (last == _NONE) return _NONE;
+	_close(s);
+	citations[0] = _range(first, last);
+
+	if (goal->op == MATERIAL_CONDITIONAL)
+	{
+		return _add(s, goal, SD_IMPLIES_INTRO, citations, 1);
+	}
+
+	first = s->derivation->size;
+	last = _subproof(s, right, left, remaining);
+
+	if (last == _NONE)
+	{
+		_truncate(s, mark);
+		return _NONE;
+	}
+
+	_close(s);
+	citations[1] = _range(first, last);
+	return _add(s, goal, SD_IFF_INTRO, citations, 2);
+}
+
+/**
+ * Derives the goal by vE from a disjunction that elimination rules could
+ * take out of an available line, and neither side of which is available.
+ */
+static size_t _cases(struct _Search* s, const Sentence goal, size_t remaining)
+{
+	SDDerivation d = s->derivation;
+	size_t size = d->size;
+	size_t line = _NONE;
+	size_t choice = _enter(s, goal, _CASES);
+	uint32_t alternative = 0;
+
+	for (size_t i = size; i-- > 0 && line == _NONE;)
+	{
+		if (!s->available[i] || _find(s, d->lines[i].sentence) != i) continue;
+
+		size_t numParts;
+		Sentence* parts = _parts(d->lines[i].sentence, &numParts);
+
+		for (size_t j = 0; j < numParts && line == _NONE; j++)
+		{
+			Sentence disjunction = parts[j];
+			if (disjunction->type == ATOMIC || disjunction->negated) continue;
+			if (disjunction->op != OR) continue;
+			if (_find(s, disjunction->left.sentence) != _NONE) continue;
+			if (_find(s, disjunction->right.sentence) != _NONE) continue;
+			if (!_explore(s, choice, alternative++)) continue;
+
+			size_t mark = d->size;
+			size_t source = _find(s, disjunction);
+			if (source == _NONE) source = _extract(s, i, disjunction, remaining);
+			if (source == _NONE) continue;
+
+			SDCitation citations[3] = {_line(source)};
+
+			size_t first = d->size;
+			size_t last = _subproof(s, disjunction->left.sentence, goal,
+				remaining);
+
+			if (last != _NONE)
+			{
+				_close(s);
+				citations[1] = _range(first, last);
+
+				first = d->size;
+				last = _subproof(s, disjunction->right.sentence, goal,
+					remaining);
+			}
+
+			if (last == _NONE)
+			{
+				_truncate(s, mark);
+				continue;
+			}
+
+			_close(s);
+			citations[2] = _range(first, last);
+			line = _add(s, goal, SD_OR_ELIM, citations, 3);
+		}
+
+		free(parts);
+	}
+
+	if (line == _NONE) _leave(s, choice);
+	return line;
+}
+
+/**
+ * Tries each strategy in turn: elimination from available lines,
+ * introduction, cases on a disjunction, then indirect proof.
+ */
+static size_t _strategies(struct _Search* s, const Sentence goal, size_t remaining)
+{
+	SDDerivation d = s->derivation;
+	size_t size = d->size;
+	size_t choice = _enter(s, goal, _STRATEGY);
+	uint32_t alternative = 0;
+	size_t line = _NONE;
+
+	for (size_t i = size; i-- > 0 && line == _NONE;)
+	{
+		if (!s->available[i] || _find(s, d->lines[i].sentence) != i) continue;
+		if (!_reaches(d->lines[i].sentence, goal)) continue;
+		if (!_explore(s, choice, alternative++)) continue;
+
+		line = _extract(s, i, goal, remaining);
+	}
+
+	if (line == _NONE && goal->type == COMPOUND && !goal->negated
+		&& _explore(s, choice, alternative++))
+	{
+		line = _introduce(s, goal, remaining - 1);
+	}
+
+	if (line == _NONE && _explore(s, choice, alternative++))
+	{
+		line = _cases(s, goal, remaining - 1);
+	}
+
+	if (line == _NONE && _explore(s, choice, alternative++))
+	{
+		line = _indirect(s, goal, remaining - 1);
+	}
+
+	if (line == _NONE) _leave(s, choice);
+	return line;
+}
+
+/**
+ * Derives the goal from the available lines with at most remaining
+ * nested goals.
+ *
+ * @return Returns an available line of the goal, or _NONE.
+ */
+static size_t _prove(struct _Search* s, const Sentence goal, size_t remaining)
+{
+	size_t line = _find(s, goal);
+	if (line != _NONE) return line;
+	if (remaining == 0 || _stopped(s)) return _NONE;
+
+	uint64_t context = s->contexts[s->numStarts];
+	if (_failed(s, goal, context, remaining)) return _NONE;
+
+	for (size_t i = 0; i < s->numGoals; i++)
+	{
+		if (s->goals[i].goal == goal && s->goals[i].context == context)
+		{
+			s->cuts++;
+			return _NONE;
+		}
+	}
+
+	if (s->numGoals == s->maxGoals)
+	{
+		s->maxGoals *= 2;
+		s->goals = realloc(s->goals, s->maxGoals * sizeof(struct _Goal));
+	}
+
+	s->goals[s->numGoals++] = (struct _Goal) {goal, context};
+	size_t cuts = s->cuts;
+	size_t mark = s->derivation->size;
+
+	line = _strategies(s, goal, remaining);
+	s->numGoals--;
+
+	if (line == _NONE)
+	{
+		_truncate(s, mark);
+
+		// A goal cut short may succeed elsewhere
+		if (cuts == s->cuts
+			&& !__atomic_load_n(&s->shared->stop, __ATOMIC_RELAXED))
+		{
+			_fail(s, goal, context, remaining);
+		}
+	}
+
+	return line;
+}
+
+/// ===========================================================================
+/// Static functions - Workers
+/// ===========================================================================
+
+static void _initialize(struct _Search* s, struct _Shared* shared, size_t worker)
+{
+	memset(s, 0, sizeof(struct _Search));
+	s->shared = shared;
+	s->worker = worker;
+	s->set = shared->set;
+	s->derivation = SDDerivation_create();
+	s->lines = SentenceMap_create();
+	s->maxStarts = 8;
+	s->starts = malloc(s->maxStarts * sizeof(size_t));
+	s->contexts = malloc(s->maxStarts * sizeof(uint64_t));
+	s->contexts[0] = 0;
+	s->maxGoals = 16;
+	s->goals = malloc(s->maxGoals * sizeof(struct _Goal));
+	s->maxPath = 16;
+	s->path = malloc(s->maxPath * sizeof(struct _Step));
+
+	for (size_t i = 0; i < shared->numPremises; i++)
+	{
+		_add(s, shared->premises[i], SD_PREMISE, NULL, 0);
+	}
+}
+
+static void _release(struct _Search* s)
+{
+	SDDerivation_free(s->derivation);
+	SentenceMap_free(s->lines);
+	free(s->shadows);
+	free(s->available);
+	free(s->starts);
+	free(s->contexts);
+	free(s->goals);
+	free(s->path);
+}
+
+/**
+ * Searches the part of the round's tree that a task covers. The first
+ * derivation found becomes the result and cancels the search.
+ */
+static void _run(struct _Search* s, const struct _Task* task)
+{
+	struct _Shared* shared = s->shared;
+	_truncate(s, shared->numPremises);
+	s->numStarts = 0;
+	s->numGoals = 0;
+	s->pathSize = 0;
+	s->prefix = task->steps;
+	s->prefixSize = task->size;
+	s->depth = task->depth;
+
+	size_t line = _prove(s, shared->goal, task->depth);
+	if (line == _NONE) return;
+
+	pthread_mutex_lock(&shared->lock);
+
+	if (!shared->result)
+	{
+		SDDerivation d = s->derivation;
+		SDDerivation result = SDDerivation_create();
+		result->buffer = d->buffer;
+		result->lines = realloc(result->lines, d->buffer * sizeof(SDLine));
+		result->size = d->size;
+		memcpy(result->lines, d->lines, d->size * sizeof(SDLine));
+
+		if (line + 1 != result->size)
+		{
+			SDCitation citation = _line(line);
+			SDDerivation_add(result, shared->goal, SD_REITERATION, 0,
+				&citation, 1);
+		}
+
+		shared->result = result;
+		__atomic_store_n(&shared->stop, 1, __ATOMIC_RELAXED);
+	}
+
+	pthread_mutex_unlock(&shared->lock);
+}
+
+static void* _work(void* arg)
+{
+	struct _Search* s = arg;
+	struct _Shared* shared = s->shared;
+	if (shared->threads > 1) SentenceSet_join(shared->set);
+
+	for (;;)
+	{
+		struct _Task* task = _take(shared, s->worker);
+
+		if (task)
+		{
+			_run(s, task);
+			free(task->steps);
+			free(task);
+
+			if (__atomic_sub_fetch(&shared->pending, 1, __ATOMIC_ACQ_REL) == 0)
+			{
+				pthread_mutex_lock(&shared->lock);
+				_round(shared);
+				pthread_mutex_unlock(&shared->lock);
+			}
+
+			continue;
+		}
+
+		pthread_mutex_lock(&shared->lock);
+
+		while (!shared->done
+			&& __atomic_load_n(&shared->queued, __ATOMIC_RELAXED) == 0)
+		{
+			__atomic_add_fetch(&shared->idle, 1, __ATOMIC_RELAXED);
+			pthread_cond_wait(&shared->wake, &shared->lock);
+			__atomic_sub_fetch(&shared->idle, 1, __ATOMIC_RELAXED);
+		}
+
+		uint8_t done = shared->done;
+		pthread_mutex_unlock(&shared->lock);
+		if (done) break;
+	}
+
+	if (shared->threads > 1) SentenceSet_leave(shared->set);
+	return NULL;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SDDerivation SDDerivation_create()
+{
+	SDDerivation derivation = malloc(sizeof(struct SDDerivation_s));
+	derivation->size = 0;
+	derivation->buffer = 16;
+	derivation->lines = malloc(derivation->buffer * sizeof(SDLine));
+	return derivation;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SDDerivation_free(SDDerivation derivation)
+{
+	if (!derivation) return;
+	free(derivation->lines);
+	free(derivation);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void SDDerivation_add(
+	SDDerivation derivation,
+	const Sentence sentence,
+	const SDRule rule,
+	const uint32_t depth,
+	const SDCitation* citations,
+	const uint8_t numCitations)
+{
+	if (derivation->size == derivation->buffer)
+	{
+		derivation->buffer *= 2;
+		derivation->lines = realloc(derivation->lines,
+			derivation->buffer * sizeof(SDLine));
+	}
+
+	SDLine* line = &derivation->lines[derivation->size++];
+	memset(line, 0, sizeof(SDLine));
+	line->sentence = sentence;
+	line->rule = rule;
+	line->depth = depth;
+	line->numCitations = numCitations;
+
+	for (uint8_t i = 0; i < numCitations && i < 3; i++)
+	{
+		line->citations[i] = citations[i];
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - SD Rules
+/// ===========================================================================
+
+SDDerivation SD_derive(
+	SentenceSet set,
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence goal,
+	const size_t maxDepth,
+	const size_t maxNodes)
+{
+	return SD_deriveParallel(set, premises, numPremises, goal,
+		maxDepth, maxNodes, 1);
+}
+
+SDDerivation SD_deriveParallel(
+	SentenceSet set,
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence goal,
+	const size_t maxDepth,
+	const size_t maxNodes,
+	size_t threads)
+{
+	if (threads == 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cores > 0 ? (size_t) cores : 1;
+	}
+
+	struct _Shared shared;
+	memset(&shared, 0, sizeof(struct _Shared));
+	shared.set = set;
+	shared.premises = malloc((numPremises + 1) * sizeof(Sentence));
+	shared.numPremises = numPremises;
+	shared.maxDepth = maxDepth;
+	shared.maxNodes = maxNodes;
+	shared.threads = threads;
+	shared.batch = threads == 1 ? 1 : SD_BATCH;
+
+	for (size_t i = 0; i < numPremises; i++)
+	{
+		SentenceSet_add(set, premises[i]);
+		shared.premises[i] = SentenceSet_find(set, premises[i]);
+	}
+
+	SentenceSet_add(set, goal);
+	shared.goal = SentenceSet_find(set, goal);
+
+	for (size_t i = 0; i < SD_SHARDS; i++)
+	{
+		pthread_mutex_init(&shared.shards[i].lock, NULL);
+		shared.shards[i].tableSize = 16;
+		shared.shards[i].failures = calloc(16, sizeof(struct _Failure));
+	}
+
+	shared.deques = malloc(threads * sizeof(struct _Deque));
+	struct _Search* searches = malloc(threads * sizeof(struct _Search));
+
+	for (size_t n = 0; n < threads; n++)
+	{
+		pthread_mutex_init(&shared.deques[n].lock, NULL);
+		shared.deques[n].buffer = 16;
+		shared.deques[n].tasks = malloc(16 * sizeof(struct _Task*));
+		shared.deques[n].head = shared.deques[n].tail = 0;
+		_initialize(&searches[n], &shared, n);
+	}
+
+	pthread_mutex_init(&shared.lock, NULL);
+	pthread_cond_init(&shared.wake, NULL);
+
+	// The first round tries the premises alone
+	struct _Task* task = malloc(sizeof(struct _Task));
+	task->depth = 0;
+	task->size = 0;
+	task->steps = NULL;
+	_push(&shared, 0, task);
+
+	if (threads > 1) SentenceSet_share(set);
+	pthread_t* ids = malloc(threads * sizeof(pthread_t));
+
+	// Workers that fail to start leave their deques empty, and the rest
+	// go on without them
+	size_t started = 1;
+	while (started < threads
+		&& pthread_create(&ids[started], NULL, _work, &searches[started]) == 0)
+	{
+		started++;
+	}
+
+	_work(&searches[0]);
+	for (size_t n = 1; n < started; n++) pthread_join(ids[n], NULL);
+	if (threads > 1) SentenceSet_unshare(set);
+
+	for (size_t n = 0; n < threads; n++)
+	{
+		_release(&searches[n]);
+		pthread_mutex_destroy(&shared.deques[n].lock);
+		free(shared.deques[n].tasks);
+	}
+
+	for (size_t i = 0; i < SD_SHARDS; i++)
+	{
+		pthread_mutex_destroy(&shared.shards[i].lock);
+		free(shared.shards[i].failures);
+	}
+
+	pthread_mutex_destroy(&shared.lock);
+	pthread_cond_destroy(&shared.wake);
+	free(ids);
+	free(searches);
+	free(shared.deques);
+	free(shared.premises);
+	return shared.result;
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+char* SDRule_toString(SDRule rule)
+{
+	switch (rule)
+	{
+		case SD_PREMISE: return "Premise";
+		case SD_ASSUMPTION: return "Assumption";
+		case SD_REITERATION: return "R";
+		case SD_AND_INTRO: return "&I";
+		case SD_AND_ELIM: return "&E";
+		case SD_OR_INTRO: return "vI";
+		case SD_OR_ELIM: return "vE";
+		case SD_IMPLIES_INTRO: return ">I";
+		case SD_IMPLIES_ELIM: return ">E";
+		case SD_IFF_INTRO: return "=I";
+		case SD_IFF_ELIM: return "=E";
+		case SD_NOT_INTRO: return "~I";
+		case SD_NOT_ELIM: return "~E";
+		default: return "?";
+	}
+}
+
+size_t SDDerivation_write(FILE* file, const SDDerivation derivation)
+{
+	size_t digits = 1;
+	size_t width = 0;
+
+	for (size_t n = derivation->size; n >= 10; n /= 10) digits++;
+
+	for (size_t i = 0; i < derivation->size; i++)
+	{
+		SDLine* line = &derivation->lines[i];
+		size_t length = 2 * line->depth
+			+ Sentence_length(line->sentence, FORMAT_MINIMAL);
+		if (length > width) width = length;
+	}
+
+	size_t written = 0;
+
+	for (size_t i = 0; i < derivation->size; i++)
+	{
+		SDLine* line = &derivation->lines[i];
+		written += fprintf(file, "%*zu  ", (int) digits, i + 1);
+
+		for (uint32_t j = 0; j < line->depth; j++)
+		{
+			written += fprintf(file, "| ");
+		}
+
+		size_t length = Sentence_write(file, line->sentence, FORMAT_MINIMAL);
+		written += length;
+		written += fprintf(file, "%*s%s", (int) (width - 2 * line->depth
+			- length + 3), "", SDRule_toString(line->rule));
+
+		for (uint8_t j = 0; j < line->numCitations; j++)
+		{
+			SDCitation c = line->citations[j];
+			written += fprintf(file, j == 0 ? " " : ", ");
+			written += c.first == c.last
+				? fprintf(file, "%zu", c.first)
+				: fprintf(file, "%zu-%zu", c.first, c.last);
+		}
+
+		written += fprintf(file, "\n");
+	}
+
+	return written;
+}
@@ -0,0 +1,454 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Checking derivations in SD, for sd.h.
+ *
+ * Lines are checked in one pass. The open subproofs are kept as a stack
+ * of their assumptions, and each line records the assumption of the
+ * innermost subproof it is in, so whether a line is still accessible is
+ * a single comparison with the stack. Sentences are compared by address,
+ * and a sentence and its negation by their operator and children, which
+ * are members of the same set.
+ *
+ * To see that a ~I or ~E subproof contains some Q and ~Q, the checker
+ * keeps the latest accessible line of each sentence, in a table keyed by
+ * the sentence less its negation flag. When a line's opposite is the
+ * latest accessible one and is in the same subproof, that subproof is
+ * marked. Closing a subproof restores the entries its lines replaced,
+ * from a trail of the lines recorded, so each line is restored once.
+ */
+
+#include "sd.h"
+#include "sentencemap.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+#define _NONE SIZE_MAX
+
+/**
+ * What the checker knows of a line. owner is the assumption of the
+ * innermost subproof the line is in, or _NONE. The rest is for
+ * assumptions only: outer is the owner of the subproof around theirs,
+ * end the last line of their subproof once it is closed, and
+ * contradiction is set if it contains some Q and ~Q.
+ */
+struct _Line
+{
+	size_t owner;
+	size_t outer;
+	size_t end;
+	size_t shadow;
+	uint8_t contradiction;
+};
+
+/**
+ * lines[negated] is the latest accessible line of the sentence with that
+ * flag, plus 1. Empty slots have a NULL sentence.
+ */
+struct _Entry
+{
+	Sentence sentence;
+	size_t lines[2];
+};
+
+struct _Checker
+{
+	const SDDerivation derivation;
+	struct _Line* lines;
+
+	size_t* starts;
+	size_t depth;
+
+	size_t* trail;
+	size_t trailSize;
+
+	struct _Entry* table;
+	size_t tableSize;
+	size_t numEntries;
+};
+
+/// ===========================================================================
+/// Static functions - Sentences
+/// ===========================================================================
+
+/**
+ * Checks if the sentences differ only in their negation flags.
+ */
+static uint8_t _sameBase(const Sentence a, const Sentence b)
+{
+	if (a->type != b->type) return 0;
+	if (a->type == ATOMIC) return a->id == b->id;
+	return a->op == b->op && a->left.sentence == b->left.sentence
+		&& a->right.sentence == b->right.sentence;
+}
+
+static uint8_t _opposite(const Sentence a, const Sentence b)
+{
+	return a->negated != b->negated && _sameBase(a, b);
+}
+
+/**
+ * Checks if the sentence is an unnegated compound with the operator.
+ */
+static uint8_t _is(const Sentence sentence, SentenceOperator op)
+{
+	return sentence->type == COMPOUND && !sentence->negated
+		&& sentence->op == op;
+}
+
+static uint64_t _hash(const Sentence sentence)
+{
+	uint64_t hash = sentence->type == ATOMIC ? sentence->id
+		: ((uintptr_t) sentence->left.sentence >> 4) * 0x9e3779b97f4a7c15ULL
+			^ ((uintptr_t) sentence->right.sentence >> 4) * 31 ^ sentence->op;
+	hash = (hash ^ (hash >> 31)) * 0x7fb5d329728ea185ULL;
+	return hash ^ (hash >> 27);
+}
+
+/// ===========================================================================
+/// Static functions - Latest lines
+/// ===========================================================================
+
+static struct _Entry* _entry(struct _Checker* c, const Sentence sentence)
+{
+	if (2 * (c->numEntries + 1) > c->tableSize)
+	{
+		struct _Entry* old = c->table;
+		size_t oldSize = c->tableSize;
+		c->tableSize *= 2;
+		c->table = calloc(c->tableSize, sizeof(struct _Entry));
+
+		for (size_t n = 0; n < oldSize; n++)
+		{
+			if (!old[n].sentence) continue;
+			size_t i = _hash(old[n].sentence) & (c->tableSize - 1);
+			while (c->table[i].sentence) i = (i + 1) & (c->tableSize - 1);
+			c->table[i] = old[n];
+		}
+
+		free(old);
+	}
+
+	size_t i = _hash(sentence) & (c->tableSize - 1);
+
+	while (c->table[i].sentence && !_sameBase(c->table[i].sentence, sentence))
+	{
+		i = (i + 1) & (c->tableSize - 1);
+	}
+
+	if (!c->table[i].sentence)
+	{
+		c->table[i].sentence = sentence;
+		c->numEntries++;
+	}
+
+	return &c->table[i];
+}
+
+/**
+ * Makes the line the latest of its sentence, and marks its subproof if
+ * the latest line of the opposite sentence is in it too.
+ */
+static void _record(struct _Checker* c, size_t line)
+{
+	Sentence sentence = c->derivation->lines[line].sentence;
+	struct _Entry* entry = _entry(c, sentence);
+	size_t owner = c->lines[line].owner;
+	size_t other = entry->lines[!sentence->negated];
+
+	if (owner != _NONE && other && c->lines[other - 1].owner == owner)
+	{
+		c->lines[owner].contradiction = 1;
+	}
+
+	c->lines[line].shadow = entry->lines[sentence->negated];
+	entry->lines[sentence->negated] = line + 1;
+	c->trail[c->trailSize++] = line;
+}
+
+/**
+ * Closes the innermost subproof, whose last line is before line.
+ */
+static void _close(struct _Checker* c, size_t line)
+{
+	size_t start = c->starts[--c->depth];
+	c->lines[start].end = line - 1;
+
+	while (c->trailSize > 0 && c->trail[c->trailSize - 1] >= start)
+	{
+		size_t i = c->trail[--c->trailSize];
+		Sentence sentence = c->derivation->lines[i].sentence;
+		_entry(c, sentence)->lines[sentence->negated] = c->lines[i].shadow;
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Citations
+/// ===========================================================================
+
+/**
+ * Returns the sentence of a cited line that is accessible at the line
+ * being checked, or NULL.
+ */
+static Sentence _cited(
+	const struct _Checker* c,
+	size_t line,
+	const SDCitation citation)
+{
+	if (citation.first != citation.last) return NULL;
+	if (citation.first == 0 || citation.first > line) return NULL;
+
+	size_t cited = citation.first - 1;
+	uint32_t depth = c->derivation->lines[cited].depth;
+	if (depth == 0) return c->derivation->lines[cited].sentence;
+	if (depth > c->depth || c->starts[depth - 1] != c->lines[cited].owner)
+	{
+		return NULL;
+	}
+
+	return c->derivation->lines[cited].sentence;
+}
+
+/**
+ * Checks that a cited subproof is closed, ends where cited, and is
+ * directly inside a subproof that is open at the line being checked.
+ * Gives its assumption and last sentence.
+ */
+static uint8_t _subproof(
+	const struct _Checker* c,
+	size_t line,
+	const SDCitation citation,
+	Sentence* assumption,
+	Sentence* conclusion)
+{
+	if (citation.first == 0 || citation.first > citation.last) return 0;
+	if (citation.last > line) return 0;
+
+	size_t first = citation.first - 1;
+	size_t last = citation.last - 1;
+	const SDLine* lines = c->derivation->lines;
+	if (lines[first].rule != SD_ASSUMPTION) return 0;
+	if (c->lines[first].end != last || c->lines[last].owner != first) return 0;
+
+	uint32_t depth = lines[first].depth;
+	if (depth - 1 > c->depth) return 0;
+	if (depth > 1 && c->starts[depth - 2] != c->lines[first].outer) return 0;
+
+	*assumption = lines[first].sentence;
+	*conclusion = lines[last].sentence;
+	return 1;
+}
+
+/**
+ * Checks if the minor premise and conclusion fit the sides of the
+ * biconditional, in either direction.
+ */
+static uint8_t _iffElim(const Sentence major, const Sentence minor, const Sentence s)
+{
+	if (!major || !minor || !_is(major, MATERIAL_BICONDITIONAL)) return 0;
+	return (major->left.sentence == minor && major->right.sentence == s)
+		|| (major->right.sentence == minor && major->left.sentence == s);
+}
+
+static uint8_t _impliesElim(
+	const Sentence major,
+	const Sentence minor,
+	const Sentence s)
+{
+	if (!major || !minor || !_is(major, MATERIAL_CONDITIONAL)) return 0;
+	return major->left.sentence == minor && major->right.sentence == s;
+}
+
+/**
+ * Checks the sentence and citations of a line against its rule.
+ */
+static uint8_t _justified(const struct _Checker* c, size_t line)
+{
+	const SDLine* l = &c->derivation->lines[line];
+	const SDCitation* cites = l->citations;
+	Sentence s = l->sentence;
+	Sentence a, b, p, q;
+
+	switch (l->rule)
+	{
+		case SD_PREMISE:
+		case SD_ASSUMPTION:
+			return l->numCitations == 0;
+
+		case SD_REITERATION:
+			if (l->numCitations != 1) return 0;
+			return _cited(c, line, cites[0]) == s;
+
+		case SD_AND_INTRO:
+			if (l->numCitations != 2 || !_is(s, AND)) return 0;
+			a = _cited(c, line, cites[0]);
+			b = _cited(c, line, cites[1]);
+			return (a == s->left.sentence && b == s->right.sentence)
+				|| (b == s->left.sentence && a == s->right.sentence);
+
+		case SD_AND_ELIM:
+			if (l->numCitations != 1) return 0;
+			a = _cited(c, line, cites[0]);
+			return a && _is(a, AND)
+				&& (a->left.sentence == s || a->right.sentence == s);
+
+		case SD_OR_INTRO:
+			if (l->numCitations != 1 || !_is(s, OR)) return 0;
+			a = _cited(c, line, cites[0]);
+			return a && (s->left.sentence == a || s->right.sentence == a);
+
+		case SD_OR_ELIM:
+		{
+			if (l->numCitations != 3) return 0;
+			Sentence d = _cited(c, line, cites[0]);
+			if (!d || !_is(d, OR)) return 0;
+			if (!_subproof(c, line, cites[1], &a, &p)) return 0;
+			if (!_subproof(c, line, cites[2], &b, &q)) return 0;
+			if (p != s || q != s) return 0;
+			return (a == d->left.sentence && b == d->right.sentence)
+				|| (b == d->left.sentence && a == d->right.sentence);
+		}
+
+		case SD_IMPLIES_INTRO:
+			if (l->numCitations != 1 || !_is(s, MATERIAL_CONDITIONAL)) return 0;
+			if (!_subproof(c, line, cites[0], &a, &p)) return 0;
+			return a == s->left.sentence && p == s->right.sentence;
+
+		case SD_IMPLIES_ELIM:
+			if (l->numCitations != 2) return 0;
+			a = _cited(c, line, cites[0]);
+			b = _cited(c, line, cites[1]);
+			return _impliesElim(a, b, s) || _impliesElim(b, a, s);
+
+		case SD_IFF_INTRO:
+			if (l->numCitations != 2 || !_is(s, MATERIAL_BICONDITIONAL))
+			{
+				return 0;
+			}
+
+			if (!_subproof(c, line, cites[0], &a, &p)) return 0;
+			if (!_subproof(c, line, cites[1], &b, &q)) return 0;
+			return (a == s->left.sentence && p == s->right.sentence
+					&& b == s->right.sentence && q == s->left.sentence)
+				|| (a == s->right.sentence && p == s->left.sentence
+					&& b == s->left.sentence && q == s->right.sentence);
+
+		case SD_IFF_ELIM:
+			if (l->numCitations != 2) return 0;
+			a = _cited(c, line, cites[0]);
+			b = _cited(c, line, cites[1]);
+			return _iffElim(a, b, s) || _iffElim(b, a, s);
+
+		case SD_NOT_INTRO:
+		case SD_NOT_ELIM:
+			if (l->numCitations != 1) return 0;
+			if (s->negated != (l->rule == SD_NOT_INTRO)) return 0;
+			if (!_subproof(c, line, cites[0], &a, &p)) return 0;
+			return _opposite(a, s)
+				&& c->lines[cites[0].first - 1].contradiction;
+
+		default:
+			return 0;
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - SD Rules
+/// ===========================================================================
+
+size_t SDDerivation_check(const SDDerivation derivation)
+{
+	size_t size = derivation->size;
+	struct _Checker c = {derivation, NULL, NULL, 0, NULL, 0, NULL, 16, 0};
+	c.lines = malloc((size + 1) * sizeof(struct _Line));
+	c.starts = malloc((size + 1) * sizeof(size_t));
+	c.trail = malloc((size + 1) * sizeof(size_t));
+	c.table = calloc(c.tableSize, sizeof(struct _Entry));
+
+	size_t bad = 0;
+	uint8_t premises = 1;
+
+	for (size_t i = 0; i < size && !bad; i++)
+	{
+		const SDLine* line = &derivation->lines[i];
+		uint8_t assumption = line->rule == SD_ASSUMPTION;
+
+		// Premises come first, and only assumptions open subproofs
+		if ((line->rule == SD_PREMISE && (!premises || line->depth != 0))
+			|| (assumption && line->depth == 0)
+			|| line->depth > c.depth + assumption)
+		{
+			bad = i + 1;
+			break;
+		}
+
+		premises = premises && line->rule == SD_PREMISE;
+		while (c.depth + assumption > line->depth) _close(&c, i);
+
+		c.lines[i].end = _NONE;
+		c.lines[i].contradiction = 0;
+
+		if (assumption)
+		{
+			c.lines[i].outer = c.depth ? c.starts[c.depth - 1] : _NONE;
+			c.starts[c.depth++] = i;
+		}
+
+		c.lines[i].owner = c.depth ? c.starts[c.depth - 1] : _NONE;
+		if (!_justified(&c, i)) bad = i + 1;
+		_record(&c, i);
+	}
+
+	free(c.lines);
+	free(c.starts);
+	free(c.trail);
+	free(c.table);
+	return bad;
+}
+
+uint8_t SDDerivation_proves(
+	const SDDerivation derivation,
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence goal)
+{
+	if (derivation->size == 0) return 0;
+
+	const SDLine* last = &derivation->lines[derivation->size - 1];
+	if (last->sentence != goal || last->depth != 0) return 0;
+
+	SentenceMap given = SentenceMap_create();
+	uint8_t proves = 1;
+
+	for (size_t n = 0; n < numPremises; n++)
+	{
+		SentenceMap_put(given, premises[n], NULL);
+	}
+
+	for (size_t i = 0; i < derivation->size && proves; i++)
+	{
+		if (derivation->lines[i].rule != SD_PREMISE) break;
+		proves = SentenceMap_get(given, derivation->lines[i].sentence, NULL);
+	}
+
+	SentenceMap_free(given);
+	return proves && SDDerivation_check(derivation) == 0;
+}
+
+uint8_t SDRule_parse(const char* name, SDRule* rule)
+{
+	for (SDRule r = SD_PREMISE; r <= SD_NOT_ELIM; r++)
+	{
+		if (strcmp(name, SDRule_toString(r)) == 0)
+		{
+			*rule = r;
+			return 1;
+		}
+	}
+
+	return 0;
+}
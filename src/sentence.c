@@ -6,6 +6,7 @@
  */
 
 #include "sentence.h"
+#include "sentencewrite.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -28,32 +29,65 @@ char* SentenceOperator_toString(SentenceOperator op)
 	}
 }
 
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+/**
+ * Allocates an uninitialized sentence from the arena, or from the heap
+ * if arena is NULL.
+ */
+static Sentence _allocate(Arena arena)
+{
+	if (arena != NULL) return Arena_alloc(arena, sizeof(struct Sentence_s));
+	return malloc(sizeof(struct Sentence_s));
+}
+
 /// ===========================================================================
 /// Sentence function definitions
 /// ===========================================================================
 
 Sentence Sentence_createAtomic(const char* var, const uint8_t negated)
 {
-	Sentence sentence = malloc(sizeof(struct Sentence_s));
+	return Sentence_createAtomicIn(NULL, var, negated);
+}
+
+Sentence Sentence_createCompound(
+	const SentenceOperator op,
+	const Sentence left,
+	const Sentence right,
+	const uint8_t negated)
+{
+	return Sentence_createCompoundIn(NULL, op, left, right, negated);
+}
+
+Sentence Sentence_createAtomicIn(
+	Arena arena,
+	const char* var,
+	const uint8_t negated)
+{
+	Sentence sentence = _allocate(arena);
 	sentence->type = ATOMIC;
 	sentence->op = NO_OP;
-	sentence->left.variable = malloc(strlen(var) + 1);
-	strcpy(sentence->left.variable, var);
+	sentence->id = Symbol_intern(var, strlen(var));
+	sentence->left.variable = (char*) Symbol_name(sentence->id);
 	sentence->right.variable = "\0";
 	sentence->negated = negated;
 
 	return sentence;
 }
 
-Sentence Sentence_createCompound(
+Sentence Sentence_createCompoundIn(
+	Arena arena,
 	const SentenceOperator op,
 	const Sentence left,
 	const Sentence right,
 	const uint8_t negated)
 {
-	Sentence sentence = malloc(sizeof(struct Sentence_s));
+	Sentence sentence = _allocate(arena);
 	sentence->type = COMPOUND;
 	sentence->op = op;
+	sentence->id = SYMBOL_NONE;
 	sentence->left.sentence = left;
 	sentence->right.sentence = right;
 	sentence->negated = negated;
@@ -62,7 +96,6 @@ Sentence Sentence_createCompound(
 
 void Sentence_free(Sentence sentence)
 {
-	if (sentence->type == ATOMIC) free(sentence->left.variable);
 	free(sentence);
 }
 
@@ -72,52 +105,50 @@ void Sentence_free(Sentence sentence)
 
 uint8_t Sentence_equals(const Sentence a, const Sentence b)
 {
-	// Check for type and operator
-	if (a->type != b->type || a->op != b->op || a->negated != b->negated)
-		return 0;
-
-	// Check for atomic sentences
-	else if (a->type == ATOMIC)
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(2 * buffer * sizeof(Sentence));
+	uint8_t equals = 1;
+	stack[size++] = a;
+	stack[size++] = b;
+
+	while (size > 0 && equals)
 	{
-		if (strcmp(a->left.variable, b->left.variable)!=0)
-			return 0;
-	}
-	else
-	{
-		// Check left sentence and right sentences
-		if (!Sentence_equals(a->left.sentence, b->left.sentence))
-			return 0;
-		if (!Sentence_equals(a->right.sentence, b->right.sentence))
-			return 0;
+		Sentence y = stack[--size];
+		Sentence x = stack[--size];
 
-	}
+		// Shared subsentences
+		if (x == y) continue;
 
-	return 1;
-}
+		// Check for type and operator
+		if (x->type != y->type || x->op != y->op || x->negated != y->negated)
+			equals = 0;
 
+		// Check for atomic sentences
+		else if (x->type == ATOMIC)
+			equals = x->id == y->id;
 
-void Sentence_print(const Sentence sentence)
-{
-	if (sentence->negated)
-	{
-		printf("~");
-		fflush(stdout);
+		// Check left sentence and right sentences
+		else
+		{
+			if (size + 4 > 2 * buffer)
+			{
+				buffer *= 2;
+				stack = realloc(stack, 2 * buffer * sizeof(Sentence));
+			}
+
+			stack[size++] = x->right.sentence;
+			stack[size++] = y->right.sentence;
+			stack[size++] = x->left.sentence;
+			stack[size++] = y->left.sentence;
+		}
 	}
 
-	if (sentence->type == ATOMIC)
-	{
-		printf("%s",sentence->left.variable);
-		fflush(stdout);
-		return;
-	}
+	free(stack);
+	return equals;
+}
 
-	else
-	{
-		printf("(");
-		Sentence_print(sentence->left.sentence);
-		printf(" %s ", SentenceOperator_toString(sentence->op));
-		Sentence_print(sentence->right.sentence);
-		printf(")");
-		fflush(stdout);
-	}
-}
\ No newline at end of file
+void Sentence_print(const Sentence sentence)
+{
+	Sentence_write(stdout, sentence, FORMAT_FULL);
+}
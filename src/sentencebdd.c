@@ -0,0 +1,1063 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencebdd.h.
+ *
+ * Nodes live in one array and are named by their index; 0 and 1 are the
+ * terminals. Each variable has its own unique table, chained through the
+ * nodes, so the nodes of one level can be found without a scan. Every
+ * operation is an if-then-else, cached in a direct-mapped table.
+ *
+ * Swapping two adjacent levels rewrites the nodes of the upper level in
+ * place, so a node keeps its index and its function while its variable
+ * and children change. Reordering needs to know when a node dies, so the
+ * number of references to each node is counted while it runs; the rest
+ * of the time only the handles held by the caller are counted, and dead
+ * nodes are found by marking from them.
+ */
+
+#include "sentencebdd.h"
+#include "sentencemap.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+// Variable of the terminals, and of nodes on the free list
+#define _TERMINAL UINT32_MAX
+#define _FREE (UINT32_MAX - 1)
+
+#define _CACHE_SIZE (1 << SENTENCEBDD_CACHE_BITS)
+
+/**
+ * next links the nodes of one unique table bucket, or the free list.
+ * low is the child where the variable is false.
+ */
+struct _Node
+{
+	uint32_t var;
+	uint32_t low;
+	uint32_t high;
+	uint32_t next;
+};
+
+/**
+ * Chains end at 0, which is never in a unique table.
+ */
+struct _Subtable
+{
+	uint32_t* buckets;
+	uint32_t size;
+	uint32_t count;
+};
+
+/**
+ * An entry with f of 0 is empty: if-then-else on a terminal is never
+ * cached.
+ */
+struct _CacheEntry
+{
+	uint32_t f;
+	uint32_t g;
+	uint32_t h;
+	uint32_t result;
+};
+
+/**
+ * refs counts the handles held by the caller. counts also counts the
+ * references from other nodes, and is only kept while counting is set.
+ * levels and order map variables to levels and back.
+ */
+struct SentenceBDDManager_s
+{
+	struct _Node* nodes;
+	uint32_t* refs;
+	uint32_t* counts;
+	uint32_t numNodes;
+	uint32_t maxNodes;
+	uint32_t freeList;
+	size_t live;
+	size_t collectAt;
+
+	uint32_t numVariables;
+	uint32_t maxVariables;
+	uint32_t* symbols;
+	uint32_t* levels;
+	uint32_t* order;
+	struct _Subtable* tables;
+
+	size_t numSymbols;
+	uint32_t* variables;
+
+	struct _CacheEntry* cache;
+
+	uint8_t counting;
+	uint8_t autoReorder;
+	size_t reorderAt;
+};
+
+/// ===========================================================================
+/// Static functions - Nodes
+/// ===========================================================================
+
+static uint32_t _hash(uint32_t low, uint32_t high)
+{
+	return low * 12582917u ^ high * 4256249u;
+}
+
+static uint32_t _level(const SentenceBDDManager m, uint32_t node)
+{
+	uint32_t var = m->nodes[node].var;
+	return var == _TERMINAL ? m->numVariables : m->levels[var];
+}
+
+static uint32_t _allocate(SentenceBDDManager m)
+{
+	uint32_t id = m->freeList;
+
+	if (id != 0)
+	{
+		m->freeList = m->nodes[id].next;
+	}
+	else
+	{
+		if (m->numNodes == m->maxNodes)
+		{
+			m->maxNodes *= 2;
+			m->nodes = realloc(m->nodes, m->maxNodes * sizeof(struct _Node));
+			m->refs = realloc(m->refs, m->maxNodes * sizeof(uint32_t));
+			m->counts = realloc(m->counts, m->maxNodes * sizeof(uint32_t));
+		}
+
+		id = m->numNodes++;
+	}
+
+	m->refs[id] = 0;
+	m->counts[id] = 0;
+	m->live++;
+	return id;
+}
+
+static void _resize(SentenceBDDManager m, struct _Subtable* t)
+{
+	uint32_t size = t->size * 2;
+	uint32_t* buckets = calloc(size, sizeof(uint32_t));
+
+	for (uint32_t n = 0; n < t->size; n++)
+	{
+		uint32_t id = t->buckets[n];
+
+		while (id != 0)
+		{
+			struct _Node* node = &m->nodes[id];
+			uint32_t next = node->next;
+			uint32_t slot = _hash(node->low, node->high) & (size - 1);
+			node->next = buckets[slot];
+			buckets[slot] = id;
+			id = next;
+		}
+	}
+
+	free(t->buckets);
+	t->buckets = buckets;
+	t->size = size;
+}
+
+/**
+ * Puts a node into the unique table of its variable.
+ */
+static void _insert(SentenceBDDManager m, uint32_t id)
+{
+	struct _Node* node = &m->nodes[id];
+	struct _Subtable* t = &m->tables[node->var];
+	uint32_t slot = _hash(node->low, node->high) & (t->size - 1);
+	node->next = t->buckets[slot];
+	t->buckets[slot] = id;
+	if (++t->count > t->size) _resize(m, t);
+}
+
+/**
+ * Takes a node out of its unique table and puts it on the free list.
+ */
+static void _release(SentenceBDDManager m, uint32_t id)
+{
+	struct _Node* node = &m->nodes[id];
+	struct _Subtable* t = &m->tables[node->var];
+	uint32_t* link = &t->buckets[_hash(node->low, node->high) & (t->size - 1)];
+
+	while (*link != id) link = &m->nodes[*link].next;
+	*link = node->next;
+	t->count--;
+
+	node->var = _FREE;
+	node->next = m->freeList;
+	m->freeList = id;
+	m->live--;
+}
+
+/**
+ * Returns the node with the variable and children, creating it if it
+ * does not exist.
+ */
+static uint32_t _make(
+	SentenceBDDManager m,
+	uint32_t var,
+	uint32_t low,
+	uint32_t high)
+{
+	if (low == high) return low;
+
+	struct _Subtable* t = &m->tables[var];
+	uint32_t slot = _hash(low, high) & (t->size - 1);
+
+	for (uint32_t id = t->buckets[slot]; id != 0; id = m->nodes[id].next)
+	{
+		if (m->nodes[id].low == low && m->nodes[id].high == high) return id;
+	}
+
+	uint32_t id = _allocate(m);
+	struct _Node* node = &m->nodes[id];
+	node->var = var;
+	node->low = low;
+	node->high = high;
+	_insert(m, id);
+
+	if (m->counting)
+	{
+		m->counts[low]++;
+		m->counts[high]++;
+	}
+
+	return id;
+}
+
+/**
+ * Returns the variable of a symbol, creating it below the others if it
+ * does not exist.
+ */
+static uint32_t _variable(SentenceBDDManager m, uint32_t symbol)
+{
+	if (symbol >= m->numSymbols)
+	{
+		size_t old = m->numSymbols;
+		m->numSymbols = Symbol_count() > symbol ? Symbol_count() : symbol + 1;
+		m->variables = realloc(m->variables, m->numSymbols * sizeof(uint32_t));
+		memset(m->variables + old, 0, (m->numSymbols - old) * sizeof(uint32_t));
+	}
+
+	if (m->variables[symbol] != 0) return m->variables[symbol] - 1;
+
+	if (m->numVariables == m->maxVariables)
+	{
+		m->maxVariables *= 2;
+		m->symbols = realloc(m->symbols, m->maxVariables * sizeof(uint32_t));
+		m->levels = realloc(m->levels, m->maxVariables * sizeof(uint32_t));
+		m->order = realloc(m->order, m->maxVariables * sizeof(uint32_t));
+		m->tables = realloc(m->tables,
+			m->maxVariables * sizeof(struct _Subtable));
+	}
+
+	uint32_t var = m->numVariables++;
+	m->symbols[var] = symbol;
+	m->levels[var] = var;
+	m->order[var] = var;
+	m->tables[var].size = 16;
+	m->tables[var].count = 0;
+	m->tables[var].buckets = calloc(16, sizeof(uint32_t));
+	m->variables[symbol] = var + 1;
+	return var;
+}
+
+/// ===========================================================================
+/// Static functions - Operations
+/// ===========================================================================
+
+static void _cofactors(
+	const SentenceBDDManager m,
+	uint32_t f,
+	uint32_t var,
+	uint32_t* low,
+	uint32_t* high)
+{
+	if (m->nodes[f].var == var)
+	{
+		*low = m->nodes[f].low;
+		*high = m->nodes[f].high;
+	}
+	else
+	{
+		*low = f;
+		*high = f;
+	}
+}
+
+/**
+ * If-then-else. The recursion is as deep as the number of variables.
+ */
+static uint32_t _ite(SentenceBDDManager m, uint32_t f, uint32_t g, uint32_t h)
+{
+	if (f == SENTENCEBDD_TRUE) return g;
+	if (f == SENTENCEBDD_FALSE) return h;
+	if (g == f) g = SENTENCEBDD_TRUE;
+	if (h == f) h = SENTENCEBDD_FALSE;
+	if (g == h) return g;
+	if (g == SENTENCEBDD_TRUE && h == SENTENCEBDD_FALSE) return f;
+
+	uint32_t slot = (f * 12582917u ^ g * 4256249u ^ h * 741457u)
+		& (_CACHE_SIZE - 1);
+	struct _CacheEntry* entry = &m->cache[slot];
+	if (entry->f == f && entry->g == g && entry->h == h) return entry->result;
+
+	uint32_t top = _level(m, f);
+	if (_level(m, g) < top) top = _level(m, g);
+	if (_level(m, h) < top) top = _level(m, h);
+	uint32_t var = m->order[top];
+
+	uint32_t f0, f1, g0, g1, h0, h1;
+	_cofactors(m, f, var, &f0, &f1);
+	_cofactors(m, g, var, &g0, &g1);
+	_cofactors(m, h, var, &h0, &h1);
+
+	uint32_t high = _ite(m, f1, g1, h1);
+	uint32_t low = _ite(m, f0, g0, h0);
+	uint32_t result = _make(m, var, low, high);
+
+	entry = &m->cache[slot];
+	entry->f = f;
+	entry->g = g;
+	entry->h = h;
+	entry->result = result;
+	return result;
+}
+
+static uint32_t _not(SentenceBDDManager m, uint32_t f)
+{
+	return _ite(m, f, SENTENCEBDD_FALSE, SENTENCEBDD_TRUE);
+}
+
+static uint32_t _apply(
+	SentenceBDDManager m,
+	SentenceOperator op,
+	uint32_t f,
+	uint32_t g)
+{
+	switch (op)
+	{
+		case AND: return _ite(m, f, g, SENTENCEBDD_FALSE);
+		case OR: return _ite(m, f, SENTENCEBDD_TRUE, g);
+		case MATERIAL_CONDITIONAL: return _ite(m, f, g, SENTENCEBDD_TRUE);
+		default: return _ite(m, f, g, _not(m, g));
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Reordering
+/// ===========================================================================
+
+/**
+ * Drops one reference to a node, freeing it and its descendants when no
+ * references are left.
+ */
+static void _deref(SentenceBDDManager m, uint32_t id)
+{
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	uint32_t* stack = malloc(buffer * sizeof(uint32_t));
+	stack[size++] = id;
+
+	while (size > 0)
+	{
+		uint32_t node = stack[--size];
+		if (node <= SENTENCEBDD_TRUE || --m->counts[node] > 0) continue;
+
+		if (size + 2 > buffer)
+		{
+			buffer *= 2;
+			stack = realloc(stack, buffer * sizeof(uint32_t));
+		}
+
+		stack[size++] = m->nodes[node].low;
+		stack[size++] = m->nodes[node].high;
+		_release(m, node);
+	}
+
+	free(stack);
+}
+
+/**
+ * Collects, then counts the references to every node.
+ */
+static void _startCounting(SentenceBDDManager m)
+{
+	SentenceBDDManager_collect(m);
+	memset(m->counts, 0, m->numNodes * sizeof(uint32_t));
+
+	for (uint32_t n = SENTENCEBDD_TRUE + 1; n < m->numNodes; n++)
+	{
+		if (m->nodes[n].var == _FREE) continue;
+		m->counts[n] += m->refs[n];
+		m->counts[m->nodes[n].low]++;
+		m->counts[m->nodes[n].high]++;
+	}
+
+	m->counting = 1;
+}
+
+static void _stopCounting(SentenceBDDManager m)
+{
+	m->counting = 0;
+	memset(m->cache, 0, _CACHE_SIZE * sizeof(struct _CacheEntry));
+}
+
+/**
+ * Exchanges the variables at a level and the level below it.
+ */
+static void _swap(SentenceBDDManager m, uint32_t level)
+{
+	uint32_t x = m->order[level];
+	uint32_t y = m->order[level + 1];
+	struct _Subtable* t = &m->tables[x];
+
+	uint32_t* nodes = malloc((t->count + 1) * sizeof(uint32_t));
+	size_t numNodes = 0;
+
+	for (uint32_t n = 0; n < t->size; n++)
+	{
+		for (uint32_t id = t->buckets[n]; id != 0; id = m->nodes[id].next)
+		{
+			nodes[numNodes++] = id;
+		}
+	}
+
+	memset(t->buckets, 0, t->size * sizeof(uint32_t));
+	t->count = 0;
+
+	// Nodes that do not test y just move down a level
+	size_t moved = 0;
+	for (size_t n = 0; n < numNodes; n++)
+	{
+		struct _Node* node = &m->nodes[nodes[n]];
+		if (m->nodes[node->low].var != y && m->nodes[node->high].var != y)
+			_insert(m, nodes[n]);
+		else
+			nodes[moved++] = nodes[n];
+	}
+
+	// The rest test y first: f = y ? (x ? f11 : f01) : (x ? f10 : f00)
+	for (size_t n = 0; n < moved; n++)
+	{
+		uint32_t id = nodes[n];
+		uint32_t f0 = m->nodes[id].low;
+		uint32_t f1 = m->nodes[id].high;
+
+		uint32_t f00, f01, f10, f11;
+		_cofactors(m, f0, y, &f00, &f01);
+		_cofactors(m, f1, y, &f10, &f11);
+
+		uint32_t high = _make(m, x, f01, f11);
+		uint32_t low = _make(m, x, f00, f10);
+		m->counts[high]++;
+		m->counts[low]++;
+
+		struct _Node* node = &m->nodes[id];
+		node->var = y;
+		node->low = low;
+		node->high = high;
+		_insert(m, id);
+
+		_deref(m, f0);
+		_deref(m, f1);
+	}
+
+	free(nodes);
+
+	m->order[level] = y;
+	m->order[level + 1] = x;
+	m->levels[y] = level;
+	m->levels[x] = level + 1;
+}
+
+static void _moveTo(SentenceBDDManager m, uint32_t var, uint32_t level)
+{
+	while (m->levels[var] < level) _swap(m, m->levels[var]);
+	while (m->levels[var] > level) _swap(m, m->levels[var] - 1);
+}
+
+/**
+ * Moves the variable down to the bottom and up to the top, stopping
+ * early in either direction when the manager grows too much, then
+ * leaves it at the level where the manager was smallest.
+ */
+static void _sift(SentenceBDDManager m, uint32_t var)
+{
+	size_t best = m->live;
+	uint32_t bestLevel = m->levels[var];
+
+	while (m->levels[var] + 1 < m->numVariables)
+	{
+		_swap(m, m->levels[var]);
+		if (m->live < best)
+		{
+			best = m->live;
+			bestLevel = m->levels[var];
+		}
+		if (m->live > best * SENTENCEBDD_MAX_GROWTH) break;
+	}
+
+	while (m->levels[var] > 0)
+	{
+		_swap(m, m->levels[var] - 1);
+		if (m->live < best)
+		{
+			best = m->live;
+			bestLevel = m->levels[var];
+		}
+		if (m->live > best * SENTENCEBDD_MAX_GROWTH) break;
+	}
+
+	_moveTo(m, var, bestLevel);
+}
+
+struct _Rank
+{
+	uint32_t count;
+	uint32_t var;
+};
+
+static int _compareRanks(const void* a, const void* b)
+{
+	uint32_t x = ((const struct _Rank*) a)->count;
+	uint32_t y = ((const struct _Rank*) b)->count;
+	return (x < y) - (x > y);
+}
+
+/**
+ * Collects or reorders if the manager has grown enough since the last
+ * time. Only called between operations, when every node that must be
+ * kept is reached from a held handle.
+ */
+static void _maintain(SentenceBDDManager m)
+{
+	if (m->autoReorder && m->live >= m->reorderAt)
+	{
+		SentenceBDDManager_reorder(m);
+		m->reorderAt = 2 * m->live > SENTENCEBDD_MIN_NODES
+			? 2 * m->live : SENTENCEBDD_MIN_NODES;
+	}
+	else if (m->live >= m->collectAt)
+	{
+		SentenceBDDManager_collect(m);
+	}
+}
+
+static SentenceBDD _hold(SentenceBDDManager m, uint32_t f)
+{
+	m->refs[f]++;
+	return f;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceBDDManager SentenceBDDManager_create()
+{
+	SentenceBDDManager m = malloc(sizeof(struct SentenceBDDManager_s));
+
+	m->maxNodes = 1024;
+	m->nodes = malloc(m->maxNodes * sizeof(struct _Node));
+	m->refs = calloc(m->maxNodes, sizeof(uint32_t));
+	m->counts = calloc(m->maxNodes, sizeof(uint32_t));
+	m->numNodes = 2;
+	m->freeList = 0;
+	m->live = 0;
+	m->collectAt = SENTENCEBDD_MIN_NODES;
+
+	for (uint32_t n = 0; n < 2; n++)
+	{
+		m->nodes[n].var = _TERMINAL;
+		m->nodes[n].low = n;
+		m->nodes[n].high = n;
+		m->nodes[n].next = 0;
+	}
+
+	m->numVariables = 0;
+	m->maxVariables = SENTENCESET_BUFFER;
+	m->symbols = malloc(m->maxVariables * sizeof(uint32_t));
+	m->levels = malloc(m->maxVariables * sizeof(uint32_t));
+	m->order = malloc(m->maxVariables * sizeof(uint32_t));
+	m->tables = malloc(m->maxVariables * sizeof(struct _Subtable));
+	m->numSymbols = 0;
+	m->variables = NULL;
+
+	m->cache = calloc(_CACHE_SIZE, sizeof(struct _CacheEntry));
+	m->counting = 0;
+	m->autoReorder = 0;
+	m->reorderAt = SENTENCEBDD_MIN_NODES;
+	return m;
+}
+
+SentenceBDD SentenceBDD_fromSentence(
+	SentenceBDDManager manager,
+	const Sentence sentence)
+{
+	_maintain(manager);
+
+	// Every finished node holds its BDD until the end, so the manager
+	// can collect and reorder between nodes
+	SentenceMap done = SentenceMap_create();
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	Sentence* finished = malloc(buffer * sizeof(Sentence));
+	size_t numFinished = 0;
+	size_t maxFinished = buffer;
+	stack[size++] = sentence;
+
+	while (size > 0)
+	{
+		Sentence s = stack[size-1];
+
+		if (SentenceMap_get(done, s, NULL))
+		{
+			size--;
+			continue;
+		}
+
+		void* left = NULL;
+		void* right = NULL;
+		uint32_t f;
+
+		if (s->type == ATOMIC)
+		{
+			uint32_t var = _variable(manager, s->id);
+			f = _make(manager, var, SENTENCEBDD_FALSE, SENTENCEBDD_TRUE);
+		}
+		else
+		{
+			uint8_t hasLeft = SentenceMap_get(done, s->left.sentence, &left);
+			uint8_t hasRight = SentenceMap_get(done, s->right.sentence, &right);
+
+			if (!hasLeft || !hasRight)
+			{
+				if (size + 2 > buffer)
+				{
+					buffer *= 2;
+					stack = realloc(stack, buffer * sizeof(Sentence));
+				}
+
+				if (!hasRight) stack[size++] = s->right.sentence;
+				if (!hasLeft) stack[size++] = s->left.sentence;
+				continue;
+			}
+
+			_maintain(manager);
+			f = _apply(manager, s->op,
+				(uint32_t)(uintptr_t) left - 1, (uint32_t)(uintptr_t) right - 1);
+		}
+
+		if (s->negated) f = _not(manager, f);
+		SentenceMap_put(done, s, (void*)(uintptr_t)(_hold(manager, f) + 1));
+
+		if (numFinished == maxFinished)
+		{
+			maxFinished *= 2;
+			finished = realloc(finished, maxFinished * sizeof(Sentence));
+		}
+
+		finished[numFinished++] = s;
+		size--;
+	}
+
+	void* result = NULL;
+	SentenceMap_get(done, sentence, &result);
+	SentenceBDD bdd = _hold(manager, (uint32_t)(uintptr_t) result - 1);
+
+	for (size_t n = 0; n < numFinished; n++)
+	{
+		SentenceMap_get(done, finished[n], &result);
+		SentenceBDD_release(manager, (uint32_t)(uintptr_t) result - 1);
+	}
+
+	free(finished);
+	free(stack);
+	SentenceMap_free(done);
+	return bdd;
+}
+
+SentenceBDD SentenceBDD_fromSentences(
+	SentenceBDDManager manager,
+	const Sentence* sentences,
+	const size_t numSentences)
+{
+	SentenceBDD bdd = _hold(manager, SENTENCEBDD_TRUE);
+
+	for (size_t n = 0; n < numSentences; n++)
+	{
+		SentenceBDD f = SentenceBDD_fromSentence(manager, sentences[n]);
+		SentenceBDD conjunction = SentenceBDD_apply(manager, AND, bdd, f);
+		SentenceBDD_release(manager, f);
+		SentenceBDD_release(manager, bdd);
+		bdd = conjunction;
+	}
+
+	return bdd;
+}
+
+SentenceBDD SentenceBDD_fromSet(
+	SentenceBDDManager manager,
+	const SentenceSet set)
+{
+	return SentenceBDD_fromSentences(manager, set->added, set->addedCount);
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceBDDManager_free(SentenceBDDManager manager)
+{
+	for (uint32_t n = 0; n < manager->numVariables; n++)
+	{
+		free(manager->tables[n].buckets);
+	}
+
+	free(manager->cache);
+	free(manager->variables);
+	free(manager->tables);
+	free(manager->order);
+	free(manager->levels);
+	free(manager->symbols);
+	free(manager->counts);
+	free(manager->refs);
+	free(manager->nodes);
+	free(manager);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+uint32_t SentenceBDDManager_level(
+	const SentenceBDDManager manager,
+	const uint32_t symbol)
+{
+	if (symbol >= manager->numSymbols || manager->variables[symbol] == 0)
+		return UINT32_MAX;
+	return manager->levels[manager->variables[symbol] - 1];
+}
+
+size_t SentenceBDDManager_size(const SentenceBDDManager manager)
+{
+	return manager->live;
+}
+
+void SentenceBDDManager_setAutoReorder(
+	SentenceBDDManager manager,
+	const uint8_t enabled)
+{
+	manager->autoReorder = enabled;
+}
+
+void SentenceBDDManager_setOrder(
+	SentenceBDDManager manager,
+	const uint32_t* symbols,
+	const size_t numSymbols)
+{
+	for (size_t n = 0; n < numSymbols; n++) _variable(manager, symbols[n]);
+
+	_startCounting(manager);
+	for (size_t n = 0; n < numSymbols; n++)
+	{
+		_moveTo(manager, manager->variables[symbols[n]] - 1, n);
+	}
+	_stopCounting(manager);
+}
+
+void SentenceBDD_ref(SentenceBDDManager manager, const SentenceBDD bdd)
+{
+	manager->refs[bdd]++;
+}
+
+void SentenceBDD_release(SentenceBDDManager manager, const SentenceBDD bdd)
+{
+	if (manager->refs[bdd] > 0) manager->refs[bdd]--;
+}
+
+/// ===========================================================================
+/// Function definitions - Operations
+/// ===========================================================================
+
+SentenceBDD SentenceBDD_variable(
+	SentenceBDDManager manager,
+	const uint32_t symbol,
+	const uint8_t negated)
+{
+	uint32_t var = _variable(manager, symbol);
+	return _hold(manager, negated
+		? _make(manager, var, SENTENCEBDD_TRUE, SENTENCEBDD_FALSE)
+		: _make(manager, var, SENTENCEBDD_FALSE, SENTENCEBDD_TRUE));
+}
+
+SentenceBDD SentenceBDD_not(SentenceBDDManager manager, const SentenceBDD f)
+{
+	_maintain(manager);
+	return _hold(manager, _not(manager, f));
+}
+
+SentenceBDD SentenceBDD_apply(
+	SentenceBDDManager manager,
+	const SentenceOperator op,
+	const SentenceBDD f,
+	const SentenceBDD g)
+{
+	_maintain(manager);
+	return _hold(manager, _apply(manager, op, f, g));
+}
+
+SentenceBDD SentenceBDD_ite(
+	SentenceBDDManager manager,
+	const SentenceBDD f,
+	const SentenceBDD g,
+	const SentenceBDD h)
+{
+	_maintain(manager);
+	return _hold(manager, _ite(manager, f, g, h));
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+uint8_t SentenceBDD_isSatisfiable(
+	const SentenceBDDManager manager,
+	const SentenceBDD f,
+	uint8_t* values)
+{
+	if (f == SENTENCEBDD_FALSE) return 0;
+	if (values == NULL) return 1;
+
+	for (uint32_t n = 0; n < manager->numVariables; n++)
+	{
+		values[manager->symbols[n]] = 0;
+	}
+
+	// Every node but the false terminal has a path to the true terminal
+	for (uint32_t node = f; node != SENTENCEBDD_TRUE; )
+	{
+		const struct _Node* n = &manager->nodes[node];
+		uint8_t high = n->high != SENTENCEBDD_FALSE;
+		values[manager->symbols[n->var]] = high;
+		node = high ? n->high : n->low;
+	}
+
+	return 1;
+}
+
+uint8_t SentenceBDD_isTautology(
+	const SentenceBDDManager manager,
+	const SentenceBDD f)
+{
+	(void) manager;
+	return f == SENTENCEBDD_TRUE;
+}
+
+/**
+ * Multiplies the count by 2^shift.
+ */
+static uint64_t _shift(uint64_t count, uint32_t shift)
+{
+	if (count == 0) return 0;
+	if (shift >= 64 || count > (UINT64_MAX >> shift)) return UINT64_MAX;
+	return count << shift;
+}
+
+static uint64_t _add(uint64_t a, uint64_t b)
+{
+	return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+}
+
+uint64_t SentenceBDD_countModels(
+	const SentenceBDDManager manager,
+	const SentenceBDD f)
+{
+	const SentenceBDDManager m = manager;
+	uint64_t* counts = malloc(m->numNodes * sizeof(uint64_t));
+	uint8_t* done = calloc(m->numNodes, 1);
+	counts[SENTENCEBDD_FALSE] = 0;
+	counts[SENTENCEBDD_TRUE] = 1;
+	done[SENTENCEBDD_FALSE] = 1;
+	done[SENTENCEBDD_TRUE] = 1;
+
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	uint32_t* stack = malloc(buffer * sizeof(uint32_t));
+	stack[size++] = f;
+
+	// A child more than one level down skips variables that may take
+	// either value
+	while (size > 0)
+	{
+		uint32_t node = stack[size-1];
+		if (done[node])
+		{
+			size--;
+			continue;
+		}
+
+		uint32_t low = m->nodes[node].low;
+		uint32_t high = m->nodes[node].high;
+
+		if (!done[low] || !done[high])
+		{
+			if (size + 2 > buffer)
+			{
+				buffer *= 2;
+				stack = realloc(stack, buffer * sizeof(uint32_t));
+			}
+
+			if (!done[low]) stack[size++] = low;
+			if (!done[high]) stack[size++] = high;
+			continue;
+		}
+
+		uint32_t level = _level(m, node);
+		counts[node] = _add(
+			_shift(counts[low], _level(m, low) - level - 1),
+			_shift(counts[high], _level(m, high) - level - 1));
+		done[node] = 1;
+		size--;
+	}
+
+	uint64_t count = _shift(counts[f], _level(m, f));
+	free(stack);
+	free(done);
+	free(counts);
+	return count;
+}
+
+size_t SentenceBDD_size(const SentenceBDDManager manager, const SentenceBDD f)
+{
+	uint8_t* seen = calloc(manager->numNodes, 1);
+	size_t count = 0;
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	uint32_t* stack = malloc(buffer * sizeof(uint32_t));
+	stack[size++] = f;
+
+	while (size > 0)
+	{
+		uint32_t node = stack[--size];
+		if (seen[node]) continue;
+		seen[node] = 1;
+		count++;
+		if (node <= SENTENCEBDD_TRUE) continue;
+
+		if (size + 2 > buffer)
+		{
+			buffer *= 2;
+			stack = realloc(stack, buffer * sizeof(uint32_t));
+		}
+
+		stack[size++] = manager->nodes[node].low;
+		stack[size++] = manager->nodes[node].high;
+	}
+
+	free(stack);
+	free(seen);
+	return count;
+}
+
+void SentenceBDDManager_collect(SentenceBDDManager manager)
+{
+	SentenceBDDManager m = manager;
+	uint8_t* marks = calloc(m->numNodes, 1);
+	marks[SENTENCEBDD_FALSE] = 1;
+	marks[SENTENCEBDD_TRUE] = 1;
+
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	uint32_t* stack = malloc(buffer * sizeof(uint32_t));
+
+	for (uint32_t n = SENTENCEBDD_TRUE + 1; n < m->numNodes; n++)
+	{
+		if (m->refs[n] == 0 || m->nodes[n].var == _FREE) continue;
+		stack[size++] = n;
+
+		while (size > 0)
+		{
+			uint32_t node = stack[--size];
+			if (marks[node]) continue;
+			marks[node] = 1;
+
+			if (size + 2 > buffer)
+			{
+				buffer *= 2;
+				stack = realloc(stack, buffer * sizeof(uint32_t));
+			}
+
+			stack[size++] = m->nodes[node].low;
+			stack[size++] = m->nodes[node].high;
+		}
+	}
+
+	for (uint32_t var = 0; var < m->numVariables; var++)
+	{
+		struct _Subtable* t = &m->tables[var];
+
+		for (uint32_t slot = 0; slot < t->size; slot++)
+		{
+			uint32_t* link = &t->buckets[slot];
+
+			while (*link != 0)
+			{
+				uint32_t id = *link;
+				struct _Node* node = &m->nodes[id];
+
+				if (marks[id])
+				{
+					link = &node->next;
+					continue;
+				}
+
+				*link = node->next;
+				t->count--;
+				node->var = _FREE;
+				node->next = m->freeList;
+				m->freeList = id;
+				m->live--;
+			}
+		}
+	}
+
+	free(stack);
+	free(marks);
+
+	memset(m->cache, 0, _CACHE_SIZE * sizeof(struct _CacheEntry));
+	m->collectAt = 2 * m->live > SENTENCEBDD_MIN_NODES
+		? 2 * m->live : SENTENCEBDD_MIN_NODES;
+}
+
+void SentenceBDDManager_reorder(SentenceBDDManager manager)
+{
+	if (manager->numVariables < 2) return;
+	_startCounting(manager);
+
+	struct _Rank* ranks = malloc(manager->numVariables * sizeof(struct _Rank));
+	for (uint32_t n = 0; n < manager->numVariables; n++)
+	{
+		ranks[n].count = manager->tables[n].count;
+		ranks[n].var = n;
+	}
+
+	qsort(ranks, manager->numVariables, sizeof(struct _Rank), _compareRanks);
+	for (uint32_t n = 0; n < manager->numVariables; n++)
+	{
+		_sift(manager, ranks[n].var);
+	}
+
+	free(ranks);
+	_stopCounting(manager);
+}
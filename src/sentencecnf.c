@@ -0,0 +1,248 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencecnf.h.
+ *
+ * A compound sentence x = (l op r) is defined by the clauses of x <-> (l
+ * op r), where l and r are the literals of its children. The negation
+ * flag costs nothing: a negated sentence is the negated literal of x.
+ */
+
+#include "sentencecnf.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+static void _clause3(SentenceCNF cnf, uint32_t a, uint32_t b, uint32_t c)
+{
+	uint32_t literals[3] = {a, b, c};
+	SentenceCNF_addClause(cnf, literals, 3);
+}
+
+static void _clause2(SentenceCNF cnf, uint32_t a, uint32_t b)
+{
+	uint32_t literals[2] = {a, b};
+	SentenceCNF_addClause(cnf, literals, 2);
+}
+
+/**
+ * Adds the clauses of x <-> (l op r).
+ */
+static void _define(
+	SentenceCNF cnf,
+	SentenceOperator op,
+	uint32_t x,
+	uint32_t l,
+	uint32_t r)
+{
+	uint32_t nx = CNF_NEGATE(x);
+	uint32_t nl = CNF_NEGATE(l);
+	uint32_t nr = CNF_NEGATE(r);
+
+	switch (op)
+	{
+		case AND:
+			_clause2(cnf, nx, l);
+			_clause2(cnf, nx, r);
+			_clause3(cnf, x, nl, nr);
+			break;
+		case OR:
+			_clause2(cnf, x, nl);
+			_clause2(cnf, x, nr);
+			_clause3(cnf, nx, l, r);
+			break;
+		case MATERIAL_CONDITIONAL:
+			_clause2(cnf, x, l);
+			_clause2(cnf, x, nr);
+			_clause3(cnf, nx, nl, r);
+			break;
+		default:
+			_clause3(cnf, nx, nl, r);
+			_clause3(cnf, nx, l, nr);
+			_clause3(cnf, x, l, r);
+			_clause3(cnf, x, nl, nr);
+			break;
+	}
+}
+
+/**
+ * Returns the literal of a node whose children are encoded.
+ */
+static uint32_t _encodeNode(SentenceCNF cnf, const Sentence s)
+{
+	if (s->type == ATOMIC)
+	{
+		return CNF_LITERAL(SentenceCNF_variable(cnf, s->id), s->negated);
+	}
+
+	void* left = NULL;
+	void* right = NULL;
+	SentenceMap_get(cnf->encoded, s->left.sentence, &left);
+	SentenceMap_get(cnf->encoded, s->right.sentence, &right);
+
+	uint32_t x = CNF_LITERAL(SentenceCNF_newVariable(cnf, SYMBOL_NONE), 0);
+	_define(cnf, s->op, x,
+		(uint32_t)(uintptr_t) left - 1, (uint32_t)(uintptr_t) right - 1);
+	return s->negated ? CNF_NEGATE(x) : x;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceCNF SentenceCNF_create()
+{
+	SentenceCNF cnf = malloc(sizeof(struct SentenceCNF_s));
+	cnf->numVariables = 0;
+	cnf->maxVariables = SENTENCESET_BUFFER;
+	cnf->symbols = malloc(cnf->maxVariables * sizeof(uint32_t));
+
+	cnf->numLiterals = 0;
+	cnf->maxLiterals = SENTENCESET_BUFFER;
+	cnf->literals = malloc(cnf->maxLiterals * sizeof(uint32_t));
+
+	cnf->numClauses = 0;
+	cnf->maxClauses = SENTENCESET_BUFFER;
+	cnf->clauses = malloc((cnf->maxClauses + 1) * sizeof(size_t));
+	cnf->clauses[0] = 0;
+
+	cnf->numSymbols = 0;
+	cnf->variables = NULL;
+	cnf->encoded = SentenceMap_create();
+	return cnf;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceCNF_free(SentenceCNF cnf)
+{
+	SentenceMap_free(cnf->encoded);
+	free(cnf->variables);
+	free(cnf->clauses);
+	free(cnf->literals);
+	free(cnf->symbols);
+	free(cnf);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+uint32_t SentenceCNF_newVariable(SentenceCNF cnf, const uint32_t symbol)
+{
+	if (cnf->numVariables == cnf->maxVariables)
+	{
+		cnf->maxVariables *= 2;
+		cnf->symbols = realloc(cnf->symbols,
+			cnf->maxVariables * sizeof(uint32_t));
+	}
+
+	cnf->symbols[cnf->numVariables] = symbol;
+	return cnf->numVariables++;
+}
+
+uint32_t SentenceCNF_variable(SentenceCNF cnf, const uint32_t symbol)
+{
+	if (symbol >= cnf->numSymbols)
+	{
+		size_t old = cnf->numSymbols;
+		cnf->numSymbols = Symbol_count() > symbol ? Symbol_count() : symbol + 1;
+		cnf->variables = realloc(cnf->variables,
+			cnf->numSymbols * sizeof(uint32_t));
+		memset(cnf->variables + old, 0,
+			(cnf->numSymbols - old) * sizeof(uint32_t));
+	}
+
+	if (cnf->variables[symbol] == 0)
+	{
+		cnf->variables[symbol] = SentenceCNF_newVariable(cnf, symbol) + 1;
+	}
+
+	return cnf->variables[symbol] - 1;
+}
+
+void SentenceCNF_addClause(
+	SentenceCNF cnf,
+	const uint32_t* literals,
+	const size_t size)
+{
+	if (cnf->numLiterals + size > cnf->maxLiterals)
+	{
+		while (cnf->numLiterals + size > cnf->maxLiterals)
+			cnf->maxLiterals *= 2;
+		cnf->literals = realloc(cnf->literals,
+			cnf->maxLiterals * sizeof(uint32_t));
+	}
+
+	if (cnf->numClauses == cnf->maxClauses)
+	{
+		cnf->maxClauses *= 2;
+		cnf->clauses = realloc(cnf->clauses,
+			(cnf->maxClauses + 1) * sizeof(size_t));
+	}
+
+	memcpy(cnf->literals + cnf->numLiterals, literals,
+		size * sizeof(uint32_t));
+	cnf->numLiterals += size;
+	cnf->clauses[++cnf->numClauses] = cnf->numLiterals;
+}
+
+uint32_t SentenceCNF_encode(SentenceCNF cnf, const Sentence sentence)
+{
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	stack[size++] = sentence;
+
+	while (size > 0)
+	{
+		Sentence s = stack[size-1];
+
+		if (SentenceMap_get(cnf->encoded, s, NULL))
+		{
+			size--;
+			continue;
+		}
+
+		if (s->type == COMPOUND)
+		{
+			uint8_t hasLeft = SentenceMap_get(cnf->encoded,
+				s->left.sentence, NULL);
+			uint8_t hasRight = SentenceMap_get(cnf->encoded,
+				s->right.sentence, NULL);
+
+			if (!hasLeft || !hasRight)
+			{
+				if (size + 2 > buffer)
+				{
+					buffer *= 2;
+					stack = realloc(stack, buffer * sizeof(Sentence));
+				}
+
+				if (!hasRight) stack[size++] = s->right.sentence;
+				if (!hasLeft) stack[size++] = s->left.sentence;
+				continue;
+			}
+		}
+
+		uint32_t literal = _encodeNode(cnf, s);
+		SentenceMap_put(cnf->encoded, s, (void*)(uintptr_t)(literal + 1));
+		size--;
+	}
+
+	free(stack);
+	void* literal = NULL;
+	SentenceMap_get(cnf->encoded, sentence, &literal);
+	return (uint32_t)(uintptr_t) literal - 1;
+}
+
+void SentenceCNF_assert(SentenceCNF cnf, const Sentence sentence)
+{
+	uint32_t literal = SentenceCNF_encode(cnf, sentence);
+	SentenceCNF_addClause(cnf, &literal, 1);
+}
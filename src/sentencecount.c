@@ -0,0 +1,911 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencecount.h.
+ *
+ * The Tseitin encoding defines every new variable as a function of the
+ * sentence's own variables, so each model of the sentences extends to
+ * exactly one model of the clauses, and counting the clauses counts the
+ * sentences.
+ *
+ * A component is keyed by its unassigned variables and its unsatisfied
+ * clauses, both sorted. Together they fix what is left of the clauses,
+ * since every other literal of an unsatisfied clause is false, so the
+ * same key always has the same count wherever it turns up in the search.
+ *
+ * A variable defined by the encoding takes one value for every assignment
+ * of its children, so once no live clause outside its definition uses it,
+ * the definition only links its children and is dropped. Without this the
+ * definitions of satisfied subsentences would keep components joined.
+ */
+
+#include "sentencecount.h"
+#include "sentencecnf.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Static functions - Arithmetic
+/// ===========================================================================
+
+static uint64_t _add(uint64_t a, uint64_t b)
+{
+	return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+}
+
+static uint64_t _multiply(uint64_t a, uint64_t b)
+{
+	if (a == 0 || b == 0) return 0;
+	return a > UINT64_MAX / b ? UINT64_MAX : a * b;
+}
+
+/// ===========================================================================
+/// Static functions - Assignments
+/// ===========================================================================
+
+#define _UNDEF 2
+
+/**
+ * Entries with a key of 0 are empty; others start at keys[key - 1].
+ */
+struct _Entry
+{
+	size_t key;
+	uint64_t count;
+	uint32_t hash;
+};
+
+/**
+ * occurrences[l] up to occurrences[l + 1] are the indices into occurs of
+ * the clauses that contain literal l. owners holds the variable each
+ * clause defines, or CNF_NONE. Stamps mark the variables and clauses
+ * already seen while splitting into components, and the defined
+ * variables that are still needed.
+ */
+struct _Counter
+{
+	SentenceCNF cnf;
+	uint8_t* values;
+	uint32_t* trail;
+	size_t trailSize;
+
+	size_t* occurrences;
+	uint32_t* occurs;
+	uint32_t* owners;
+
+	uint32_t stamp;
+	uint32_t* needed;
+	uint32_t* varStamps;
+	uint32_t* clauseStamps;
+	uint32_t* scores;
+
+	size_t tableSize;
+	size_t tableCount;
+	struct _Entry* table;
+	size_t numKeys;
+	size_t maxKeys;
+	uint32_t* keys;
+};
+
+/**
+ * One step of the count on the explicit stack. A split holds the
+ * components it found, as _split() lists them, and multiplies their
+ * counts. A component points into its split's lists, and adds the counts
+ * of both values of best, the second once the first is undone to mark.
+ */
+struct _Frame
+{
+	uint8_t isComponent;
+	uint64_t count;
+	uint32_t* vars;
+	uint32_t* clauses;
+
+	size_t* bounds;
+	size_t numComponents;
+	size_t next;
+
+	size_t numVars;
+	size_t numClauses;
+	uint32_t hash;
+	uint32_t best;
+	uint8_t branch;
+	size_t mark;
+};
+
+static uint8_t _value(const struct _Counter* c, uint32_t literal)
+{
+	uint8_t value = c->values[CNF_VARIABLE(literal)];
+	return value == _UNDEF ? _UNDEF : value ^ CNF_IS_NEGATED(literal);
+}
+
+static void _assign(struct _Counter* c, uint32_t literal)
+{
+	c->values[CNF_VARIABLE(literal)] = !CNF_IS_NEGATED(literal);
+	c->trail[c->trailSize++] = literal;
+}
+
+static void _undo(struct _Counter* c, size_t mark)
+{
+	while (c->trailSize > mark)
+	{
+		c->values[CNF_VARIABLE(c->trail[--c->trailSize])] = _UNDEF;
+	}
+}
+
+static uint8_t _satisfied(const struct _Counter* c, size_t clause)
+{
+	const SentenceCNF cnf = c->cnf;
+
+	for (size_t k = cnf->clauses[clause]; k < cnf->clauses[clause+1]; k++)
+	{
+		if (_value(c, cnf->literals[k]) == 1) return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Propagates the units implied by the trail from head on.
+ *
+ * @return Returns 0 if a clause became false, 1 otherwise.
+ */
+static uint8_t _propagate(struct _Counter* c, size_t head)
+{
+	const SentenceCNF cnf = c->cnf;
+
+	while (head < c->trailSize)
+	{
+		uint32_t falsified = CNF_NEGATE(c->trail[head++]);
+
+		for (size_t o = c->occurrences[falsified];
+			o < c->occurrences[falsified+1]; o++)
+		{
+			size_t clause = c->occurs[o];
+			uint32_t unit = CNF_NONE;
+			size_t unassigned = 0;
+			uint8_t satisfied = 0;
+
+			for (size_t k = cnf->clauses[clause];
+				k < cnf->clauses[clause+1] && !satisfied; k++)
+			{
+				uint32_t literal = cnf->literals[k];
+				uint8_t value = _value(c, literal);
+				satisfied = value == 1;
+
+				if (value == _UNDEF && literal != unit)
+				{
+					unassigned++;
+					unit = literal;
+				}
+			}
+
+			if (satisfied) continue;
+			if (unassigned == 0) return 0;
+			if (unassigned == 1) _assign(c, unit);
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * Assigns the unit clauses and propagates them.
+ *
+ * @return Returns 0 if the clauses are contradictory, 1 otherwise.
+ */
+static uint8_t _start(struct _Counter* c)
+{
+	const SentenceCNF cnf = c->cnf;
+
+	for (size_t n = 0; n < cnf->numClauses; n++)
+	{
+		size_t size = cnf->clauses[n+1] - cnf->clauses[n];
+		if (size == 0) return 0;
+		if (size > 1) continue;
+
+		uint32_t literal = cnf->literals[cnf->clauses[n]];
+		uint8_t value = _value(c, literal);
+		if (value == 0) return 0;
+		if (value == _UNDEF) _assign(c, literal);
+	}
+
+	return _propagate(c, 0);
+}
+
+/// ===========================================================================
+/// Static functions - Cache
+/// ===========================================================================
+
+static int _compareIds(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+static uint32_t _hash(
+	const uint32_t* vars,
+	size_t numVars,
+	const uint32_t* clauses,
+	size_t numClauses)
+{
+	uint32_t hash = 2166136261u ^ (uint32_t) numVars;
+	for (size_t n = 0; n < numVars; n++) hash = (hash ^ vars[n]) * 16777619u;
+	for (size_t n = 0; n < numClauses; n++) hash = (hash ^ clauses[n]) * 16777619u;
+	return hash;
+}
+
+/**
+ * Returns the entry of the component, or the empty entry where it
+ * belongs.
+ */
+static struct _Entry* _probe(
+	const struct _Counter* c,
+	uint32_t hash,
+	const uint32_t* vars,
+	size_t numVars,
+	const uint32_t* clauses,
+	size_t numClauses)
+{
+	size_t mask = c->tableSize - 1;
+
+	for (size_t n = hash & mask; ; n = (n + 1) & mask)
+	{
+		struct _Entry* entry = &c->table[n];
+		if (entry->key == 0) return entry;
+		if (entry->hash != hash) continue;
+
+		const uint32_t* key = &c->keys[entry->key - 1];
+		if (key[0] == numVars && key[1] == numClauses
+			&& memcmp(key + 2, vars, numVars * sizeof(uint32_t)) == 0
+			&& memcmp(key + 2 + numVars, clauses,
+				numClauses * sizeof(uint32_t)) == 0)
+		{
+			return entry;
+		}
+	}
+}
+
+static void _rehash(struct _Counter* c)
+{
+	size_t oldSize = c->tableSize;
+	struct _Entry* old = c->table;
+	c->tableSize *= 2;
+	c->table = calloc(c->tableSize, sizeof(struct _Entry));
+
+	for (size_t n = 0; n < oldSize; n++)
+	{
+		if (old[n].key == 0) continue;
+		size_t mask = c->tableSize - 1;
+		size_t slot = old[n].hash & mask;
+		while (c->table[slot].key != 0) slot = (slot + 1) & mask;
+		c->table[slot] = old[n];
+	}
+
+	free(old);
+}
+
+/**
+ * Drops the older half of the cache. Keys are stored one after another,
+ * so the entries to keep are the ones whose keys start past the cut.
+ */
+static void _evict(struct _Counter* c)
+{
+	size_t cut = 0;
+	while (cut < c->numKeys / 2) cut += c->keys[cut] + c->keys[cut + 1] + 2;
+
+	memmove(c->keys, c->keys + cut, (c->numKeys - cut) * sizeof(uint32_t));
+	c->numKeys -= cut;
+
+	struct _Entry* old = c->table;
+	c->table = calloc(c->tableSize, sizeof(struct _Entry));
+	c->tableCount = 0;
+	size_t mask = c->tableSize - 1;
+
+	for (size_t n = 0; n < c->tableSize; n++)
+	{
+		if (old[n].key == 0 || old[n].key - 1 < cut) continue;
+		size_t slot = old[n].hash & mask;
+		while (c->table[slot].key != 0) slot = (slot + 1) & mask;
+		c->table[slot] = old[n];
+		c->table[slot].key -= cut;
+		c->tableCount++;
+	}
+
+	free(old);
+}
+
+static void _store(
+	struct _Counter* c,
+	uint32_t hash,
+	const uint32_t* vars,
+	size_t numVars,
+	const uint32_t* clauses,
+	size_t numClauses,
+	uint64_t count)
+{
+	size_t words = numVars + numClauses + 2;
+
+	while (c->numKeys > 0 && c->numKeys + words > SENTENCECOUNT_CACHE_WORDS)
+	{
+		_evict(c);
+	}
+
+	while (c->numKeys + words > c->maxKeys)
+	{
+		c->maxKeys *= 2;
+		c->keys = realloc(c->keys, c->maxKeys * sizeof(uint32_t));
+	}
+
+	if ((c->tableCount + 1) * 2 > c->tableSize) _rehash(c);
+
+	uint32_t* key = &c->keys[c->numKeys];
+	key[0] = numVars;
+	key[1] = numClauses;
+	memcpy(key + 2, vars, numVars * sizeof(uint32_t));
+	memcpy(key + 2 + numVars, clauses, numClauses * sizeof(uint32_t));
+
+	struct _Entry* entry = _probe(c, hash, vars, numVars, clauses, numClauses);
+	entry->key = c->numKeys + 1;
+	entry->hash = hash;
+	entry->count = count;
+	c->numKeys += words;
+	c->tableCount++;
+}
+
+/// ===========================================================================
+/// Static functions - Counting
+/// ===========================================================================
+
+static uint32_t _stamp(struct _Counter* c)
+{
+	if (++c->stamp == 0)
+	{
+		memset(c->needed, 0, c->cnf->numVariables * sizeof(uint32_t));
+		memset(c->varStamps, 0, c->cnf->numVariables * sizeof(uint32_t));
+		memset(c->clauseStamps, 0, c->cnf->numClauses * sizeof(uint32_t));
+		c->stamp = 1;
+	}
+
+	return c->stamp;
+}
+
+static uint8_t _isDefined(const struct _Counter* c, uint32_t var)
+{
+	return c->cnf->symbols[var] == SYMBOL_NONE;
+}
+
+/**
+ * Checks if the clause still constrains the unassigned variables.
+ */
+static uint8_t _isLive(const struct _Counter* c, size_t clause, uint32_t stamp)
+{
+	uint32_t owner = c->owners[clause];
+	if (owner != CNF_NONE && c->values[owner] == _UNDEF
+		&& c->needed[owner] != stamp) return 0;
+	return !_satisfied(c, clause);
+}
+
+/**
+ * Marks the defined variables among vars that are used by a live clause
+ * outside their own definition. Uses reach down from the clauses of
+ * assigned variables through the definitions of needed ones.
+ */
+static void _markNeeded(
+	struct _Counter* c,
+	const uint32_t* vars,
+	size_t numVars,
+	uint32_t stamp)
+{
+	const SentenceCNF cnf = c->cnf;
+	uint32_t* stack = malloc((numVars + 1) * sizeof(uint32_t));
+	size_t size = 0;
+
+	for (size_t n = 0; n < numVars; n++)
+	{
+		uint32_t var = vars[n];
+		if (c->values[var] != _UNDEF || !_isDefined(c, var)) continue;
+
+		for (size_t o = c->occurrences[CNF_LITERAL(var, 0)];
+			o < c->occurrences[CNF_LITERAL(var, 1) + 1]
+			&& c->needed[var] != stamp; o++)
+		{
+			uint32_t clause = c->occurs[o];
+			uint32_t owner = c->owners[clause];
+			if (owner == var) continue;
+			if (owner != CNF_NONE && c->values[owner] == _UNDEF) continue;
+			if (_satisfied(c, clause)) continue;
+			c->needed[var] = stamp;
+			stack[size++] = var;
+		}
+	}
+
+	while (size > 0)
+	{
+		uint32_t var = stack[--size];
+
+		for (size_t o = c->occurrences[CNF_LITERAL(var, 0)];
+			o < c->occurrences[CNF_LITERAL(var, 1) + 1]; o++)
+		{
+			uint32_t clause = c->occurs[o];
+			if (c->owners[clause] != var || _satisfied(c, clause)) continue;
+
+			for (size_t k = cnf->clauses[clause]; k < cnf->clauses[clause+1]; k++)
+			{
+				uint32_t child = CNF_VARIABLE(cnf->literals[k]);
+				if (c->values[child] != _UNDEF || !_isDefined(c, child)
+					|| c->needed[child] == stamp) continue;
+				c->needed[child] = stamp;
+				stack[size++] = child;
+			}
+		}
+	}
+
+	free(stack);
+}
+
+/**
+ * Splits the unassigned variables among vars into components, and
+ * starts the frame's count with the variables that are in none.
+ */
+static void _split(
+	struct _Counter* c,
+	const uint32_t* vars,
+	size_t numVars,
+	struct _Frame* f)
+{
+	const SentenceCNF cnf = c->cnf;
+	uint32_t stamp = _stamp(c);
+	_markNeeded(c, vars, numVars, stamp);
+
+	uint32_t* members = malloc((numVars + 1) * sizeof(uint32_t));
+	size_t* bounds = malloc(2 * (numVars + 1) * sizeof(size_t));
+	size_t maxClauses = numVars + 1;
+	uint32_t* clauses = malloc(maxClauses * sizeof(uint32_t));
+	size_t numMembers = 0;
+	size_t numClauses = 0;
+	size_t numComponents = 0;
+	uint64_t count = 1;
+
+	for (size_t n = 0; n < numVars; n++)
+	{
+		uint32_t var = vars[n];
+		if (c->values[var] != _UNDEF || c->varStamps[var] == stamp) continue;
+
+		// An unused definition has one model for each of its children's
+		if (_isDefined(c, var) && c->needed[var] != stamp) continue;
+
+		size_t first = numMembers;
+		size_t firstClause = numClauses;
+		c->varStamps[var] = stamp;
+		members[numMembers++] = var;
+
+		for (size_t m = first; m < numMembers; m++)
+		{
+			for (uint32_t literal = CNF_LITERAL(members[m], 0);
+				literal <= CNF_LITERAL(members[m], 1); literal++)
+			{
+				for (size_t o = c->occurrences[literal];
+					o < c->occurrences[literal+1]; o++)
+				{
+					uint32_t clause = c->occurs[o];
+					if (c->clauseStamps[clause] == stamp) continue;
+					c->clauseStamps[clause] = stamp;
+					if (!_isLive(c, clause, stamp)) continue;
+
+					if (numClauses == maxClauses)
+					{
+						maxClauses *= 2;
+						clauses = realloc(clauses, maxClauses * sizeof(uint32_t));
+					}
+
+					clauses[numClauses++] = clause;
+
+					for (size_t k = cnf->clauses[clause];
+						k < cnf->clauses[clause+1]; k++)
+					{
+						uint32_t other = CNF_VARIABLE(cnf->literals[k]);
+						if (c->values[other] != _UNDEF
+							|| c->varStamps[other] == stamp) continue;
+						c->varStamps[other] = stamp;
+						members[numMembers++] = other;
+					}
+				}
+			}
+		}
+
+		// A variable in no unsatisfied clause may take either value
+		if (numClauses == firstClause)
+		{
+			count = _multiply(count, 2);
+			numMembers = first;
+			continue;
+		}
+
+		bounds[2 * numComponents] = numMembers;
+		bounds[2 * numComponents + 1] = numClauses;
+		numComponents++;
+	}
+
+	f->isComponent = 0;
+	f->vars = members;
+	f->clauses = clauses;
+	f->bounds = bounds;
+	f->numComponents = numComponents;
+	f->next = 0;
+	f->count = count;
+}
+
+/**
+ * Looks the component up in the cache, or else picks the variable that
+ * occurs in the most of its clauses to branch on.
+ *
+ * @return Returns 1 if the count was cached, 0 otherwise.
+ */
+static uint8_t _enter(struct _Counter* c, struct _Frame* f)
+{
+	const SentenceCNF cnf = c->cnf;
+	qsort(f->vars, f->numVars, sizeof(uint32_t), _compareIds);
+	qsort(f->clauses, f->numClauses, sizeof(uint32_t), _compareIds);
+
+	f->hash = _hash(f->vars, f->numVars, f->clauses, f->numClauses);
+	struct _Entry* entry = _probe(c, f->hash,
+		f->vars, f->numVars, f->clauses, f->numClauses);
+
+	if (entry->key != 0)
+	{
+		f->count = entry->count;
+		return 1;
+	}
+
+	for (size_t n = 0; n < f->numClauses; n++)
+	{
+		for (size_t k = cnf->clauses[f->clauses[n]];
+			k < cnf->clauses[f->clauses[n]+1]; k++)
+		{
+			c->scores[CNF_VARIABLE(cnf->literals[k])]++;
+		}
+	}
+
+	f->best = f->vars[0];
+	for (size_t n = 0; n < f->numVars; n++)
+	{
+		if (c->scores[f->vars[n]] > c->scores[f->best]) f->best = f->vars[n];
+	}
+
+	for (size_t n = 0; n < f->numClauses; n++)
+	{
+		for (size_t k = cnf->clauses[f->clauses[n]];
+			k < cnf->clauses[f->clauses[n]+1]; k++)
+		{
+			c->scores[CNF_VARIABLE(cnf->literals[k])] = 0;
+		}
+	}
+
+	f->branch = 0;
+	f->count = 0;
+	return 0;
+}
+
+/**
+ * Counts the assignments to the unassigned variables among vars that
+ * satisfy the clauses. Each split multiplies the counts of its
+ * components, and each component adds the counts of both values of its
+ * branching variable, which split again. Uses an explicit stack of
+ * frames, so long chains of components are fine.
+ */
+static uint64_t _countVariables(
+	struct _Counter* c,
+	const uint32_t* vars,
+	size_t numVars)
+{
+	size_t maxFrames = 64;
+	struct _Frame* frames = malloc(maxFrames * sizeof(struct _Frame));
+	size_t top = 0;
+	_split(c, vars, numVars, &frames[top++]);
+
+	// Count of the frame last popped, for the one below it
+	uint64_t result = 0;
+	uint8_t returned = 0;
+
+	while (top > 0)
+	{
+		if (top == maxFrames)
+		{
+			maxFrames *= 2;
+			frames = realloc(frames, maxFrames * sizeof(struct _Frame));
+		}
+
+		struct _Frame* f = &frames[top - 1];
+
+		if (!f->isComponent)
+		{
+			if (returned) f->count = _multiply(f->count, result);
+			returned = 0;
+
+			if (f->next < f->numComponents && f->count > 0)
+			{
+				size_t n = f->next++;
+				size_t first = n ? f->bounds[2 * n - 2] : 0;
+				size_t firstClause = n ? f->bounds[2 * n - 1] : 0;
+
+				struct _Frame* g = &frames[top++];
+				g->isComponent = 1;
+				g->vars = f->vars + first;
+				g->numVars = f->bounds[2 * n] - first;
+				g->clauses = f->clauses + firstClause;
+				g->numClauses = f->bounds[2 * n + 1] - firstClause;
+
+				if (_enter(c, g))
+				{
+					result = g->count;
+					returned = 1;
+					top--;
+				}
+
+				continue;
+			}
+
+			free(f->bounds);
+			free(f->clauses);
+			free(f->vars);
+			result = f->count;
+			returned = 1;
+			top--;
+			continue;
+		}
+
+		if (returned)
+		{
+			_undo(c, f->mark);
+			f->count = _add(f->count, result);
+			returned = 0;
+		}
+
+		uint8_t entered = 0;
+		while (f->branch < 2 && !entered)
+		{
+			f->mark = c->trailSize;
+			_assign(c, CNF_LITERAL(f->best, f->branch++));
+			entered = _propagate(c, f->mark);
+			if (!entered) _undo(c, f->mark);
+		}
+
+		if (entered)
+		{
+			_split(c, f->vars, f->numVars, &frames[top++]);
+			continue;
+		}
+
+		_store(c, f->hash, f->vars, f->numVars, f->clauses, f->numClauses,
+			f->count);
+		result = f->count;
+		returned = 1;
+		top--;
+	}
+
+	free(frames);
+	return result;
+}
+
+/// ===========================================================================
+/// Static functions - Counters
+/// ===========================================================================
+
+static struct _Counter* _createCounter(const Sentence* sentences, size_t n)
+{
+	struct _Counter* c = malloc(sizeof(struct _Counter));
+	SentenceCNF cnf = SentenceCNF_create();
+	for (size_t k = 0; k < n; k++) SentenceCNF_assert(cnf, sentences[k]);
+	c->cnf = cnf;
+
+	size_t numVariables = cnf->numVariables;
+	c->values = malloc(numVariables + 1);
+	memset(c->values, _UNDEF, numVariables + 1);
+	c->trail = malloc((numVariables + 1) * sizeof(uint32_t));
+	c->trailSize = 0;
+
+	c->occurrences = calloc(2 * numVariables + 2, sizeof(size_t));
+	for (size_t k = 0; k < cnf->numLiterals; k++)
+	{
+		c->occurrences[cnf->literals[k] + 1]++;
+	}
+	for (size_t k = 0; k < 2 * numVariables; k++)
+	{
+		c->occurrences[k + 1] += c->occurrences[k];
+	}
+
+	size_t* fill = malloc((2 * numVariables + 1) * sizeof(size_t));
+	memcpy(fill, c->occurrences, (2 * numVariables + 1) * sizeof(size_t));
+	c->occurs = malloc((cnf->numLiterals + 1) * sizeof(uint32_t));
+	for (size_t clause = 0; clause < cnf->numClauses; clause++)
+	{
+		for (size_t k = cnf->clauses[clause]; k < cnf->clauses[clause+1]; k++)
+		{
+			c->occurs[fill[cnf->literals[k]]++] = clause;
+		}
+	}
+	free(fill);
+
+	// Children are encoded before their parents, so a definition's own
+	// variable is the largest in each of its clauses
+	c->owners = malloc((cnf->numClauses + 1) * sizeof(uint32_t));
+	for (size_t clause = 0; clause < cnf->numClauses; clause++)
+	{
+		uint32_t owner = CNF_NONE;
+		if (cnf->clauses[clause+1] - cnf->clauses[clause] > 1)
+		{
+			for (size_t k = cnf->clauses[clause]; k < cnf->clauses[clause+1]; k++)
+			{
+				uint32_t var = CNF_VARIABLE(cnf->literals[k]);
+				if (owner == CNF_NONE || var > owner) owner = var;
+			}
+
+			if (!_isDefined(c, owner)) owner = CNF_NONE;
+		}
+
+		c->owners[clause] = owner;
+	}
+
+	c->stamp = 0;
+	c->needed = calloc(numVariables + 1, sizeof(uint32_t));
+	c->varStamps = calloc(numVariables + 1, sizeof(uint32_t));
+	c->clauseStamps = calloc(cnf->numClauses + 1, sizeof(uint32_t));
+	c->scores = calloc(numVariables + 1, sizeof(uint32_t));
+
+	c->tableSize = 1024;
+	c->tableCount = 0;
+	c->table = calloc(c->tableSize, sizeof(struct _Entry));
+	c->numKeys = 0;
+	c->maxKeys = 4096;
+	c->keys = malloc(c->maxKeys * sizeof(uint32_t));
+
+	return c;
+}
+
+static void _freeCounter(struct _Counter* c)
+{
+	free(c->keys);
+	free(c->table);
+	free(c->scores);
+	free(c->clauseStamps);
+	free(c->varStamps);
+	free(c->needed);
+	free(c->owners);
+	free(c->occurs);
+	free(c->occurrences);
+	free(c->trail);
+	free(c->values);
+	SentenceCNF_free(c->cnf);
+	free(c);
+}
+
+/**
+ * Counts the models of everything not yet assigned.
+ */
+static uint64_t _countAll(struct _Counter* c)
+{
+	uint32_t numVariables = c->cnf->numVariables;
+	uint32_t* vars = malloc((numVariables + 1) * sizeof(uint32_t));
+	for (uint32_t n = 0; n < numVariables; n++) vars[n] = n;
+
+	uint64_t count = _countVariables(c, vars, numVariables);
+	free(vars);
+	return count;
+}
+
+/**
+ * Depth-first search over the sentences' variables, by ascending symbol
+ * id. A branch is only entered if the counter finds a model below it,
+ * so every leaf is a model.
+ */
+static uint64_t _enumerate(
+	struct _Counter* c,
+	SentenceModelCallback callback,
+	void* data)
+{
+	const SentenceCNF cnf = c->cnf;
+	if (!_start(c) || _countAll(c) == 0) return 0;
+
+	uint32_t* inputs = malloc((cnf->numVariables + 1) * sizeof(uint32_t));
+	size_t numInputs = 0;
+	for (size_t symbol = 0; symbol < cnf->numSymbols; symbol++)
+	{
+		if (cnf->variables[symbol] != 0)
+			inputs[numInputs++] = cnf->variables[symbol] - 1;
+	}
+
+	size_t* marks = malloc((numInputs + 1) * sizeof(size_t));
+	uint8_t* tried = malloc(numInputs + 1);
+	uint8_t* values = calloc(Symbol_count() + 1, 1);
+	uint64_t found = 0;
+	size_t depth = 0;
+	tried[0] = 0;
+
+	while (1)
+	{
+		if (depth == numInputs)
+		{
+			for (size_t n = 0; n < numInputs; n++)
+			{
+				values[cnf->symbols[inputs[n]]] = c->values[inputs[n]] == 1;
+			}
+
+			found++;
+			if (!callback(values, data) || depth == 0) break;
+			depth--;
+			continue;
+		}
+
+		uint32_t var = inputs[depth];
+
+		// Forced by propagation: there is only one branch
+		if (tried[depth] == 0 && c->values[var] != _UNDEF)
+		{
+			marks[depth] = c->trailSize;
+			tried[depth] = 2;
+			tried[++depth] = 0;
+			continue;
+		}
+
+		if (tried[depth] == 0) marks[depth] = c->trailSize;
+		_undo(c, marks[depth]);
+
+		if (tried[depth] == 2)
+		{
+			if (depth == 0) break;
+			depth--;
+			continue;
+		}
+
+		_assign(c, CNF_LITERAL(var, tried[depth] == 0));
+		tried[depth]++;
+		if (_propagate(c, marks[depth]) && _countAll(c) > 0) tried[++depth] = 0;
+	}
+
+	free(values);
+	free(tried);
+	free(marks);
+	free(inputs);
+	return found;
+}
+
+/// ===========================================================================
+/// Function definitions
+/// ===========================================================================
+
+uint64_t Sentence_countModels(
+	const Sentence* sentences,
+	const size_t numSentences)
+{
+	struct _Counter* c = _createCounter(sentences, numSentences);
+	uint64_t count = _start(c) ? _countAll(c) : 0;
+	_freeCounter(c);
+	return count;
+}
+
+uint64_t Sentence_enumerateModels(
+	const Sentence* sentences,
+	const size_t numSentences,
+	SentenceModelCallback callback,
+	void* data)
+{
+	struct _Counter* c = _createCounter(sentences, numSentences);
+	uint64_t found = _enumerate(c, callback, data);
+	_freeCounter(c);
+	return found;
+}
+
+uint64_t SentenceSet_countModels(const SentenceSet set)
+{
+	return Sentence_countModels(set->added, set->addedCount);
+}
+
+uint64_t SentenceSet_enumerateModels(
+	const SentenceSet set,
+	SentenceModelCallback callback,
+	void* data)
+{
+	return Sentence_enumerateModels(set->added, set->addedCount,
+		callback, data);
+}
@@ -0,0 +1,543 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentenceeval.h.
+ *
+ * A check is compiled into a flat list of nodes, children before
+ * parents, so shared subsentences are computed once per block. Row a of
+ * the truth table gives variable k the value of bit k of a; the columns
+ * of the first six variables are therefore the same in every word, and
+ * the others are all zeros or all ones.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sentenceeval.h"
+#include "sentencemap.h"
+#include "sentencesat.h"
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#define _NONE UINT32_MAX
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Atomic nodes (op NO_OP) store the index of their variable in left.
+ */
+struct _Node
+{
+	SentenceOperator op;
+	uint8_t negated;
+	uint32_t left;
+	uint32_t right;
+};
+
+/**
+ * A compiled check. Counterexamples are rows where every premise node is
+ * true and the conclusion node, if any, is false.
+ */
+struct _Program
+{
+	struct _Node* nodes;
+	size_t numNodes;
+	size_t maxNodes;
+
+	uint32_t* variables;
+	size_t numVariables;
+
+	uint32_t* premises;
+	size_t numPremises;
+	uint32_t conclusion;
+};
+
+struct _Search
+{
+	const struct _Program* program;
+	uint64_t rows;
+	uint64_t blocks;
+	uint64_t next;
+	uint64_t found;
+};
+
+/// ===========================================================================
+/// Static functions - Compiling
+/// ===========================================================================
+
+static uint32_t _addNode(
+	struct _Program* p,
+	SentenceOperator op,
+	uint8_t negated,
+	uint32_t left,
+	uint32_t right)
+{
+	if (p->numNodes == p->maxNodes)
+	{
+		p->maxNodes = p->maxNodes == 0 ? SENTENCESET_BUFFER : p->maxNodes * 2;
+		p->nodes = realloc(p->nodes, p->maxNodes * sizeof(struct _Node));
+	}
+
+	struct _Node* node = &p->nodes[p->numNodes];
+	node->op = op;
+	node->negated = negated;
+	node->left = left;
+	node->right = right;
+	return p->numNodes++;
+}
+
+/**
+ * Appends the nodes of the sentence that are not compiled yet, and
+ * returns the index of its root. Atomic nodes hold their symbol id until
+ * _finish() replaces it.
+ */
+static uint32_t _compile(
+	struct _Program* p,
+	SentenceMap indices,
+	const Sentence sentence)
+{
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	stack[size++] = sentence;
+
+	while (size > 0)
+	{
+		Sentence s = stack[size-1];
+		void* left = NULL;
+		void* right = NULL;
+
+		if (SentenceMap_get(indices, s, NULL))
+		{
+			size--;
+			continue;
+		}
+
+		uint32_t index;
+		if (s->type == ATOMIC)
+		{
+			index = _addNode(p, NO_OP, s->negated, s->id, 0);
+		}
+
+		else
+		{
+			uint8_t hasLeft = SentenceMap_get(indices, s->left.sentence, &left);
+			uint8_t hasRight =
+				SentenceMap_get(indices, s->right.sentence, &right);
+
+			if (!hasLeft || !hasRight)
+			{
+				if (size + 2 > buffer)
+				{
+					buffer *= 2;
+					stack = realloc(stack, buffer * sizeof(Sentence));
+				}
+
+				if (!hasRight) stack[size++] = s->right.sentence;
+				if (!hasLeft) stack[size++] = s->left.sentence;
+				continue;
+			}
+
+			index = _addNode(p, s->op, s->negated,
+				(uint32_t)(uintptr_t) left, (uint32_t)(uintptr_t) right);
+		}
+
+		SentenceMap_put(indices, s, (void*)(uintptr_t) index);
+		size--;
+	}
+
+	free(stack);
+	void* root = NULL;
+	SentenceMap_get(indices, sentence, &root);
+	return (uint32_t)(uintptr_t) root;
+}
+
+static int _compareIds(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Numbers the variables of the program in order of symbol id, and points
+ * the atomic nodes at their variable's number.
+ */
+static void _finish(struct _Program* p)
+{
+	p->variables = malloc((p->numNodes + 1) * sizeof(uint32_t));
+	p->numVariables = 0;
+
+	for (size_t n = 0; n < p->numNodes; n++)
+	{
+		if (p->nodes[n].op == NO_OP)
+			p->variables[p->numVariables++] = p->nodes[n].left;
+	}
+
+	qsort(p->variables, p->numVariables, sizeof(uint32_t), _compareIds);
+	size_t unique = 0;
+	for (size_t n = 0; n < p->numVariables; n++)
+	{
+		if (unique == 0 || p->variables[unique-1] != p->variables[n])
+			p->variables[unique++] = p->variables[n];
+	}
+	p->numVariables = unique;
+
+	for (size_t n = 0; n < p->numNodes; n++)
+	{
+		if (p->nodes[n].op != NO_OP) continue;
+		uint32_t* var = bsearch(&p->nodes[n].left, p->variables,
+			p->numVariables, sizeof(uint32_t), _compareIds);
+		p->nodes[n].left = var - p->variables;
+	}
+}
+
+/**
+ * Compiles a check. conclusion is _NONE or the index of a sentence in
+ * roots; the other roots are premises.
+ */
+static void _create(
+	struct _Program* p,
+	const Sentence* roots,
+	const size_t numRoots,
+	const size_t conclusion)
+{
+	memset(p, 0, sizeof(struct _Program));
+	p->premises = malloc((numRoots + 1) * sizeof(uint32_t));
+	p->conclusion = _NONE;
+	SentenceMap indices = SentenceMap_create();
+
+	for (size_t n = 0; n < numRoots; n++)
+	{
+		uint32_t index = _compile(p, indices, roots[n]);
+		if (n == conclusion) p->conclusion = index;
+		else p->premises[p->numPremises++] = index;
+	}
+
+	SentenceMap_free(indices);
+	_finish(p);
+}
+
+static void _free(struct _Program* p)
+{
+	free(p->nodes);
+	free(p->variables);
+	free(p->premises);
+}
+
+/// ===========================================================================
+/// Static functions - Evaluation
+/// ===========================================================================
+
+/**
+ * Returns variable k's column of the truth table in the given word.
+ */
+static uint64_t _column(uint32_t k, uint64_t word)
+{
+	static const uint64_t patterns[6] =
+	{
+		0xAAAAAAAAAAAAAAAAULL,
+		0xCCCCCCCCCCCCCCCCULL,
+		0xF0F0F0F0F0F0F0F0ULL,
+		0xFF00FF00FF00FF00ULL,
+		0xFFFF0000FFFF0000ULL,
+		0xFFFFFFFF00000000ULL
+	};
+
+	if (k < 6) return patterns[k];
+	return (word >> (k - 6)) & 1 ? ~0ULL : 0;
+}
+
+/**
+ * Computes every node of the program over one block of rows. values
+ * holds SENTENCEEVAL_WORDS words per node.
+ */
+static void _evaluateBlock(
+	const struct _Program* p,
+	uint64_t block,
+	uint64_t* values)
+{
+	const size_t W = SENTENCEEVAL_WORDS;
+
+	for (size_t n = 0; n < p->numNodes; n++)
+	{
+		const struct _Node* node = &p->nodes[n];
+		uint64_t* out = &values[n * W];
+		uint64_t neg = node->negated ? ~0ULL : 0;
+
+		if (node->op == NO_OP)
+		{
+			for (size_t w = 0; w < W; w++)
+				out[w] = _column(node->left, block * W + w) ^ neg;
+			continue;
+		}
+
+		const uint64_t* l = &values[node->left * W];
+		const uint64_t* r = &values[node->right * W];
+
+		switch (node->op)
+		{
+			case AND:
+				for (size_t w = 0; w < W; w++) out[w] = (l[w] & r[w]) ^ neg;
+				break;
+			case OR:
+				for (size_t w = 0; w < W; w++) out[w] = (l[w] | r[w]) ^ neg;
+				break;
+			case MATERIAL_CONDITIONAL:
+				for (size_t w = 0; w < W; w++) out[w] = (~l[w] | r[w]) ^ neg;
+				break;
+			default:
+				for (size_t w = 0; w < W; w++) out[w] = (l[w] ^ r[w]) ^ ~neg;
+				break;
+		}
+	}
+}
+
+/**
+ * Returns the rows of one word of an evaluated block that are
+ * counterexamples.
+ */
+static uint64_t _counterexamples(
+	const struct _Search* search,
+	const uint64_t* values,
+	uint64_t block,
+	size_t w)
+{
+	const struct _Program* p = search->program;
+	const size_t W = SENTENCEEVAL_WORDS;
+
+	uint64_t bad = p->conclusion == _NONE ? ~0ULL
+		: ~values[p->conclusion * W + w];
+
+	for (size_t n = 0; n < p->numPremises; n++)
+	{
+		bad &= values[p->premises[n] * W + w];
+	}
+
+	// Rows past the end of a small table are not assignments
+	uint64_t first = (block * W + w) * 64;
+	if (first >= search->rows) return 0;
+	if (search->rows - first < 64) bad &= (1ULL << (search->rows - first)) - 1;
+	return bad;
+}
+
+static void* _search(void* arg)
+{
+	struct _Search* search = arg;
+	uint64_t* values = malloc(
+		(search->program->numNodes + 1) * SENTENCEEVAL_WORDS * sizeof(uint64_t));
+
+	while (__atomic_load_n(&search->found, __ATOMIC_RELAXED) == UINT64_MAX)
+	{
+		uint64_t start = __atomic_fetch_add(&search->next,
+			SENTENCEEVAL_BATCH, __ATOMIC_RELAXED);
+		if (start >= search->blocks) break;
+
+		uint64_t end = search->blocks - start < SENTENCEEVAL_BATCH
+			? search->blocks : start + SENTENCEEVAL_BATCH;
+
+		for (uint64_t block = start; block < end; block++)
+		{
+			_evaluateBlock(search->program, block, values);
+
+			for (size_t w = 0; w < SENTENCEEVAL_WORDS; w++)
+			{
+				uint64_t bad = _counterexamples(search, values, block, w);
+				if (bad == 0) continue;
+
+				uint64_t row = (block * SENTENCEEVAL_WORDS + w) * 64
+					+ __builtin_ctzll(bad);
+				uint64_t none = UINT64_MAX;
+				__atomic_compare_exchange_n(&search->found, &none, row, 0,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED);
+				free(values);
+				return NULL;
+			}
+		}
+	}
+
+	free(values);
+	return NULL;
+}
+
+/**
+ * Searches a compiled check for a counterexample.
+ */
+static uint8_t _run(
+	const struct _Program* p,
+	size_t threads,
+	uint8_t* values)
+{
+	struct _Search search;
+	search.program = p;
+	search.rows = 1ULL << p->numVariables;
+	search.next = 0;
+	search.found = UINT64_MAX;
+
+	const uint32_t blockBits = 6 + SENTENCEEVAL_WORD_BITS;
+	search.blocks = p->numVariables > blockBits
+		? 1ULL << (p->numVariables - blockBits) : 1;
+
+	if (threads == 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cores > 0 ? (size_t) cores : 1;
+	}
+
+	uint64_t batches = (search.blocks - 1) / SENTENCEEVAL_BATCH + 1;
+	if (threads > batches) threads = batches;
+
+	// Threads take batches as they go, so any that fail to start are
+	// simply left out
+	pthread_t* ids = malloc(threads * sizeof(pthread_t));
+	size_t started = 1;
+	while (started < threads
+		&& pthread_create(&ids[started], NULL, _search, &search) == 0)
+	{
+		started++;
+	}
+
+	_search(&search);
+	for (size_t n = 1; n < started; n++) pthread_join(ids[n], NULL);
+	free(ids);
+
+	if (search.found == UINT64_MAX) return 0;
+
+	if (values != NULL)
+	{
+		for (size_t k = 0; k < p->numVariables; k++)
+			values[p->variables[k]] = (search.found >> k) & 1;
+	}
+
+	return 1;
+}
+
+/// ===========================================================================
+/// Static functions - Single assignments
+/// ===========================================================================
+
+struct _Assignment
+{
+	const uint8_t* values;
+	SentenceMap results;
+};
+
+static uint8_t _apply(SentenceOperator op, uint8_t left, uint8_t right)
+{
+	switch (op)
+	{
+		case AND: return left && right;
+		case OR: return left || right;
+		case MATERIAL_CONDITIONAL: return !left || right;
+		default: return left == right;
+	}
+}
+
+static void _evaluateNode(const Sentence s, void* data)
+{
+	struct _Assignment* a = data;
+	uint8_t value;
+
+	if (s->type == ATOMIC)
+	{
+		value = a->values[s->id] != 0;
+	}
+	else
+	{
+		void* left = NULL;
+		void* right = NULL;
+		SentenceMap_get(a->results, s->left.sentence, &left);
+		SentenceMap_get(a->results, s->right.sentence, &right);
+		value = _apply(s->op, left != NULL, right != NULL);
+	}
+
+	if (s->negated) value = !value;
+	SentenceMap_put(a->results, s, value ? (void*) s : NULL);
+}
+
+/// ===========================================================================
+/// Function definitions
+/// ===========================================================================
+
+uint8_t Sentence_evaluate(const Sentence sentence, const uint8_t* values)
+{
+	struct _Assignment a;
+	a.values = values;
+	a.results = SentenceMap_create();
+
+	SentenceVisitor visitor = {NULL, NULL, _evaluateNode, &a};
+	Sentence_visitUnique(sentence, &visitor);
+
+	void* result = NULL;
+	SentenceMap_get(a.results, sentence, &result);
+	SentenceMap_free(a.results);
+	return result != NULL;
+}
+
+uint8_t Sentence_isTautology(const Sentence sentence)
+{
+	return Sentence_entails(NULL, 0, sentence);
+}
+
+uint8_t Sentence_isContradiction(const Sentence sentence)
+{
+	return Sentence_entails(&sentence, 1, NULL);
+}
+
+uint8_t Sentence_areEquivalent(const Sentence a, const Sentence b)
+{
+	// Check (a = b) without building it as a sentence
+	struct _Program p;
+	Sentence roots[2] = {a, b};
+	_create(&p, roots, 2, _NONE);
+	p.numPremises = 0;
+	p.conclusion = _addNode(&p, MATERIAL_BICONDITIONAL, 0,
+		p.premises[0], p.premises[1]);
+
+	if (p.numVariables > SENTENCEEVAL_MAX_TABLE)
+	{
+		_free(&p);
+		return SentenceSAT_entails(&a, 1, b, NULL)
+			&& SentenceSAT_entails(&b, 1, a, NULL);
+	}
+
+	uint8_t found = _run(&p, 0, NULL);
+	_free(&p);
+	return !found;
+}
+
+uint8_t Sentence_entails(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion)
+{
+	return !Sentence_findCounterexample(
+		premises, numPremises, conclusion, 0, NULL);
+}
+
+uint8_t Sentence_findCounterexample(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion,
+	size_t threads,
+	uint8_t* values)
+{
+	Sentence* roots = malloc((numPremises + 1) * sizeof(Sentence));
+	if (numPremises > 0)
+		memcpy(roots, premises, numPremises * sizeof(Sentence));
+	roots[numPremises] = conclusion;
+
+	struct _Program p;
+	size_t numRoots = numPremises + (conclusion != NULL);
+	_create(&p, roots, numRoots, conclusion != NULL ? numPremises : _NONE);
+
+	uint8_t found = p.numVariables > SENTENCEEVAL_MAX_TABLE
+		? !SentenceSAT_entails(premises, numPremises, conclusion, values)
+		: _run(&p, threads, values);
+	_free(&p);
+	free(roots);
+	return found;
+}
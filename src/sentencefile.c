@@ -0,0 +1,269 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencefile.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sentencefile.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+/**
+ * Checks that the mapped file is consistent, so that no accessor can
+ * read outside of it: sizes add up, names are terminated, and every
+ * node refers to earlier nodes or to existing variables.
+ */
+static uint8_t _validate(SentenceImage image)
+{
+	if (image->mapSize < sizeof(struct SentenceFileHeader_s)) return 0;
+
+	const struct SentenceFileHeader_s* header = image->map;
+	if (memcmp(header->magic, SENTENCEFILE_MAGIC, 8) != 0) return 0;
+	if (header->version != SENTENCEFILE_VERSION) return 0;
+
+	uint64_t size = sizeof(struct SentenceFileHeader_s);
+	size += ((uint64_t) header->numVariables + 1) * sizeof(uint32_t);
+	size += (uint64_t) header->numNodes * sizeof(PackedSentence);
+	if (header->namesSize > UINT32_MAX) return 0;
+	if (size + header->namesSize != image->mapSize) return 0;
+
+	image->numVariables = header->numVariables;
+	image->numNodes = header->numNodes;
+	image->offsets = (const uint32_t*) (header + 1);
+	image->nodes = (const PackedSentence*)
+		(image->offsets + image->numVariables + 1);
+	image->names = (const char*) (image->nodes + image->numNodes);
+
+	// Names
+	if (image->offsets[0] != 0) return 0;
+	if (image->offsets[image->numVariables] != header->namesSize) return 0;
+
+	for (uint32_t n = 0; n < image->numVariables; n++)
+	{
+		uint32_t end = image->offsets[n+1];
+		if (end <= image->offsets[n]) return 0;
+		if (image->names[end-1] != '\0') return 0;
+	}
+
+	// Nodes
+	for (uint32_t n = 0; n < image->numNodes; n++)
+	{
+		PackedSentence node = image->nodes[n];
+		SentenceOperator op = PACKED_OP(node);
+		if (node.flags & ~(PACKED_NEGATED|PACKED_COMPOUND|PACKED_OP_MASK))
+			return 0;
+
+		if (PACKED_IS_COMPOUND(node))
+		{
+			if (op == NO_OP || op > MATERIAL_BICONDITIONAL) return 0;
+			if (node.left >= n || node.right >= n) return 0;
+		}
+		else
+		{
+			if (op != NO_OP) return 0;
+			if (node.left >= image->numVariables) return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * Interns the file's variables on first use, so atomic nodes can be
+ * turned into sentences.
+ */
+static const uint32_t* _symbols(SentenceImage image)
+{
+	if (image->symbols != NULL) return image->symbols;
+
+	image->symbols = malloc((image->numVariables + 1) * sizeof(uint32_t));
+
+	for (uint32_t n = 0; n < image->numVariables; n++)
+	{
+		uint32_t start = image->offsets[n];
+		uint32_t len = image->offsets[n+1] - start - 1;
+		image->symbols[n] = Symbol_intern(image->names + start, len);
+	}
+
+	return image->symbols;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceImage SentenceImage_load(const char* path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return NULL;
+
+	SentenceImage image = malloc(sizeof(struct SentenceImage_s));
+	image->map = map;
+	image->mapSize = st.st_size;
+	image->symbols = NULL;
+
+	if (!_validate(image))
+	{
+		SentenceImage_free(image);
+		return NULL;
+	}
+
+	return image;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceImage_free(SentenceImage image)
+{
+	munmap(image->map, image->mapSize);
+	free(image->symbols);
+	free(image);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+const char* SentenceImage_variable(
+	const SentenceImage image,
+	const uint32_t variable)
+{
+	if (variable >= image->numVariables) return NULL;
+	return image->names + image->offsets[variable];
+}
+
+Sentence SentenceImage_toSentence(
+	SentenceImage image,
+	const uint32_t index,
+	SentenceSet set)
+{
+	if (index >= image->numNodes) return NULL;
+	return SentencePack_build(image->nodes, index, _symbols(image), set);
+}
+
+void SentenceImage_toSet(SentenceImage image, SentenceSet set)
+{
+	const uint32_t* symbols = _symbols(image);
+	Sentence* built = malloc((image->numNodes + 1) * sizeof(Sentence));
+
+	for (uint32_t n = 0; n < image->numNodes; n++)
+	{
+		PackedSentence node = image->nodes[n];
+		uint8_t negated = PACKED_IS_NEGATED(node) != 0;
+
+		if (PACKED_IS_COMPOUND(node))
+		{
+			built[n] = SentenceSet_createCompound(set, PACKED_OP(node),
+				built[node.left], built[node.right], negated);
+		}
+		else
+		{
+			built[n] = SentenceSet_createVariable(
+				set, symbols[node.left], negated);
+		}
+	}
+
+	free(built);
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+uint8_t SentenceSet_save(const SentenceSet set, const char* path)
+{
+	FILE* file = fopen(path, "wb");
+	if (file == NULL) return 0;
+
+	SentencePack pack = SentencePack_fromSet(set);
+
+	// Number the variables in order of first appearance
+	uint32_t numSymbols = Symbol_count();
+	uint32_t* local = malloc((numSymbols + 1) * sizeof(uint32_t));
+	uint32_t* globals = malloc((numSymbols + 1) * sizeof(uint32_t));
+	uint32_t numVariables = 0;
+	uint64_t namesSize = 0;
+	memset(local, 0xff, (numSymbols + 1) * sizeof(uint32_t));
+
+	for (uint32_t n = 0; n < pack->size; n++)
+	{
+		PackedSentence* node = &pack->nodes[n];
+		if (PACKED_IS_COMPOUND(*node)) continue;
+
+		if (local[node->left] == SENTENCEPACK_NONE)
+		{
+			local[node->left] = numVariables;
+			globals[numVariables++] = node->left;
+			namesSize += strlen(Symbol_name(node->left)) + 1;
+		}
+
+		node->left = local[node->left];
+	}
+
+	struct SentenceFileHeader_s header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SENTENCEFILE_MAGIC, 8);
+	header.version = SENTENCEFILE_VERSION;
+	header.numVariables = numVariables;
+	header.numNodes = pack->size;
+	header.namesSize = namesSize;
+	fwrite(&header, sizeof(header), 1, file);
+
+	uint32_t offset = 0;
+	for (uint32_t n = 0; n < numVariables; n++)
+	{
+		fwrite(&offset, sizeof(uint32_t), 1, file);
+		offset += strlen(Symbol_name(globals[n])) + 1;
+	}
+	fwrite(&offset, sizeof(uint32_t), 1, file);
+
+	// Copy nodes field by field so struct padding is written as zeros
+	for (uint32_t n = 0; n < pack->size; n++)
+	{
+		PackedSentence node;
+		memset(&node, 0, sizeof(node));
+		node.left = pack->nodes[n].left;
+		node.right = pack->nodes[n].right;
+		node.flags = pack->nodes[n].flags;
+		fwrite(&node, sizeof(node), 1, file);
+	}
+
+	for (uint32_t n = 0; n < numVariables; n++)
+	{
+		const char* name = Symbol_name(globals[n]);
+		fwrite(name, 1, strlen(name) + 1, file);
+	}
+
+	uint8_t ok = !ferror(file);
+	ok = fclose(file) == 0 && ok;
+
+	SentencePack_free(pack);
+	free(local);
+	free(globals);
+	return ok;
+}
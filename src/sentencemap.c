@@ -0,0 +1,110 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencemap.h.
+ */
+
+#include "sentencemap.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+static size_t _hash(const Sentence key)
+{
+	uint64_t h = (uint64_t)(uintptr_t) key;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return (size_t) h;
+}
+
+/**
+ * Returns the slot holding the key, or the empty slot where it would
+ * be inserted.
+ */
+static struct SentenceMapEntry_s* _probe(
+	const SentenceMap map,
+	const Sentence key)
+{
+	size_t mask = map->tableSize - 1;
+	size_t n = _hash(key) & mask;
+
+	while (map->table[n].key != NULL && map->table[n].key != key)
+	{
+		n = (n + 1) & mask;
+	}
+
+	return &map->table[n];
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceMap SentenceMap_create()
+{
+	SentenceMap map = malloc(sizeof(struct SentenceMap_s));
+	map->size = 0;
+	map->tableSize = 16;
+	map->table = calloc(map->tableSize, sizeof(struct SentenceMapEntry_s));
+	return map;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceMap_free(SentenceMap map)
+{
+	free(map->table);
+	free(map);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void SentenceMap_put(SentenceMap map, const Sentence key, void* value)
+{
+	struct SentenceMapEntry_s* entry = _probe(map, key);
+
+	if (entry->key != NULL)
+	{
+		entry->value = value;
+		return;
+	}
+
+	entry->key = key;
+	entry->value = value;
+	map->size++;
+
+	// Double the table once it is half full
+	if (map->size * 2 < map->tableSize) return;
+
+	struct SentenceMapEntry_s* old = map->table;
+	size_t oldSize = map->tableSize;
+	map->tableSize *= 2;
+	map->table = calloc(map->tableSize, sizeof(struct SentenceMapEntry_s));
+
+	for (size_t n = 0; n < oldSize; n++)
+	{
+		if (old[n].key != NULL) *_probe(map, (Sentence) old[n].key) = old[n];
+	}
+
+	free(old);
+}
+
+uint8_t SentenceMap_get(
+	const SentenceMap map,
+	const Sentence key,
+	void** value)
+{
+	struct SentenceMapEntry_s* entry = _probe(map, key);
+	if (entry->key == NULL) return 0;
+	if (value != NULL) *value = entry->value;
+	return 1;
+}
@@ -0,0 +1,614 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencenormal.h.
+ *
+ * NNF is computed for a member and a polarity, 1 meaning the member's
+ * negation, so each member is transformed at most twice. DNF and CNF are
+ * computed from the NNF, one member at a time, children first. The DNF
+ * or CNF of a member is read back into its terms when its parent needs
+ * it, so only members have to be memoized.
+ *
+ * "outer" is the operator between terms and "inner" the one between the
+ * literals of a term: v and & for DNF, & and v for CNF.
+ */
+
+#include "sentencenormal.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * A member of which the NNF of it, or of its negation, is needed.
+ */
+struct _Frame
+{
+	Sentence sentence;
+	uint8_t negated;
+};
+
+/**
+ * Term t is literals[t ? ends[t - 1] : 0] up to literals[ends[t]].
+ */
+struct _Terms
+{
+	Sentence* literals;
+	size_t numLiterals;
+	size_t maxLiterals;
+
+	size_t* ends;
+	size_t numTerms;
+	size_t maxTerms;
+};
+
+struct _Term
+{
+	const Sentence* literals;
+	size_t size;
+};
+
+/// ===========================================================================
+/// Static functions - Negation normal form
+/// ===========================================================================
+
+static uint8_t _isOp(const Sentence s, SentenceOperator op)
+{
+	return s->type == COMPOUND && !s->negated && s->op == op;
+}
+
+/**
+ * Joins two NNF members by & or v, dropping repeats and absorbed parts.
+ */
+static Sentence _join(
+	SentenceSet set,
+	SentenceOperator op,
+	Sentence left,
+	Sentence right)
+{
+	SentenceOperator dual = op == AND ? OR : AND;
+	if (left == right) return left;
+
+	if (_isOp(right, dual)
+		&& (right->left.sentence == left || right->right.sentence == left))
+	{
+		return left;
+	}
+
+	if (_isOp(left, dual)
+		&& (left->left.sentence == right || left->right.sentence == right))
+	{
+		return right;
+	}
+
+	return SentenceSet_createCompound(set, op, left, right, 0);
+}
+
+static SentenceMap _memo(const SentenceNormalizer normalizer, uint8_t negated)
+{
+	return negated ? normalizer->negative : normalizer->positive;
+}
+
+/**
+ * Looks up the NNF of the sentence, or of its negation, and pushes the
+ * frame if it has not been computed.
+ *
+ * @return Returns the NNF, or NULL if the frame was pushed.
+ */
+static Sentence _need(
+	const SentenceNormalizer normalizer,
+	Sentence sentence,
+	uint8_t negated,
+	struct _Frame** stack,
+	size_t* top,
+	size_t* stackSize)
+{
+	void* result;
+	if (SentenceMap_get(_memo(normalizer, negated), sentence, &result))
+		return result;
+
+	if (*top == *stackSize)
+	{
+		*stackSize *= 2;
+		*stack = realloc(*stack, *stackSize * sizeof(struct _Frame));
+	}
+
+	(*stack)[(*top)++] = (struct _Frame) {sentence, negated};
+	return NULL;
+}
+
+static Sentence _nnf(SentenceNormalizer normalizer, const Sentence sentence)
+{
+	SentenceSet set = normalizer->set;
+	void* result;
+	if (SentenceMap_get(normalizer->positive, sentence, &result)) return result;
+
+	size_t stackSize = 64;
+	struct _Frame* stack = malloc(stackSize * sizeof(struct _Frame));
+	size_t top = 0;
+	stack[top++] = (struct _Frame) {sentence, 0};
+
+	while (top > 0)
+	{
+		struct _Frame f = stack[top - 1];
+		Sentence s = f.sentence;
+		SentenceMap memo = _memo(normalizer, f.negated);
+
+		if (SentenceMap_get(memo, s, NULL))
+		{
+			top--;
+			continue;
+		}
+
+		uint8_t negated = f.negated ^ s->negated;
+
+		if (s->type == ATOMIC)
+		{
+			SentenceMap_put(memo, s,
+				SentenceSet_createVariable(set, s->id, negated));
+			top--;
+			continue;
+		}
+
+		// The polarities each operator needs of its left and right
+		uint8_t both = s->op == MATERIAL_BICONDITIONAL;
+		uint8_t leftNegated = s->op == MATERIAL_CONDITIONAL
+			? !negated : negated;
+		size_t pushed = top;
+
+		Sentence l0 = _need(normalizer, s->left.sentence, leftNegated,
+			&stack, &top, &stackSize);
+		Sentence r0 = _need(normalizer, s->right.sentence, negated,
+			&stack, &top, &stackSize);
+		Sentence l1 = NULL;
+		Sentence r1 = NULL;
+
+		if (both)
+		{
+			l1 = _need(normalizer, s->left.sentence, !leftNegated,
+				&stack, &top, &stackSize);
+			r1 = _need(normalizer, s->right.sentence, !negated,
+				&stack, &top, &stackSize);
+		}
+
+		if (top > pushed) continue;
+
+		Sentence nnf;
+
+		if (both)
+		{
+			// l0 and r0 have the polarity of the whole, l1 and r1 the
+			// opposite: P = Q is (P & Q) v (~P & ~Q), and ~(P = Q) is
+			// (~P & Q) v (P & ~Q)
+			nnf = negated
+				? _join(set, OR, _join(set, AND, l0, r1),
+					_join(set, AND, l1, r0))
+				: _join(set, OR, _join(set, AND, l0, r0),
+					_join(set, AND, l1, r1));
+		}
+
+		else if (s->op == MATERIAL_CONDITIONAL)
+		{
+			nnf = _join(set, negated ? AND : OR, l0, r0);
+		}
+
+		else
+		{
+			SentenceOperator op = s->op;
+			if (negated) op = op == AND ? OR : AND;
+			nnf = _join(set, op, l0, r0);
+		}
+
+		SentenceMap_put(memo, s, nnf);
+		top--;
+	}
+
+	free(stack);
+	SentenceMap_get(normalizer->positive, sentence, &result);
+	return result;
+}
+
+/// ===========================================================================
+/// Static functions - Terms
+/// ===========================================================================
+
+static void _addLiteral(struct _Terms* terms, Sentence literal)
+{
+	if (terms->numLiterals == terms->maxLiterals)
+	{
+		terms->maxLiterals *= 2;
+		terms->literals = realloc(terms->literals,
+			terms->maxLiterals * sizeof(Sentence));
+	}
+
+	terms->literals[terms->numLiterals++] = literal;
+}
+
+static void _endTerm(struct _Terms* terms)
+{
+	if (terms->numTerms == terms->maxTerms)
+	{
+		terms->maxTerms *= 2;
+		terms->ends = realloc(terms->ends, terms->maxTerms * sizeof(size_t));
+	}
+
+	terms->ends[terms->numTerms++] = terms->numLiterals;
+}
+
+static void _createTerms(struct _Terms* terms)
+{
+	terms->maxLiterals = 16;
+	terms->literals = malloc(terms->maxLiterals * sizeof(Sentence));
+	terms->numLiterals = 0;
+	terms->maxTerms = 8;
+	terms->ends = malloc(terms->maxTerms * sizeof(size_t));
+	terms->numTerms = 0;
+}
+
+static void _freeTerms(struct _Terms* terms)
+{
+	free(terms->literals);
+	free(terms->ends);
+}
+
+static struct _Term _term(const struct _Terms* terms, size_t t)
+{
+	size_t start = t ? terms->ends[t - 1] : 0;
+	return (struct _Term) {terms->literals + start, terms->ends[t] - start};
+}
+
+static int _compareLiterals(const Sentence a, const Sentence b)
+{
+	if (a->id != b->id) return a->id < b->id ? -1 : 1;
+	return (int) a->negated - (int) b->negated;
+}
+
+/**
+ * Orders terms by length, then by their literals.
+ */
+static int _compareTerms(const void* a, const void* b)
+{
+	const struct _Term* x = a;
+	const struct _Term* y = b;
+	if (x->size != y->size) return x->size < y->size ? -1 : 1;
+
+	for (size_t n = 0; n < x->size; n++)
+	{
+		int c = _compareLiterals(x->literals[n], y->literals[n]);
+		if (c) return c;
+	}
+
+	return 0;
+}
+
+/**
+ * Checks if every literal of a is in b. Both are ordered.
+ */
+static uint8_t _subset(struct _Term a, struct _Term b)
+{
+	size_t j = 0;
+
+	for (size_t i = 0; i < a.size; i++)
+	{
+		while (j < b.size && _compareLiterals(b.literals[j], a.literals[i]) < 0)
+			j++;
+		if (j == b.size || b.literals[j] != a.literals[i]) return 0;
+		j++;
+	}
+
+	return 1;
+}
+
+/**
+ * Splits a member into the parts joined by op, left to right, and adds
+ * them to the list.
+ */
+static void _split(
+	Sentence sentence,
+	SentenceOperator op,
+	Sentence** parts,
+	size_t* size,
+	size_t* buffer)
+{
+	size_t stackSize = 16;
+	Sentence* stack = malloc(stackSize * sizeof(Sentence));
+	size_t top = 0;
+	stack[top++] = sentence;
+
+	while (top > 0)
+	{
+		Sentence s = stack[--top];
+
+		if (!_isOp(s, op))
+		{
+			if (*size == *buffer)
+			{
+				*buffer *= 2;
+				*parts = realloc(*parts, *buffer * sizeof(Sentence));
+			}
+
+			(*parts)[(*size)++] = s;
+			continue;
+		}
+
+		if (top + 2 > stackSize)
+		{
+			stackSize *= 2;
+			stack = realloc(stack, stackSize * sizeof(Sentence));
+		}
+
+		stack[top++] = s->right.sentence;
+		stack[top++] = s->left.sentence;
+	}
+
+	free(stack);
+}
+
+/**
+ * Reads a DNF or CNF member back into its terms.
+ */
+static void _read(
+	Sentence sentence,
+	SentenceOperator outer,
+	SentenceOperator inner,
+	struct _Terms* terms)
+{
+	size_t numItems = 0;
+	size_t maxItems = 16;
+	Sentence* items = malloc(maxItems * sizeof(Sentence));
+	_split(sentence, outer, &items, &numItems, &maxItems);
+
+	for (size_t i = 0; i < numItems; i++)
+	{
+		_split(items[i], inner, &terms->literals, &terms->numLiterals,
+			&terms->maxLiterals);
+		_endTerm(terms);
+	}
+
+	free(items);
+}
+
+/**
+ * Orders the terms, drops the ones that contain another, and builds the
+ * member. Terms are chained from the right, as are literals.
+ */
+static Sentence _build(
+	SentenceSet set,
+	const struct _Terms* terms,
+	SentenceOperator outer,
+	SentenceOperator inner)
+{
+	struct _Term* sorted = malloc(terms->numTerms * sizeof(struct _Term));
+	for (size_t t = 0; t < terms->numTerms; t++) sorted[t] = _term(terms, t);
+	qsort(sorted, terms->numTerms, sizeof(struct _Term), _compareTerms);
+
+	// A term of the same length can only contain an equal one, which is
+	// next to it; only shorter ones have to be searched
+	size_t kept = 0;
+	size_t shorter = 0;
+
+	for (size_t t = 0; t < terms->numTerms; t++)
+	{
+		while (shorter < kept && sorted[shorter].size < sorted[t].size)
+			shorter++;
+		if (kept > shorter && !_compareTerms(&sorted[kept - 1], &sorted[t]))
+			continue;
+
+		uint8_t absorbed = 0;
+		for (size_t k = 0; k < shorter && !absorbed; k++)
+		{
+			absorbed = _subset(sorted[k], sorted[t]);
+		}
+
+		if (!absorbed) sorted[kept++] = sorted[t];
+	}
+
+	Sentence result = NULL;
+
+	for (size_t t = kept; t-- > 0;)
+	{
+		Sentence term = NULL;
+
+		for (size_t n = sorted[t].size; n-- > 0;)
+		{
+			Sentence literal = sorted[t].literals[n];
+			term = term ? SentenceSet_createCompound(set, inner, literal, term, 0)
+				: literal;
+		}
+
+		result = result ? SentenceSet_createCompound(set, outer, term, result, 0)
+			: term;
+	}
+
+	free(sorted);
+	return result;
+}
+
+/**
+ * Joins the DNF or CNF of two members. Joining them by the outer
+ * operator puts their terms together; joining them by the inner one
+ * pairs every term of one with every term of the other.
+ *
+ * @return Returns the member, or NULL if over the budget.
+ */
+static Sentence _combine(
+	const SentenceNormalizer normalizer,
+	Sentence left,
+	Sentence right,
+	uint8_t product,
+	SentenceOperator outer,
+	SentenceOperator inner)
+{
+	struct _Terms a, b, c;
+	_createTerms(&a);
+	_createTerms(&b);
+	_createTerms(&c);
+	_read(left, outer, inner, &a);
+	_read(right, outer, inner, &b);
+	Sentence result = NULL;
+
+	if (!product && a.numTerms + b.numTerms <= normalizer->budget)
+	{
+		for (size_t t = 0; t < a.numTerms + b.numTerms; t++)
+		{
+			struct _Term term = t < a.numTerms ? _term(&a, t)
+				: _term(&b, t - a.numTerms);
+			for (size_t n = 0; n < term.size; n++)
+				_addLiteral(&c, term.literals[n]);
+			_endTerm(&c);
+		}
+
+		result = _build(normalizer->set, &c, outer, inner);
+	}
+
+	else if (product && a.numTerms <= normalizer->budget / b.numTerms)
+	{
+		for (size_t i = 0; i < a.numTerms; i++)
+		{
+			for (size_t j = 0; j < b.numTerms; j++)
+			{
+				// Merges the two ordered terms
+				struct _Term x = _term(&a, i);
+				struct _Term y = _term(&b, j);
+				size_t p = 0;
+				size_t q = 0;
+
+				while (p < x.size || q < y.size)
+				{
+					int order = p == x.size ? 1 : q == y.size ? -1
+						: _compareLiterals(x.literals[p], y.literals[q]);
+					if (order <= 0) _addLiteral(&c, x.literals[p]);
+					else _addLiteral(&c, y.literals[q]);
+					if (order <= 0) p++;
+					if (order >= 0) q++;
+				}
+
+				_endTerm(&c);
+			}
+		}
+
+		result = _build(normalizer->set, &c, outer, inner);
+	}
+
+	_freeTerms(&a);
+	_freeTerms(&b);
+	_freeTerms(&c);
+	return result;
+}
+
+/**
+ * Distributes an NNF member into DNF or CNF.
+ *
+ * @return Returns the member, or NULL if over the budget.
+ */
+static Sentence _distribute(SentenceNormalizer normalizer, const Sentence nnf)
+{
+	SentenceMap memo = normalizer->distributed;
+	SentenceOperator outer = normalizer->form == NORMAL_DNF ? OR : AND;
+	SentenceOperator inner = normalizer->form == NORMAL_DNF ? AND : OR;
+	void* result;
+	if (SentenceMap_get(memo, nnf, &result)) return result;
+
+	size_t stackSize = 64;
+	Sentence* stack = malloc(stackSize * sizeof(Sentence));
+	size_t top = 0;
+	stack[top++] = nnf;
+
+	while (top > 0)
+	{
+		Sentence s = stack[top - 1];
+
+		if (SentenceMap_get(memo, s, NULL))
+		{
+			top--;
+			continue;
+		}
+
+		if (s->type == ATOMIC)
+		{
+			SentenceMap_put(memo, s, s);
+			top--;
+			continue;
+		}
+
+		void* left;
+		void* right;
+		uint8_t leftDone = SentenceMap_get(memo, s->left.sentence, &left);
+		uint8_t rightDone = SentenceMap_get(memo, s->right.sentence, &right);
+
+		if (leftDone && rightDone)
+		{
+			Sentence done = _combine(normalizer, left, right, s->op == inner,
+				outer, inner);
+
+			if (!done)
+			{
+				free(stack);
+				return NULL;
+			}
+
+			SentenceMap_put(memo, s, done);
+			top--;
+			continue;
+		}
+
+		if (top + 2 > stackSize)
+		{
+			stackSize *= 2;
+			stack = realloc(stack, stackSize * sizeof(Sentence));
+		}
+
+		if (!rightDone) stack[top++] = s->right.sentence;
+		if (!leftDone) stack[top++] = s->left.sentence;
+	}
+
+	free(stack);
+	SentenceMap_get(memo, nnf, &result);
+	return result;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceNormalizer SentenceNormalizer_create(
+	SentenceSet set,
+	NormalForm form,
+	size_t budget)
+{
+	SentenceNormalizer normalizer = malloc(sizeof(struct SentenceNormalizer_s));
+	normalizer->set = set;
+	normalizer->form = form;
+	normalizer->budget = budget;
+	normalizer->positive = SentenceMap_create();
+	normalizer->negative = SentenceMap_create();
+	normalizer->distributed = SentenceMap_create();
+	return normalizer;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceNormalizer_free(SentenceNormalizer normalizer)
+{
+	SentenceMap_free(normalizer->positive);
+	SentenceMap_free(normalizer->negative);
+	SentenceMap_free(normalizer->distributed);
+	free(normalizer);
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+Sentence SentenceNormalizer_apply(
+	SentenceNormalizer normalizer,
+	const Sentence sentence)
+{
+	Sentence nnf = _nnf(normalizer, sentence);
+	if (normalizer->form == NORMAL_NNF) return nnf;
+	return _distribute(normalizer, nnf);
+}
@@ -0,0 +1,274 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentenceoccurrence.h.
+ *
+ * Each member has a slot, numbered like set->sentences, holding its
+ * parents and the added sentences that contain it. Members come after
+ * their left and right sentences in set->sentences, and added sentences
+ * are only ever appended to set->added, so an update only has to look at
+ * the new ones.
+ *
+ * An update first files the new members under their left and right
+ * sentences, then puts each newly added sentence on the slots of
+ * everything it contains. Each walk marks the slots it visits, so shared
+ * subsentences are visited once.
+ */
+
+#include "sentenceoccurrence.h"
+#include "sentencemap.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+struct _Slot
+{
+	Sentence* parents;
+	uint32_t numParents;
+	uint32_t maxParents;
+
+	Sentence* roots;
+	uint32_t numRoots;
+	uint32_t maxRoots;
+
+	uint32_t mark;
+};
+
+/**
+ * members maps each indexed member to its slot, plus 1. variables holds
+ * two atomic members per symbol id, without and with negation. rooted is
+ * the number of the set's added sentences put on the slots.
+ */
+struct SentenceOccurrences_s
+{
+	SentenceSet set;
+	size_t indexed;
+	size_t rooted;
+
+	struct _Slot* slots;
+	size_t maxSlots;
+	SentenceMap members;
+
+	Sentence* variables;
+	size_t numVariables;
+
+	uint32_t mark;
+	size_t* reached;
+	size_t maxReached;
+};
+
+/// ===========================================================================
+/// Static functions - Slots
+/// ===========================================================================
+
+static size_t _slot(const SentenceOccurrences occurrences, const Sentence s)
+{
+	void* value;
+	SentenceMap_get(occurrences->members, s, &value);
+	return (size_t) (uintptr_t) value - 1;
+}
+
+static void _append(
+	Sentence** list,
+	uint32_t* size,
+	uint32_t* buffer,
+	Sentence sentence)
+{
+	if (*size == *buffer)
+	{
+		*buffer = *buffer ? 2 * *buffer : 2;
+		*list = realloc(*list, *buffer * sizeof(Sentence));
+	}
+
+	(*list)[(*size)++] = sentence;
+}
+
+/**
+ * Lists the slots of the members the root contains, itself included, in
+ * occurrences->reached, skipping those already marked.
+ *
+ * @return Returns the number of slots listed.
+ */
+static size_t _reach(SentenceOccurrences occurrences, const Sentence root)
+{
+	size_t first = _slot(occurrences, root);
+	if (occurrences->slots[first].mark == occurrences->mark) return 0;
+	occurrences->slots[first].mark = occurrences->mark;
+	occurrences->reached[0] = first;
+	size_t size = 1;
+
+	// The list is also the queue
+	for (size_t n = 0; n < size; n++)
+	{
+		Sentence s = occurrences->set->sentences[occurrences->reached[n]];
+		if (s->type != COMPOUND) continue;
+
+		Sentence children[2] = {s->left.sentence, s->right.sentence};
+
+		for (int c = 0; c < 2; c++)
+		{
+			size_t slot = _slot(occurrences, children[c]);
+			if (occurrences->slots[slot].mark == occurrences->mark) continue;
+			occurrences->slots[slot].mark = occurrences->mark;
+			occurrences->reached[size++] = slot;
+		}
+	}
+
+	return size;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceOccurrences SentenceOccurrences_create(SentenceSet set)
+{
+	SentenceOccurrences occurrences =
+		malloc(sizeof(struct SentenceOccurrences_s));
+	occurrences->set = set;
+	occurrences->indexed = 0;
+	occurrences->rooted = 0;
+	occurrences->maxSlots = 0;
+	occurrences->slots = NULL;
+	occurrences->members = SentenceMap_create();
+	occurrences->variables = NULL;
+	occurrences->numVariables = 0;
+	occurrences->mark = 0;
+	occurrences->maxReached = 0;
+	occurrences->reached = NULL;
+
+	SentenceOccurrences_update(occurrences);
+	return occurrences;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceOccurrences_free(SentenceOccurrences occurrences)
+{
+	for (size_t n = 0; n < occurrences->indexed; n++)
+	{
+		free(occurrences->slots[n].parents);
+		free(occurrences->slots[n].roots);
+	}
+
+	free(occurrences->slots);
+	SentenceMap_free(occurrences->members);
+	free(occurrences->variables);
+	free(occurrences->reached);
+	free(occurrences);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void SentenceOccurrences_update(SentenceOccurrences occurrences)
+{
+	SentenceSet set = occurrences->set;
+	size_t first = occurrences->indexed;
+	if (first == set->size && occurrences->rooted == set->addedCount) return;
+
+	if (set->size > occurrences->maxSlots)
+	{
+		occurrences->maxSlots = 2 * set->size;
+		occurrences->slots = realloc(occurrences->slots,
+			occurrences->maxSlots * sizeof(struct _Slot));
+		occurrences->maxReached = occurrences->maxSlots;
+		occurrences->reached = realloc(occurrences->reached,
+			occurrences->maxReached * sizeof(size_t));
+	}
+
+	for (size_t n = first; n < set->size; n++)
+	{
+		Sentence s = set->sentences[n];
+		memset(&occurrences->slots[n], 0, sizeof(struct _Slot));
+		SentenceMap_put(occurrences->members, s, (void*) (uintptr_t) (n + 1));
+
+		if (s->type == ATOMIC)
+		{
+			if (s->id >= occurrences->numVariables)
+			{
+				size_t size = 2 * (s->id + 1);
+				occurrences->variables = realloc(occurrences->variables,
+					2 * size * sizeof(Sentence));
+				memset(occurrences->variables + 2 * occurrences->numVariables,
+					0, 2 * (size - occurrences->numVariables)
+						* sizeof(Sentence));
+				occurrences->numVariables = size;
+			}
+
+			occurrences->variables[2 * s->id + s->negated] = s;
+			continue;
+		}
+
+		Sentence children[2] = {s->left.sentence, s->right.sentence};
+		int numChildren = children[0] == children[1] ? 1 : 2;
+
+		for (int c = 0; c < numChildren; c++)
+		{
+			struct _Slot* child = &occurrences->slots[
+				_slot(occurrences, children[c])];
+			_append(&child->parents, &child->numParents, &child->maxParents,
+				s);
+		}
+	}
+
+	occurrences->indexed = set->size;
+
+	for (size_t n = occurrences->rooted; n < set->addedCount; n++)
+	{
+		Sentence root = set->added[n];
+		occurrences->mark++;
+		size_t size = _reach(occurrences, root);
+
+		for (size_t r = 0; r < size; r++)
+		{
+			struct _Slot* slot = &occurrences->slots[occurrences->reached[r]];
+			_append(&slot->roots, &slot->numRoots, &slot->maxRoots, root);
+		}
+	}
+
+	occurrences->rooted = set->addedCount;
+}
+
+const Sentence* SentenceOccurrences_parents(
+	const SentenceOccurrences occurrences,
+	const Sentence sentence,
+	size_t* size)
+{
+	void* value;
+	*size = 0;
+	if (!SentenceMap_get(occurrences->members, sentence, &value)) return NULL;
+
+	struct _Slot* slot = &occurrences->slots[(uintptr_t) value - 1];
+	*size = slot->numParents;
+	return slot->parents;
+}
+
+const Sentence* SentenceOccurrences_roots(
+	const SentenceOccurrences occurrences,
+	const Sentence sentence,
+	size_t* size)
+{
+	void* value;
+	*size = 0;
+	if (!SentenceMap_get(occurrences->members, sentence, &value)) return NULL;
+
+	struct _Slot* slot = &occurrences->slots[(uintptr_t) value - 1];
+	*size = slot->numRoots;
+	return slot->roots;
+}
+
+Sentence SentenceOccurrences_variable(
+	const SentenceOccurrences occurrences,
+	uint32_t id,
+	uint8_t negated)
+{
+	if (id >= occurrences->numVariables) return NULL;
+	return occurrences->variables[2 * id + (negated ? 1 : 0)];
+}
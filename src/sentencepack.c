@@ -0,0 +1,237 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencepack.h.
+ */
+
+#include "sentencepack.h"
+#include "sentencemap.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+static uint32_t _append(SentencePack pack, PackedSentence node)
+{
+	if (pack->size == pack->buffer)
+	{
+		pack->buffer *= 2;
+		pack->nodes = realloc(pack->nodes,
+			pack->buffer * sizeof(PackedSentence));
+	}
+
+	pack->nodes[pack->size] = node;
+	return pack->size++;
+}
+
+/**
+ * Appends one sentence whose children have already been packed.
+ */
+static uint32_t _appendSentence(
+	SentencePack pack,
+	const SentenceMap indices,
+	const Sentence s)
+{
+	if (s->type == ATOMIC)
+		return SentencePack_addAtomic(pack, s->id, s->negated);
+
+	void* left;
+	void* right;
+	SentenceMap_get(indices, s->left.sentence, &left);
+	SentenceMap_get(indices, s->right.sentence, &right);
+	return SentencePack_addCompound(pack, s->op,
+		(uint32_t)(uintptr_t) left, (uint32_t)(uintptr_t) right, s->negated);
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentencePack SentencePack_create()
+{
+	SentencePack pack = malloc(sizeof(struct SentencePack_s));
+	pack->size = 0;
+	pack->buffer = SENTENCESET_BUFFER;
+	pack->nodes = malloc(pack->buffer * sizeof(PackedSentence));
+	return pack;
+}
+
+SentencePack SentencePack_fromSet(const SentenceSet set)
+{
+	SentencePack pack = SentencePack_create();
+	SentenceMap indices = SentenceMap_create();
+
+	// Members always come after their children
+	for (size_t n = 0; n < set->size; n++)
+	{
+		Sentence s = set->sentences[n];
+		uint32_t index = _appendSentence(pack, indices, s);
+		SentenceMap_put(indices, s, (void*)(uintptr_t) index);
+	}
+
+	SentenceMap_free(indices);
+	return pack;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentencePack_free(SentencePack pack)
+{
+	free(pack->nodes);
+	free(pack);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+uint32_t SentencePack_addAtomic(
+	SentencePack pack,
+	const uint32_t id,
+	const uint8_t negated)
+{
+	PackedSentence node;
+	node.left = id;
+	node.right = SENTENCEPACK_NONE;
+	node.flags = PACKED_FLAGS(ATOMIC, NO_OP, negated);
+	return _append(pack, node);
+}
+
+uint32_t SentencePack_addCompound(
+	SentencePack pack,
+	const SentenceOperator op,
+	const uint32_t left,
+	const uint32_t right,
+	const uint8_t negated)
+{
+	PackedSentence node;
+	node.left = left;
+	node.right = right;
+	node.flags = PACKED_FLAGS(COMPOUND, op, negated);
+	return _append(pack, node);
+}
+
+uint32_t SentencePack_add(SentencePack pack, const Sentence sentence)
+{
+	SentenceMap indices = SentenceMap_create();
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	stack[size++] = sentence;
+
+	// Iterative post-order walk, packing each node once its children are
+	while (size > 0)
+	{
+		Sentence s = stack[size-1];
+
+		if (SentenceMap_get(indices, s, NULL))
+		{
+			size--;
+			continue;
+		}
+
+		if (size + 2 > buffer)
+		{
+			buffer *= 2;
+			stack = realloc(stack, buffer * sizeof(Sentence));
+		}
+
+		uint8_t ready = 1;
+		if (s->type == COMPOUND)
+		{
+			if (!SentenceMap_get(indices, s->right.sentence, NULL))
+			{
+				stack[size++] = s->right.sentence;
+				ready = 0;
+			}
+			if (!SentenceMap_get(indices, s->left.sentence, NULL))
+			{
+				stack[size++] = s->left.sentence;
+				ready = 0;
+			}
+		}
+
+		if (ready)
+		{
+			uint32_t index = _appendSentence(pack, indices, s);
+			SentenceMap_put(indices, s, (void*)(uintptr_t) index);
+			size--;
+		}
+	}
+
+	void* root;
+	SentenceMap_get(indices, sentence, &root);
+	SentenceMap_free(indices);
+	free(stack);
+	return (uint32_t)(uintptr_t) root;
+}
+
+Sentence SentencePack_toSentence(
+	const SentencePack pack,
+	const uint32_t index,
+	SentenceSet set)
+{
+	return SentencePack_build(pack->nodes, index, NULL, set);
+}
+
+Sentence SentencePack_build(
+	const PackedSentence* nodes,
+	const uint32_t index,
+	const uint32_t* symbols,
+	SentenceSet set)
+{
+	// Children come before parents, so only nodes up to index are needed
+	Sentence* built = calloc(index + 1, sizeof(Sentence));
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	uint32_t* stack = malloc(buffer * sizeof(uint32_t));
+	stack[size++] = index;
+
+	while (size > 0)
+	{
+		uint32_t n = stack[size-1];
+		PackedSentence node = nodes[n];
+
+		if (built[n] != NULL)
+		{
+			size--;
+			continue;
+		}
+
+		if (!PACKED_IS_COMPOUND(node))
+		{
+			uint32_t id = symbols == NULL ? node.left : symbols[node.left];
+			built[n] = SentenceSet_createVariable(
+				set, id, PACKED_IS_NEGATED(node));
+			size--;
+			continue;
+		}
+
+		if (size + 2 > buffer)
+		{
+			buffer *= 2;
+			stack = realloc(stack, buffer * sizeof(uint32_t));
+		}
+
+		if (built[node.left] != NULL && built[node.right] != NULL)
+		{
+			built[n] = SentenceSet_createCompound(set, PACKED_OP(node),
+				built[node.left], built[node.right], PACKED_IS_NEGATED(node));
+			size--;
+			continue;
+		}
+
+		if (built[node.right] == NULL) stack[size++] = node.right;
+		if (built[node.left] == NULL) stack[size++] = node.left;
+	}
+
+	Sentence root = built[index];
+	free(built);
+	free(stack);
+	return root;
+}
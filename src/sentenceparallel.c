@@ -0,0 +1,244 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentenceparallel.h.
+ *
+ * Parsing runs in two passes over the chunks. The first counts the lines
+ * in each chunk, so every thread knows the line numbers of the chunks it
+ * parses in the second. Threads take chunks from a shared counter, and
+ * the calling thread works alongside the ones it starts.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sentenceparallel.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+/**
+ * Lines [start, end) of the corpus. line is the number of lines in the
+ * chunk after the first pass, and the number of the line before the
+ * chunk after that.
+ */
+struct _Chunk
+{
+	const char* start;
+	const char* end;
+	size_t line;
+	size_t errors;
+};
+
+struct _Job
+{
+	SentenceSet set;
+	struct _Chunk* chunks;
+	size_t numChunks;
+	size_t next;
+	SentenceCallback callback;
+	void* data;
+};
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+/**
+ * Returns the next chunk nobody has taken, or NULL when all are taken.
+ */
+static struct _Chunk* _take(struct _Job* job)
+{
+	size_t n = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+	return n < job->numChunks ? &job->chunks[n] : NULL;
+}
+
+static void* _count(void* arg)
+{
+	struct _Job* job = arg;
+	struct _Chunk* chunk;
+
+	while ((chunk = _take(job)) != NULL)
+	{
+		const char* in = chunk->start;
+		chunk->line = 0;
+
+		while ((in = memchr(in, '\n', chunk->end - in)) != NULL)
+		{
+			chunk->line++;
+			in++;
+		}
+	}
+
+	return NULL;
+}
+
+static void* _parse(void* arg)
+{
+	struct _Job* job = arg;
+	struct _Chunk* chunk;
+	SentenceSet_join(job->set);
+
+	while ((chunk = _take(job)) != NULL)
+	{
+		const char* line = chunk->start;
+		size_t number = chunk->line;
+
+		while (line < chunk->end)
+		{
+			const char* newline = memchr(line, '\n', chunk->end - line);
+			size_t len = (newline != NULL ? newline : chunk->end) - line;
+			number++;
+
+			Sentence s;
+			if (Sentence_parseLine(line, len, job->set, &s))
+			{
+				if (s == NULL) chunk->errors++;
+				if (job->callback != NULL) job->callback(s, number, job->data);
+			}
+
+			if (newline == NULL) break;
+			line = newline + 1;
+		}
+	}
+
+	SentenceSet_leave(job->set);
+	return NULL;
+}
+
+/**
+ * Runs work on up to the given number of threads, one of them the
+ * caller, and waits for all of them. Threads take chunks as they go, so
+ * the ones that start share all the work between them.
+ */
+static void _run(struct _Job* job, size_t threads, void* (*work)(void*))
+{
+	pthread_t* ids = malloc(threads * sizeof(pthread_t));
+	job->next = 0;
+
+	size_t started = 1;
+	while (started < threads
+		&& pthread_create(&ids[started], NULL, work, job) == 0)
+	{
+		started++;
+	}
+
+	work(job);
+	for (size_t n = 1; n < started; n++) pthread_join(ids[n], NULL);
+	free(ids);
+}
+
+/// ===========================================================================
+/// Function definitions
+/// ===========================================================================
+
+size_t SentenceSet_parseParallel(
+	SentenceSet set,
+	const char* corpus,
+	const size_t len,
+	size_t threads,
+	SentenceCallback callback,
+	void* data)
+{
+	if (threads == 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cores > 0 ? (size_t) cores : 1;
+	}
+
+	// Cut the corpus into chunks that end after a newline
+	size_t maxChunks = threads * SENTENCEPARALLEL_CHUNKS;
+	size_t size = len / maxChunks + 1;
+	if (size < SENTENCEPARALLEL_MIN_CHUNK) size = SENTENCEPARALLEL_MIN_CHUNK;
+
+	struct _Job job;
+	job.set = set;
+	job.chunks = malloc((len / size + 1) * sizeof(struct _Chunk));
+	job.numChunks = 0;
+	job.callback = callback;
+	job.data = data;
+
+	const char* end = corpus + len;
+	const char* in = corpus;
+
+	while (in < end)
+	{
+		const char* next = end;
+		if ((size_t)(end - in) > size)
+		{
+			const char* newline = memchr(in + size, '\n', end - in - size);
+			if (newline != NULL) next = newline + 1;
+		}
+
+		struct _Chunk* chunk = &job.chunks[job.numChunks++];
+		chunk->start = in;
+		chunk->end = next;
+		chunk->errors = 0;
+		in = next;
+	}
+
+	if (threads > job.numChunks) threads = job.numChunks;
+	if (threads == 0) threads = 1;
+
+	// Number the lines
+	_run(&job, threads, _count);
+	size_t line = 0;
+	for (size_t n = 0; n < job.numChunks; n++)
+	{
+		size_t lines = job.chunks[n].line;
+		job.chunks[n].line = line;
+		line += lines;
+	}
+
+	// Parse
+	SentenceSet_share(set);
+	_run(&job, threads, _parse);
+	SentenceSet_unshare(set);
+
+	size_t errors = 0;
+	for (size_t n = 0; n < job.numChunks; n++) errors += job.chunks[n].errors;
+
+	free(job.chunks);
+	return errors;
+}
+
+size_t SentenceSet_parseFileParallel(
+	SentenceSet set,
+	const char* path,
+	size_t threads,
+	SentenceCallback callback,
+	void* data)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return SIZE_MAX;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return SIZE_MAX;
+	}
+
+	if (st.st_size == 0)
+	{
+		close(fd);
+		return 0;
+	}
+
+	void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) return SIZE_MAX;
+
+	size_t errors = SentenceSet_parseParallel(
+		set, map, st.st_size, threads, callback, data);
+
+	munmap(map, st.st_size);
+	return errors;
+}
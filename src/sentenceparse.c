@@ -1,6 +1,22 @@
 /**
  * @author Michael Bianconi
  * @since 04-21-2019
+ *
+ * Single pass sentence parser. The input is scanned once from left to
+ * right; operands and operators are kept on explicit stacks and folded
+ * when the group (or negation scope) that holds them is closed. The
+ * input is never written to or copied: variables are interned straight
+ * from their slice of the buffer.
+ *
+ * The grammar matches the original recursive parser:
+ *
+ *   - Binary operators have no precedence and associate to the right,
+ *     so "a & b v c" is "(a & (b v c))".
+ *   - "~(" negates only the parenthesized group that follows.
+ *   - "~" followed by anything else negates the remainder of the
+ *     enclosing group, so "~a & b" is "~(a & b)".
+ *   - Variables are any run of characters other than "()~&v>=", with
+ *     surrounding spaces removed.
  */
 
 #include "sentence.h"
@@ -8,6 +24,51 @@
 #include <stdlib.h>
 #include <string.h>
 
+/// ===========================================================================
+/// Parser state
+/// ===========================================================================
+
+/**
+ * Every parenthesized group and every negation scope opens a frame. The
+ * root frame holds the whole input.
+ */
+enum _FrameType
+{
+	_ROOT,
+	_GROUP,
+	_SCOPE
+};
+
+/**
+ * Operands and operators belonging to a frame sit on the shared stacks
+ * above the frame's base indices.
+ */
+struct _Frame
+{
+	enum _FrameType type;
+	uint8_t negated;
+	size_t operands;
+	size_t operators;
+};
+
+struct _Parser
+{
+	SentenceSet set;
+	const char* end;
+
+	Sentence* operands;
+	size_t numOperands;
+	size_t maxOperands;
+
+	SentenceOperator* operators;
+	size_t numOperators;
+	size_t maxOperators;
+
+	struct _Frame* frames;
+	size_t numFrames;
+	size_t maxFrames;
+};
+
 /// ===========================================================================
 /// Static functions
 /// ===========================================================================
@@ -31,159 +92,234 @@ static SentenceOperator _getOperator(const char c)
 }
 
 /**
- * Given a sentence, find the index of its operator. If none exist, 0
- * is returned.
- *
- * a >&< b
- * a >&< (b & c)
- * (a & b) >&< (c & d)
- * ((a & b) & c) >&< (d & (e & (f & g)))
+ * Checks if the character ends a variable name.
  */
-static int _getMainOperatorIndex(const char* in)
+static uint8_t _isDelimiter(const char c)
 {
-	uint8_t numParens = 0;
-
-	for (size_t n = 0; n < strlen(in); n++)
-	{
-		if (in[n] == '(') numParens++;
-		if (in[n] == ')') numParens--;
-		SentenceOperator op = _getOperator(in[n]);
-		if (numParens == 0 && op != NO_OP) return n;
-	}
-
-	return -1;
+	return c == '\0' || c == '(' || c == ')' || c == '~'
+		|| _getOperator(c) != NO_OP;
 }
 
 /**
- * Copies the substrings to the left and right of the given index into
- * the two given buffers. The character at the split is omitted.
+ * Makes sure the buffer can hold at least one more element, doubling
+ * its capacity when full.
  *
- * @param in Sentence to split.
- * @param idx Index to split on.
- * @param left Left buffer.
- * @param right Right buffer.
+ * @param buffer Buffer to grow.
+ * @param size Number of elements in use.
+ * @param max Capacity of the buffer, updated on growth.
+ * @param elem Size of one element.
  */
-void _split(const char* in, const size_t idx, char** left, char** right)
+static void _reserve(void** buffer, size_t size, size_t* max, size_t elem)
+{
+	if (size < *max) return;
+	*max = *max == 0 ? SENTENCESET_BUFFER : *max * 2;
+	*buffer = realloc(*buffer, *max * elem);
+}
+
+static void _pushOperand(struct _Parser* p, Sentence s)
+{
+	_reserve((void**) &p->operands, p->numOperands, &p->maxOperands,
+		sizeof(Sentence));
+	p->operands[p->numOperands++] = s;
+}
+
+static void _pushOperator(struct _Parser* p, SentenceOperator op)
+{
+	_reserve((void**) &p->operators, p->numOperators, &p->maxOperators,
+		sizeof(SentenceOperator));
+	p->operators[p->numOperators++] = op;
+}
+
+static void _pushFrame(struct _Parser* p, enum _FrameType type, uint8_t neg)
 {
-	*left = calloc(idx+1,1);
-	*right = calloc(strlen(in)-idx+1,1);
-	strncpy(*left, in, idx);
-	strncpy(*right, in+idx+1, strlen(in)-idx-1);
+	_reserve((void**) &p->frames, p->numFrames, &p->maxFrames,
+		sizeof(struct _Frame));
+	struct _Frame* f = &p->frames[p->numFrames++];
+	f->type = type;
+	f->negated = neg;
+	f->operands = p->numOperands;
+	f->operators = p->numOperators;
 }
 
 /**
- * Given a string and the index of a paren, return the index of the
- * matching paren.
+ * Pops the top frame and folds its operands from the right, creating one
+ * compound sentence per operator.
  *
- * @pre string[index] must equal '(' or ')'
- * @pre the paren must have a matching paren
- * @pre the string must be null-terminated
- * @param string String to search
- * @param index Index of the paren
- * @return Returns the index of the matching paren, or the given index
- *         if not found.
+ * @pre The frame holds at least one operand.
+ * @return Returns the sentence the frame reduces to.
  */
-static size_t _getMatchingParen(const char* string, size_t index)
+static Sentence _popFrame(struct _Parser* p)
 {
-	if (index >= strlen(string)) return index;
-	if (string[index] != ')' && string[index] != '(') return index;
+	struct _Frame f = p->frames[--p->numFrames];
+	Sentence result = p->operands[--p->numOperands];
 
-	int8_t dir = string[index] == '(' ? 1 : -1; // direction to search
-	int8_t numParens = 0; // if 0, then matching paren found
-
-	// search string
-	while (index < strlen(string))
+	while (p->numOperators > f.operators)
 	{
-		if (string[index] == '(') numParens++;
-		else if (string[index] == ')') numParens--;
-		if (numParens == 0 || (index == 0 && dir < 0)) break;
-		index += dir;
+		SentenceOperator op = p->operators[--p->numOperators];
+		Sentence left = p->operands[--p->numOperands];
+		result = SentenceSet_createCompound(p->set, op, left, result, 0);
 	}
 
-	// Loop exited without finding the matching paren
-	if (numParens != 0) return index;
-
-	return index;
+	if (f.negated) result = SentenceSet_negate(p->set, result, 1);
+	return result;
 }
 
-
 /**
- * Checks if the entire string is enclosed in one set of parens.
+ * Closes every negation scope on top of the frame stack. Scopes end where
+ * their enclosing group ends.
  */
-static uint8_t _isEnclosed(const char* in)
+static void _closeScopes(struct _Parser* p)
 {
-	if (strlen(in) == 0) return 0;
-	if (in[0] != '(') return 0;
-	size_t match = _getMatchingParen(in, 0);
-	return match == strlen(in)-1;
+	while (p->frames[p->numFrames-1].type == _SCOPE)
+	{
+		Sentence s = _popFrame(p);
+		_pushOperand(p, s);
+	}
 }
 
-
 /**
- * Checks if the <i>entire</i> string is negated.
+ * Reads a variable starting at in and pushes it as an atomic sentence.
+ *
+ * @return Returns a pointer to the first character after the variable.
  */
-static uint8_t _isNegated(char* in)
+static const char* _readAtomic(struct _Parser* p, const char* in)
 {
-	if (strlen(in) == 0) return 0; // empty string
-	if (in[0] != '~') return 0; // not negated
-	if (in[1] != '(') return 1; // not compound
-	return _isEnclosed(in+1); // sentence is enclosed in parens
-}
+	const char* end = in;
+	while (end < p->end && !_isDelimiter(*end)) end++;
 
+	size_t len = end - in;
+	while (len > 0 && in[len-1] == ' ') len--;
 
-/// ===========================================================================
-Sentence Sentence_parseString(char* in, SentenceSet* set)
+	uint32_t id = Symbol_intern(in, len);
+	_pushOperand(p, SentenceSet_createVariable(p->set, id, 0));
+	return end;
+}
+
+/**
+ * Runs the parser over the whole input.
+ *
+ * @return Returns the root sentence, or NULL if the input is malformed.
+ */
+static Sentence _parse(struct _Parser* p, const char* in)
 {
-	// Ignore whitespace
-	if (in[0] == ' ') return Sentence_parseString(in+1, set);
+	uint8_t expectOperand = 1;
+	_pushFrame(p, _ROOT, 0);
 
-	//  Trim whitespace from the end
-	if (in[strlen(in)-1] == ' ')
+	while (1)
 	{
-		in[strlen(in)-1] = '\0';
-		return Sentence_parseString(in, set);
-	}
+		char c = in < p->end ? *in : '\0';
 
-	// If enclosed, remove parens
-	if (_isEnclosed(in))
-	{
-		in[strlen(in)-1] = '\0';
-		return Sentence_parseString(in+1, set);
-	}
+		if (c == ' ')
+		{
+			in++;
+		}
 
-	// If negated, flag and recurse
-	if (_isNegated(in))
-	{
-		Sentence negated = Sentence_parseString(in+1, set);
-		negated->negated = 1;
-		SentenceSet_add(*set, negated);
-		return negated;
+		else if (expectOperand)
+		{
+			if (c == '(')
+			{
+				_pushFrame(p, _GROUP, 0);
+				in++;
+			}
+			else if (c == '~' && in + 1 < p->end && in[1] == '(')
+			{
+				_pushFrame(p, _GROUP, 1);
+				in += 2;
+			}
+			else if (c == '~')
+			{
+				_pushFrame(p, _SCOPE, 1);
+				in++;
+			}
+			else if (_isDelimiter(c))
+			{
+				return NULL;
+			}
+			else
+			{
+				in = _readAtomic(p, in);
+				expectOperand = 0;
+			}
+		}
+
+		else if (_getOperator(c) != NO_OP)
+		{
+			_pushOperator(p, _getOperator(c));
+			expectOperand = 1;
+			in++;
+		}
+
+		else if (c == ')')
+		{
+			_closeScopes(p);
+			if (p->frames[p->numFrames-1].type != _GROUP) return NULL;
+			Sentence s = _popFrame(p);
+			_pushOperand(p, s);
+			in++;
+		}
+
+		else if (c == '\0')
+		{
+			if (in < p->end) return NULL;
+			_closeScopes(p);
+			if (p->frames[p->numFrames-1].type != _ROOT) return NULL;
+			return _popFrame(p);
+		}
+
+		else
+		{
+			return NULL;
+		}
 	}
+}
+
+/// ===========================================================================
+/// Function definitions
+/// ===========================================================================
+
+Sentence Sentence_parse(const char* in, SentenceSet set)
+{
+	return Sentence_parseBuffer(in, strlen(in), set);
+}
+
+Sentence Sentence_parseBuffer(
+	const char* in,
+	const size_t len,
+	SentenceSet set)
+{
+	struct _Parser parser = {0};
+	parser.set = set;
+	parser.end = in + len;
+
+	Sentence root = _parse(&parser, in);
+	if (root != NULL) SentenceSet_add(set, root);
 
-	// Get the index of the main connective
-	int opIdx = _getMainOperatorIndex(in);
+	free(parser.operands);
+	free(parser.operators);
+	free(parser.frames);
+	return root;
+}
 
-	// If atomic, return atomic sentence
-	if (opIdx == -1)
+uint8_t Sentence_parseLine(
+	const char* line,
+	const size_t len,
+	SentenceSet set,
+	Sentence* sentence)
+{
+	uint8_t blank = 1;
+	for (size_t n = 0; n < len && blank; n++)
 	{
-		Sentence atomic = Sentence_createAtomic(in, 0);
-		SentenceSet_add(*set, atomic);
-		return atomic;
+		blank = line[n] == ' ' || line[n] == '\t' || line[n] == '\r';
 	}
 
-	// If compound, split into left and right and recurse
-	char* leftIn;
-	char* rightIn;
-	_split(in, opIdx, &leftIn, &rightIn);
-	Sentence left = Sentence_parseString(leftIn, set);
-	Sentence right = Sentence_parseString(rightIn, set);
-	SentenceOperator op = _getOperator(in[opIdx]);
-	Sentence compound = Sentence_createCompound(op, left, right, 0);
-	free(leftIn);
-	free(rightIn);
-	SentenceSet_add(*set, left);
-	SentenceSet_add(*set, right);
-	SentenceSet_add(*set, compound);
-
-	return compound;
+	if (blank) return 0;
+
+	*sentence = Sentence_parseBuffer(line,
+		line[len-1] == '\r' ? len - 1 : len, set);
+	return 1;
+}
+
+Sentence Sentence_parseString(char* in, SentenceSet* set)
+{
+	return Sentence_parse(in, *set);
 }
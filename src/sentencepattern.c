@@ -0,0 +1,648 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencepattern.h.
+ *
+ * Every node of a sentence is read as a symbol: an atomic sentence by
+ * its variable, a compound one by its operator, and either one below the
+ * depth limit as a "deep" symbol with no children. Negation flags are
+ * part of the symbol. A sentence's path is its symbols in preorder; since
+ * the number of children follows from the symbol, the path of one
+ * sentence is never the start of another's, and members are filed only
+ * at leaves.
+ *
+ * A node's children are a linked list, for passing over subsentences,
+ * and are also found by symbol in a table of edges keyed by the parent
+ * node and the symbol. The walks are recursive, but no deeper than the
+ * longest path, which the depth limit bounds.
+ */
+
+#include "sentencepattern.h"
+#include <string.h>
+#include <ctype.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+#define _ATOMIC 1
+#define _COMPOUND 2
+#define _DEEP 3
+#define _META 4
+
+#define _SYMBOL(kind, negated, payload) \
+	(((uint64_t) (kind) << 40) | ((uint64_t) (negated) << 39) | (payload))
+#define _KIND(symbol) ((symbol) >> 40)
+
+/**
+ * child and sibling are node indices, 0 for none, since the root is no
+ * one's child. members is the first member filed here, plus 1.
+ */
+struct _Node
+{
+	uint64_t symbol;
+	uint32_t child;
+	uint32_t sibling;
+	uint32_t members;
+};
+
+/**
+ * Empty slots have a child of 0.
+ */
+struct _Edge
+{
+	uint64_t symbol;
+	uint32_t parent;
+	uint32_t child;
+};
+
+struct _Member
+{
+	Sentence sentence;
+	uint32_t next;
+};
+
+struct SentenceIndex_s
+{
+	SentenceSet set;
+	size_t indexed;
+
+	struct _Node* nodes;
+	size_t numNodes;
+	size_t maxNodes;
+
+	struct _Edge* edges;
+	size_t tableSize;
+
+	struct _Member* members;
+	size_t numMembers;
+	size_t maxMembers;
+};
+
+/**
+ * A node of a sentence, or of a pattern, and its level.
+ */
+struct _Position
+{
+	Sentence sentence;
+	size_t depth;
+};
+
+struct _Pair
+{
+	Sentence pattern;
+	Sentence sentence;
+};
+
+struct _Query
+{
+	SentenceIndex index;
+	SentencePattern pattern;
+	Sentence* bindings;
+	uint8_t* flipped;
+	SentenceMatchCallback callback;
+	void* data;
+	size_t matches;
+	uint8_t stopped;
+};
+
+/// ===========================================================================
+/// Static functions - Symbols
+/// ===========================================================================
+
+static uint8_t _isMeta(const Sentence sentence)
+{
+	return sentence->type == ATOMIC
+		&& isupper((unsigned char) Symbol_name(sentence->id)[0]);
+}
+
+static uint64_t _symbol(const Sentence sentence, size_t depth)
+{
+	if (depth >= SENTENCEINDEX_DEPTH)
+	{
+		return _SYMBOL(_DEEP, sentence->negated, 0);
+	}
+
+	if (sentence->type == ATOMIC)
+	{
+		return _SYMBOL(_ATOMIC, sentence->negated, sentence->id);
+	}
+
+	return _SYMBOL(_COMPOUND, sentence->negated, sentence->op);
+}
+
+static size_t _arity(uint64_t symbol)
+{
+	return _KIND(symbol) == _COMPOUND ? 2 : 0;
+}
+
+/**
+ * Lists the symbols of the sentence in preorder, down to the depth
+ * limit. In a pattern, each metavariable is one symbol.
+ *
+ * @return Returns a malloc'd array.
+ */
+static uint64_t* _path(const Sentence sentence, uint8_t pattern, size_t* size)
+{
+	size_t buffer = 16;
+	uint64_t* path = malloc(buffer * sizeof(uint64_t));
+	struct _Position stack[2 * SENTENCEINDEX_DEPTH + 2];
+	size_t top = 0;
+	*size = 0;
+	stack[top++] = (struct _Position) {sentence, 0};
+
+	while (top > 0)
+	{
+		struct _Position p = stack[--top];
+
+		if (*size == buffer)
+		{
+			buffer *= 2;
+			path = realloc(path, buffer * sizeof(uint64_t));
+		}
+
+		if (pattern && _isMeta(p.sentence))
+		{
+			path[(*size)++] = _SYMBOL(_META, 0, 0);
+			continue;
+		}
+
+		uint64_t symbol = _symbol(p.sentence, p.depth);
+		path[(*size)++] = symbol;
+
+		if (_arity(symbol))
+		{
+			stack[top++] = (struct _Position)
+				{p.sentence->right.sentence, p.depth + 1};
+			stack[top++] = (struct _Position)
+				{p.sentence->left.sentence, p.depth + 1};
+		}
+	}
+
+	return path;
+}
+
+/// ===========================================================================
+/// Static functions - Tree
+/// ===========================================================================
+
+static size_t _slot(const SentenceIndex index, uint32_t parent, uint64_t symbol)
+{
+	uint64_t hash = (symbol * 0x9e3779b97f4a7c15ULL) ^ parent;
+	hash ^= hash >> 29;
+	size_t i = (size_t) (hash * 0xbf58476d1ce4e5b9ULL >> 32)
+		& (index->tableSize - 1);
+
+	while (index->edges[i].child
+		&& (index->edges[i].parent != parent
+			|| index->edges[i].symbol != symbol))
+	{
+		i = (i + 1) & (index->tableSize - 1);
+	}
+
+	return i;
+}
+
+/**
+ * Returns the child of the node with the symbol, adding it if missing
+ * and add is set, or 0.
+ */
+static uint32_t _child(
+	SentenceIndex index,
+	uint32_t parent,
+	uint64_t symbol,
+	uint8_t add)
+{
+	size_t i = _slot(index, parent, symbol);
+	if (index->edges[i].child || !add) return index->edges[i].child;
+
+	if (index->numNodes == index->maxNodes)
+	{
+		index->maxNodes *= 2;
+		index->nodes = realloc(index->nodes,
+			index->maxNodes * sizeof(struct _Node));
+	}
+
+	uint32_t child = index->numNodes++;
+	index->nodes[child] = (struct _Node)
+		{symbol, 0, index->nodes[parent].child, 0};
+	index->nodes[parent].child = child;
+	index->edges[i] = (struct _Edge) {symbol, parent, child};
+
+	// Edges are one fewer than nodes
+	if (2 * index->numNodes > index->tableSize)
+	{
+		struct _Edge* old = index->edges;
+		size_t oldSize = index->tableSize;
+		index->tableSize *= 2;
+		index->edges = calloc(index->tableSize, sizeof(struct _Edge));
+
+		for (size_t n = 0; n < oldSize; n++)
+		{
+			if (!old[n].child) continue;
+			index->edges[_slot(index, old[n].parent, old[n].symbol)] = old[n];
+		}
+
+		free(old);
+	}
+
+	return child;
+}
+
+static void _insert(SentenceIndex index, const Sentence sentence)
+{
+	size_t size;
+	uint64_t* path = _path(sentence, 0, &size);
+	uint32_t node = 0;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		node = _child(index, node, path[i], 1);
+	}
+
+	free(path);
+
+	if (index->numMembers == index->maxMembers)
+	{
+		index->maxMembers *= 2;
+		index->members = realloc(index->members,
+			index->maxMembers * sizeof(struct _Member));
+	}
+
+	index->members[index->numMembers] = (struct _Member)
+		{sentence, index->nodes[node].members};
+	index->nodes[node].members = ++index->numMembers;
+}
+
+/// ===========================================================================
+/// Static functions - Matching
+/// ===========================================================================
+
+/**
+ * Checks if the sentences differ only in their negation flags.
+ */
+static uint8_t _sameBase(const Sentence a, const Sentence b)
+{
+	if (a->type != b->type) return 0;
+	if (a->type == ATOMIC) return a->id == b->id;
+	return a->op == b->op && a->left.sentence == b->left.sentence
+		&& a->right.sentence == b->right.sentence;
+}
+
+/**
+ * Matches the sentence without adding to its set. Each metavariable is
+ * bound to a member, and flipped if it stands for the member's negation,
+ * which the set may not have yet.
+ */
+static uint8_t _match(
+	const SentencePattern pattern,
+	const Sentence sentence,
+	Sentence* bound,
+	uint8_t* flipped)
+{
+	memset(bound, 0, pattern->numVariables * sizeof(Sentence));
+
+	struct _Pair localStack[32];
+	struct _Pair* stack = localStack;
+	size_t stackSize = 32;
+	size_t top = 0;
+	uint8_t matches = 1;
+	stack[top++] = (struct _Pair) {pattern->sentence, sentence};
+
+	while (top > 0 && matches)
+	{
+		struct _Pair pair = stack[--top];
+		Sentence p = pair.pattern;
+		Sentence s = pair.sentence;
+
+		if (_isMeta(p))
+		{
+			size_t k = 0;
+			while (pattern->variables[k] != p->id) k++;
+
+			// ~P matches S when P matches ~S, and ~~S is S
+			if (!bound[k])
+			{
+				bound[k] = s;
+				flipped[k] = p->negated;
+			}
+
+			else if (flipped[k] == p->negated)
+			{
+				matches = bound[k] == s;
+			}
+
+			else
+			{
+				matches = bound[k]->negated != s->negated
+					&& _sameBase(bound[k], s);
+			}
+
+			continue;
+		}
+
+		if (p->negated != s->negated || p->type != s->type)
+		{
+			matches = 0;
+		}
+
+		else if (p->type == ATOMIC)
+		{
+			matches = p->id == s->id;
+		}
+
+		else if (p->op != s->op)
+		{
+			matches = 0;
+		}
+
+		else
+		{
+			if (top + 2 > stackSize)
+			{
+				stackSize *= 2;
+				struct _Pair* grown = malloc(stackSize * sizeof(struct _Pair));
+				memcpy(grown, stack, top * sizeof(struct _Pair));
+				if (stack != localStack) free(stack);
+				stack = grown;
+			}
+
+			stack[top++] = (struct _Pair)
+				{p->right.sentence, s->right.sentence};
+			stack[top++] = (struct _Pair)
+				{p->left.sentence, s->left.sentence};
+		}
+	}
+
+	if (stack != localStack) free(stack);
+	return matches;
+}
+
+/**
+ * Turns the bindings of a match into the sentences they stand for,
+ * adding the negations of flipped ones to the set.
+ */
+static void _bind(
+	SentenceSet set,
+	const SentencePattern pattern,
+	Sentence* bound,
+	const uint8_t* flipped)
+{
+	for (size_t k = 0; k < pattern->numVariables; k++)
+	{
+		if (!flipped[k]) continue;
+
+		bound[k] = SentenceSet_negate(set, bound[k], !bound[k]->negated);
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Search
+/// ===========================================================================
+
+static void _walk(struct _Query* q, uint32_t node, size_t item);
+
+/**
+ * Passes over count whole subsentences below the node, then walks on.
+ */
+static void _skip(struct _Query* q, uint32_t node, size_t count, size_t item)
+{
+	if (count == 0)
+	{
+		_walk(q, node, item);
+		return;
+	}
+
+	const struct _Node* nodes = q->index->nodes;
+
+	for (uint32_t c = nodes[node].child; c && !q->stopped; c = nodes[c].sibling)
+	{
+		_skip(q, c, count - 1 + _arity(nodes[c].symbol), item);
+	}
+}
+
+/**
+ * Matches the members filed at a leaf in full, and reports them.
+ */
+static void _report(struct _Query* q, uint32_t node)
+{
+	SentenceIndex index = q->index;
+
+	for (uint32_t m = index->nodes[node].members; m && !q->stopped;)
+	{
+		Sentence sentence = index->members[m - 1].sentence;
+		m = index->members[m - 1].next;
+
+		if (!_match(q->pattern, sentence, q->bindings, q->flipped))
+		{
+			continue;
+		}
+
+		q->matches++;
+		if (!q->callback) continue;
+
+		_bind(index->set, q->pattern, q->bindings, q->flipped);
+
+		if (!q->callback(sentence, q->bindings, q->data))
+		{
+			q->stopped = 1;
+		}
+	}
+}
+
+/**
+ * Follows the pattern's path from the given item on.
+ */
+static void _walk(struct _Query* q, uint32_t node, size_t item)
+{
+	if (q->stopped) return;
+
+	if (item == q->pattern->numItems)
+	{
+		_report(q, node);
+		return;
+	}
+
+	uint64_t symbol = q->pattern->items[item];
+
+	if (_KIND(symbol) == _META)
+	{
+		_skip(q, node, 1, item + 1);
+	}
+
+	else
+	{
+		uint32_t child = _child(q->index, node, symbol, 0);
+		if (child) _walk(q, child, item + 1);
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentencePattern SentencePattern_create(const Sentence sentence)
+{
+	SentencePattern pattern = malloc(sizeof(struct SentencePattern_s));
+	pattern->sentence = sentence;
+	pattern->items = _path(sentence, 1, &pattern->numItems);
+	pattern->numVariables = 0;
+
+	size_t buffer = 4;
+	pattern->variables = malloc(buffer * sizeof(uint32_t));
+	size_t stackSize = 16;
+	Sentence* stack = malloc(stackSize * sizeof(Sentence));
+	size_t top = 0;
+	stack[top++] = sentence;
+
+	while (top > 0)
+	{
+		Sentence s = stack[--top];
+
+		if (_isMeta(s))
+		{
+			uint8_t seen = 0;
+			for (size_t i = 0; i < pattern->numVariables && !seen; i++)
+			{
+				seen = pattern->variables[i] == s->id;
+			}
+
+			if (seen) continue;
+
+			if (pattern->numVariables == buffer)
+			{
+				buffer *= 2;
+				pattern->variables = realloc(pattern->variables,
+					buffer * sizeof(uint32_t));
+			}
+
+			pattern->variables[pattern->numVariables++] = s->id;
+		}
+
+		else if (s->type == COMPOUND)
+		{
+			if (top + 2 > stackSize)
+			{
+				stackSize *= 2;
+				stack = realloc(stack, stackSize * sizeof(Sentence));
+			}
+
+			stack[top++] = s->right.sentence;
+			stack[top++] = s->left.sentence;
+		}
+	}
+
+	free(stack);
+	return pattern;
+}
+
+SentenceIndex SentenceIndex_create(SentenceSet set)
+{
+	SentenceIndex index = malloc(sizeof(struct SentenceIndex_s));
+	index->set = set;
+	index->indexed = 0;
+
+	index->maxNodes = 64;
+	index->nodes = malloc(index->maxNodes * sizeof(struct _Node));
+	index->nodes[0] = (struct _Node) {0, 0, 0, 0};
+	index->numNodes = 1;
+
+	index->tableSize = 128;
+	index->edges = calloc(index->tableSize, sizeof(struct _Edge));
+
+	index->maxMembers = 64;
+	index->members = malloc(index->maxMembers * sizeof(struct _Member));
+	index->numMembers = 0;
+
+	SentenceIndex_update(index);
+	return index;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentencePattern_free(SentencePattern pattern)
+{
+	free(pattern->variables);
+	free(pattern->items);
+	free(pattern);
+}
+
+void SentenceIndex_free(SentenceIndex index)
+{
+	free(index->nodes);
+	free(index->edges);
+	free(index->members);
+	free(index);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void SentenceIndex_update(SentenceIndex index)
+{
+	for (; index->indexed < index->set->size; index->indexed++)
+	{
+		_insert(index, index->set->sentences[index->indexed]);
+	}
+}
+
+size_t SentenceIndex_size(const SentenceIndex index)
+{
+	return index->numMembers;
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+uint8_t SentencePattern_match(
+	SentenceSet set,
+	const SentencePattern pattern,
+	const Sentence sentence,
+	Sentence* bindings)
+{
+	Sentence localBound[16];
+	uint8_t localFlipped[16];
+	Sentence* bound = bindings ? bindings : localBound;
+	uint8_t* flipped = localFlipped;
+
+	if (pattern->numVariables > 16)
+	{
+		if (!bindings) bound = malloc(pattern->numVariables * sizeof(Sentence));
+		flipped = malloc(pattern->numVariables);
+	}
+
+	uint8_t matches = _match(pattern, sentence, bound, flipped);
+	if (matches && bindings) _bind(set, pattern, bound, flipped);
+
+	if (bound != bindings && bound != localBound) free(bound);
+	if (flipped != localFlipped) free(flipped);
+	return matches;
+}
+
+size_t SentenceIndex_match(
+	SentenceIndex index,
+	const SentencePattern pattern,
+	SentenceMatchCallback callback,
+	void* data)
+{
+	struct _Query q;
+	q.index = index;
+	q.pattern = pattern;
+	q.bindings = malloc((pattern->numVariables + 1) * sizeof(Sentence));
+	q.flipped = malloc(pattern->numVariables + 1);
+	q.callback = callback;
+	q.data = data;
+	q.matches = 0;
+	q.stopped = 0;
+
+	_walk(&q, 0, 0);
+
+	free(q.bindings);
+	free(q.flipped);
+	return q.matches;
+}
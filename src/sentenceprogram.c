@@ -0,0 +1,359 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentenceprogram.h.
+ *
+ * Compiling takes two walks over the sentence. The first counts how
+ * often each distinct node is referenced; the second emits the program,
+ * giving a slot to every compound node referenced more than once. Both
+ * the single and the batch interpreter run on 64-bit words, a single
+ * assignment being a word of all zeros or all ones.
+ */
+
+#include "sentenceprogram.h"
+#include "sentencemap.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Static functions - Compiling
+/// ===========================================================================
+
+struct _Compiler
+{
+	SentenceProgram program;
+	size_t maxCode;
+	size_t depth;
+};
+
+static void _emit(struct _Compiler* c, SentenceOpcode opcode, uint32_t operand)
+{
+	SentenceProgram p = c->program;
+
+	if (p->size == c->maxCode)
+	{
+		c->maxCode *= 2;
+		p->code = realloc(p->code, c->maxCode * sizeof(SentenceInstruction));
+	}
+
+	p->code[p->size].opcode = opcode;
+	p->code[p->size].operand = operand;
+	p->size++;
+
+	if (opcode == OPCODE_LOAD || opcode == OPCODE_FETCH) c->depth++;
+	else if (opcode != OPCODE_STORE && opcode != OPCODE_NOT) c->depth--;
+	if (c->depth > p->maxStack) p->maxStack = c->depth;
+}
+
+static SentenceOpcode _opcode(SentenceOperator op)
+{
+	switch (op)
+	{
+		case AND: return OPCODE_AND;
+		case OR: return OPCODE_OR;
+		case MATERIAL_CONDITIONAL: return OPCODE_IMPLIES;
+		default: return OPCODE_IFF;
+	}
+}
+
+/**
+ * Maps every distinct node of the sentence to the number of times it is
+ * referenced.
+ */
+static SentenceMap _countReferences(const Sentence sentence)
+{
+	SentenceMap counts = SentenceMap_create();
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	stack[size++] = sentence;
+
+	while (size > 0)
+	{
+		Sentence s = stack[--size];
+		void* count = NULL;
+		SentenceMap_get(counts, s, &count);
+		SentenceMap_put(counts, s, (void*)((uintptr_t) count + 1));
+		if (count != NULL || s->type == ATOMIC) continue;
+
+		if (size + 2 > buffer)
+		{
+			buffer *= 2;
+			stack = realloc(stack, buffer * sizeof(Sentence));
+		}
+
+		stack[size++] = s->right.sentence;
+		stack[size++] = s->left.sentence;
+	}
+
+	free(stack);
+	return counts;
+}
+
+/**
+ * A node on the emission stack: 0 before its left sentence, 1 before its
+ * right sentence, 2 when both are emitted.
+ */
+struct _Step
+{
+	Sentence sentence;
+	uint8_t state;
+};
+
+static void _emitAll(struct _Compiler* c, const Sentence sentence)
+{
+	SentenceMap counts = _countReferences(sentence);
+	SentenceMap slots = SentenceMap_create();
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	struct _Step* stack = malloc(buffer * sizeof(struct _Step));
+	stack[size++] = (struct _Step) {sentence, 0};
+
+	while (size > 0)
+	{
+		struct _Step* step = &stack[size-1];
+		Sentence s = step->sentence;
+		void* slot = NULL;
+
+		if (step->state == 0 && SentenceMap_get(slots, s, &slot))
+		{
+			_emit(c, OPCODE_FETCH, (uint32_t)(uintptr_t) slot);
+			size--;
+			continue;
+		}
+
+		if (s->type == COMPOUND && step->state < 2)
+		{
+			Sentence next = step->state == 0
+				? s->left.sentence : s->right.sentence;
+			step->state++;
+
+			if (size == buffer)
+			{
+				buffer *= 2;
+				stack = realloc(stack, buffer * sizeof(struct _Step));
+			}
+
+			stack[size++] = (struct _Step) {next, 0};
+			continue;
+		}
+
+		if (s->type == ATOMIC) _emit(c, OPCODE_LOAD, s->id);
+		else _emit(c, _opcode(s->op), 0);
+		if (s->negated) _emit(c, OPCODE_NOT, 0);
+
+		void* count = NULL;
+		SentenceMap_get(counts, s, &count);
+		if (s->type == COMPOUND && (uintptr_t) count > 1)
+		{
+			uint32_t index = c->program->numSlots++;
+			SentenceMap_put(slots, s, (void*)(uintptr_t) index);
+			_emit(c, OPCODE_STORE, index);
+		}
+
+		size--;
+	}
+
+	free(stack);
+	SentenceMap_free(slots);
+	SentenceMap_free(counts);
+}
+
+static int _compareIds(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Replaces the symbol ids in LOAD instructions with indices into the
+ * program's sorted variable list.
+ */
+static void _numberVariables(SentenceProgram p)
+{
+	p->variables = malloc((p->size + 1) * sizeof(uint32_t));
+	p->numVariables = 0;
+
+	for (size_t n = 0; n < p->size; n++)
+	{
+		if (p->code[n].opcode == OPCODE_LOAD)
+			p->variables[p->numVariables++] = p->code[n].operand;
+	}
+
+	qsort(p->variables, p->numVariables, sizeof(uint32_t), _compareIds);
+	size_t unique = 0;
+	for (size_t n = 0; n < p->numVariables; n++)
+	{
+		if (unique == 0 || p->variables[unique-1] != p->variables[n])
+			p->variables[unique++] = p->variables[n];
+	}
+	p->numVariables = unique;
+
+	for (size_t n = 0; n < p->size; n++)
+	{
+		if (p->code[n].opcode != OPCODE_LOAD) continue;
+		uint32_t* var = bsearch(&p->code[n].operand, p->variables,
+			p->numVariables, sizeof(uint32_t), _compareIds);
+		p->code[n].operand = var - p->variables;
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Interpreter
+/// ===========================================================================
+
+/**
+ * Runs the program over one word of assignments. columns holds the word
+ * of each variable; stack and slots must have room for maxStack and
+ * numSlots words.
+ */
+static uint64_t _execute(
+	const SentenceProgram p,
+	const uint64_t* columns,
+	uint64_t* stack,
+	uint64_t* slots)
+{
+	const SentenceInstruction* in = p->code;
+	const SentenceInstruction* end = in + p->size;
+	size_t top = 0;
+
+	for (; in < end; in++)
+	{
+		switch (in->opcode)
+		{
+			case OPCODE_LOAD:
+				stack[top++] = columns[in->operand];
+				break;
+			case OPCODE_FETCH:
+				stack[top++] = slots[in->operand];
+				break;
+			case OPCODE_STORE:
+				slots[in->operand] = stack[top-1];
+				break;
+			case OPCODE_NOT:
+				stack[top-1] = ~stack[top-1];
+				break;
+			case OPCODE_AND:
+				top--;
+				stack[top-1] &= stack[top];
+				break;
+			case OPCODE_OR:
+				top--;
+				stack[top-1] |= stack[top];
+				break;
+			case OPCODE_IMPLIES:
+				top--;
+				stack[top-1] = ~stack[top-1] | stack[top];
+				break;
+			case OPCODE_IFF:
+				top--;
+				stack[top-1] = ~(stack[top-1] ^ stack[top]);
+				break;
+		}
+	}
+
+	return stack[0];
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceProgram SentenceProgram_compile(const Sentence sentence)
+{
+	SentenceProgram program = malloc(sizeof(struct SentenceProgram_s));
+	program->size = 0;
+	program->numSlots = 0;
+	program->maxStack = 0;
+
+	struct _Compiler c;
+	c.program = program;
+	c.maxCode = SENTENCESET_BUFFER;
+	c.depth = 0;
+	program->code = malloc(c.maxCode * sizeof(SentenceInstruction));
+
+	_emitAll(&c, sentence);
+	_numberVariables(program);
+	return program;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceProgram_free(SentenceProgram program)
+{
+	free(program->code);
+	free(program->variables);
+	free(program);
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+uint8_t SentenceProgram_evaluate(
+	const SentenceProgram program,
+	const uint8_t* values)
+{
+	// Small programs run without touching the heap
+	uint64_t local[64];
+	size_t need = program->numVariables + program->maxStack + program->numSlots;
+	uint64_t* memory = need <= 64 ? local : malloc(need * sizeof(uint64_t));
+
+	uint64_t* columns = memory;
+	for (size_t n = 0; n < program->numVariables; n++)
+	{
+		columns[n] = values[program->variables[n]] ? ~0ULL : 0;
+	}
+
+	// Every slot is stored before it is fetched, but zeroing the words
+	// lets the compiler see that too
+	uint64_t* stack = columns + program->numVariables;
+	memset(stack, 0, (program->maxStack + program->numSlots)
+		* sizeof(uint64_t));
+	uint64_t result = _execute(program, columns, stack,
+		stack + program->maxStack);
+
+	if (memory != local) free(memory);
+	return result & 1;
+}
+
+void SentenceProgram_evaluateBatch(
+	const SentenceProgram program,
+	const uint8_t* assignments,
+	const size_t count,
+	const size_t stride,
+	uint8_t* results)
+{
+	size_t need = program->numVariables + program->maxStack + program->numSlots;
+	uint64_t* columns = malloc((need + 1) * sizeof(uint64_t));
+	uint64_t* stack = columns + program->numVariables;
+	uint64_t* slots = stack + program->maxStack;
+
+	for (size_t first = 0; first < count; first += 64)
+	{
+		size_t rows = count - first < 64 ? count - first : 64;
+		const uint8_t* row = assignments + first * stride;
+
+		// Transpose the rows into one bit per assignment
+		for (size_t n = 0; n < program->numVariables; n++)
+		{
+			const uint8_t* value = row + program->variables[n];
+			uint64_t column = 0;
+
+			for (size_t r = 0; r < rows; r++, value += stride)
+			{
+				column |= (uint64_t)(*value != 0) << r;
+			}
+
+			columns[n] = column;
+		}
+
+		uint64_t result = _execute(program, columns, stack, slots);
+		for (size_t r = 0; r < rows; r++) results[first + r] = (result >> r) & 1;
+	}
+
+	free(columns);
+}
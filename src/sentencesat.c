@@ -0,0 +1,915 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencesat.h.
+ *
+ * The first literal of a clause that is the reason for an assignment is
+ * always the literal it implied, and the first two literals of every
+ * clause are the watched ones. watches[l] lists the clauses watching
+ * literal l, which are visited when l becomes false.
+ */
+
+#include "sentencesat.h"
+#include <string.h>
+
+#define _UNDEF 2
+#define _NO_CLAUSE UINT32_MAX
+#define _NOT_IN_HEAP UINT32_MAX
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+struct _Clause
+{
+	uint32_t* literals;
+	uint32_t size;
+	uint8_t learnt;
+	double activity;
+};
+
+/**
+ * blocker is some other literal of the clause. If it is true the clause
+ * is satisfied and need not be looked at.
+ */
+struct _Watch
+{
+	uint32_t clause;
+	uint32_t blocker;
+};
+
+struct _Watches
+{
+	struct _Watch* data;
+	uint32_t size;
+	uint32_t max;
+};
+
+struct SentenceSolver_s
+{
+	SentenceCNF cnf;
+	size_t numSynced;
+	uint8_t unsatisfiable;
+
+	// Per variable
+	uint32_t numVariables;
+	uint32_t maxVariables;
+	uint8_t* values;
+	uint8_t* model;
+	uint8_t* polarity;
+	uint8_t* seen;
+	uint32_t* level;
+	uint32_t* reason;
+	double* activity;
+	uint32_t* heapIndex;
+
+	// Per literal
+	struct _Watches* watches;
+
+	struct _Clause* clauses;
+	uint32_t numClauses;
+	uint32_t maxClauses;
+	uint32_t* freeClauses;
+	uint32_t numFree;
+	uint32_t numLearnts;
+	double maxLearnts;
+	double adjust;
+	uint64_t nextAdjust;
+	uint64_t reduced;
+	double clauseInc;
+
+	uint32_t* trail;
+	uint32_t trailSize;
+	uint32_t qhead;
+	uint32_t* levels;
+	uint32_t numLevels;
+	uint32_t maxLevels;
+
+	uint32_t* heap;
+	uint32_t heapSize;
+	double varInc;
+
+	uint32_t* learnt;
+	uint32_t* stack;
+	uint32_t* marked;
+	uint32_t numMarked;
+	uint64_t conflicts;
+};
+
+/// ===========================================================================
+/// Static functions - Assignments
+/// ===========================================================================
+
+static uint8_t _value(const SentenceSolver s, uint32_t literal)
+{
+	uint8_t v = s->values[CNF_VARIABLE(literal)];
+	return v == _UNDEF ? _UNDEF : v ^ CNF_IS_NEGATED(literal);
+}
+
+static void _enqueue(SentenceSolver s, uint32_t literal, uint32_t reason)
+{
+	uint32_t var = CNF_VARIABLE(literal);
+	s->values[var] = !CNF_IS_NEGATED(literal);
+	s->level[var] = s->numLevels;
+	s->reason[var] = reason;
+	s->trail[s->trailSize++] = literal;
+}
+
+/// ===========================================================================
+/// Static functions - Variable order
+/// ===========================================================================
+
+static void _heapSwap(SentenceSolver s, uint32_t i, uint32_t j)
+{
+	uint32_t a = s->heap[i];
+	uint32_t b = s->heap[j];
+	s->heap[i] = b;
+	s->heap[j] = a;
+	s->heapIndex[a] = j;
+	s->heapIndex[b] = i;
+}
+
+static void _heapUp(SentenceSolver s, uint32_t i)
+{
+	while (i > 0)
+	{
+		uint32_t parent = (i - 1) / 2;
+		if (s->activity[s->heap[parent]] >= s->activity[s->heap[i]]) break;
+		_heapSwap(s, i, parent);
+		i = parent;
+	}
+}
+
+static void _heapDown(SentenceSolver s, uint32_t i)
+{
+	while (1)
+	{
+		uint32_t best = i;
+		uint32_t l = 2 * i + 1;
+		uint32_t r = l + 1;
+		if (l < s->heapSize
+			&& s->activity[s->heap[l]] > s->activity[s->heap[best]]) best = l;
+		if (r < s->heapSize
+			&& s->activity[s->heap[r]] > s->activity[s->heap[best]]) best = r;
+		if (best == i) return;
+		_heapSwap(s, i, best);
+		i = best;
+	}
+}
+
+static void _heapInsert(SentenceSolver s, uint32_t var)
+{
+	if (s->heapIndex[var] != _NOT_IN_HEAP) return;
+	s->heap[s->heapSize] = var;
+	s->heapIndex[var] = s->heapSize;
+	_heapUp(s, s->heapSize++);
+}
+
+static uint32_t _heapPop(SentenceSolver s)
+{
+	uint32_t var = s->heap[0];
+	_heapSwap(s, 0, --s->heapSize);
+	s->heapIndex[var] = _NOT_IN_HEAP;
+	if (s->heapSize > 0) _heapDown(s, 0);
+	return var;
+}
+
+static void _bumpVariable(SentenceSolver s, uint32_t var)
+{
+	if ((s->activity[var] += s->varInc) > 1e100)
+	{
+		for (uint32_t n = 0; n < s->numVariables; n++) s->activity[n] *= 1e-100;
+		s->varInc *= 1e-100;
+	}
+
+	if (s->heapIndex[var] != _NOT_IN_HEAP) _heapUp(s, s->heapIndex[var]);
+}
+
+static void _bumpClause(SentenceSolver s, struct _Clause* c)
+{
+	if ((c->activity += s->clauseInc) > 1e20)
+	{
+		for (uint32_t n = 0; n < s->numClauses; n++)
+			s->clauses[n].activity *= 1e-20;
+		s->clauseInc *= 1e-20;
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Clauses
+/// ===========================================================================
+
+static void _watch(SentenceSolver s, uint32_t literal, uint32_t clause,
+	uint32_t blocker)
+{
+	struct _Watches* w = &s->watches[literal];
+
+	if (w->size == w->max)
+	{
+		w->max = w->max == 0 ? 4 : w->max * 2;
+		w->data = realloc(w->data, w->max * sizeof(struct _Watch));
+	}
+
+	w->data[w->size].clause = clause;
+	w->data[w->size].blocker = blocker;
+	w->size++;
+}
+
+/**
+ * Stores and watches a clause of at least two literals.
+ */
+static uint32_t _addClause(
+	SentenceSolver s,
+	const uint32_t* literals,
+	uint32_t size,
+	uint8_t learnt)
+{
+	uint32_t index;
+	if (s->numFree > 0)
+	{
+		index = s->freeClauses[--s->numFree];
+	}
+	else
+	{
+		if (s->numClauses == s->maxClauses)
+		{
+			s->maxClauses *= 2;
+			s->clauses = realloc(s->clauses,
+				s->maxClauses * sizeof(struct _Clause));
+			s->freeClauses = realloc(s->freeClauses,
+				s->maxClauses * sizeof(uint32_t));
+		}
+		index = s->numClauses++;
+	}
+
+	struct _Clause* c = &s->clauses[index];
+	c->literals = malloc(size * sizeof(uint32_t));
+	memcpy(c->literals, literals, size * sizeof(uint32_t));
+	c->size = size;
+	c->learnt = learnt;
+	c->activity = 0;
+	if (learnt && size > 2) s->numLearnts++;
+
+	_watch(s, literals[0], index, literals[1]);
+	_watch(s, literals[1], index, literals[0]);
+	return index;
+}
+
+/**
+ * Checks if the clause is the reason for a current assignment.
+ */
+static uint8_t _isLocked(const SentenceSolver s, uint32_t index)
+{
+	uint32_t first = s->clauses[index].literals[0];
+	return s->reason[CNF_VARIABLE(first)] == index
+		&& _value(s, first) == 1;
+}
+
+/**
+ * A learned clause and its activity, for sorting.
+ */
+struct _Rank
+{
+	double activity;
+	uint32_t clause;
+};
+
+static int _compareRanks(const void* a, const void* b)
+{
+	double x = ((const struct _Rank*) a)->activity;
+	double y = ((const struct _Rank*) b)->activity;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Deletes the less active half of the learned clauses that are not
+ * reasons, then drops the watches of deleted clauses.
+ */
+static void _reduce(SentenceSolver s)
+{
+	struct _Rank* learnts = malloc(
+		(s->numLearnts + 1) * sizeof(struct _Rank));
+	uint32_t count = 0;
+
+	for (uint32_t n = 0; n < s->numClauses; n++)
+	{
+		struct _Clause* c = &s->clauses[n];
+		if (c->literals == NULL || !c->learnt || c->size <= 2) continue;
+		learnts[count].activity = c->activity;
+		learnts[count].clause = n;
+		count++;
+	}
+
+	qsort(learnts, count, sizeof(struct _Rank), _compareRanks);
+
+	for (uint32_t n = 0; n < count / 2; n++)
+	{
+		uint32_t index = learnts[n].clause;
+		if (_isLocked(s, index)) continue;
+		free(s->clauses[index].literals);
+		s->clauses[index].literals = NULL;
+		s->freeClauses[s->numFree++] = index;
+		s->numLearnts--;
+	}
+
+	for (uint32_t l = 0; l < 2 * s->numVariables; l++)
+	{
+		struct _Watches* w = &s->watches[l];
+		uint32_t kept = 0;
+		for (uint32_t n = 0; n < w->size; n++)
+		{
+			if (s->clauses[w->data[n].clause].literals != NULL)
+				w->data[kept++] = w->data[n];
+		}
+		w->size = kept;
+	}
+
+	free(learnts);
+}
+
+/// ===========================================================================
+/// Static functions - Search
+/// ===========================================================================
+
+/**
+ * Propagates every assignment on the trail that has not been propagated.
+ *
+ * @return Returns the conflicting clause, or _NO_CLAUSE.
+ */
+static uint32_t _propagate(SentenceSolver s)
+{
+	while (s->qhead < s->trailSize)
+	{
+		uint32_t falseLiteral = CNF_NEGATE(s->trail[s->qhead++]);
+		struct _Watches* w = &s->watches[falseLiteral];
+		struct _Watch* in = w->data;
+		struct _Watch* out = w->data;
+		struct _Watch* end = w->data + w->size;
+
+		while (in < end)
+		{
+			if (_value(s, in->blocker) == 1)
+			{
+				*out++ = *in++;
+				continue;
+			}
+
+			uint32_t index = in->clause;
+			uint32_t* lits = s->clauses[index].literals;
+			if (lits[0] == falseLiteral)
+			{
+				lits[0] = lits[1];
+				lits[1] = falseLiteral;
+			}
+			in++;
+
+			// Satisfied by the other watch
+			struct _Watch watch = {index, lits[0]};
+			if (_value(s, lits[0]) == 1)
+			{
+				*out++ = watch;
+				continue;
+			}
+
+			// Look for a new literal to watch
+			uint32_t size = s->clauses[index].size;
+			uint8_t moved = 0;
+			for (uint32_t k = 2; k < size && !moved; k++)
+			{
+				if (_value(s, lits[k]) != 0)
+				{
+					lits[1] = lits[k];
+					lits[k] = falseLiteral;
+					_watch(s, lits[1], index, lits[0]);
+					moved = 1;
+				}
+			}
+
+			if (moved) continue;
+
+			*out++ = watch;
+			if (_value(s, lits[0]) == 0)
+			{
+				while (in < end) *out++ = *in++;
+				w->size = out - w->data;
+				s->qhead = s->trailSize;
+				return index;
+			}
+
+			_enqueue(s, lits[0], index);
+		}
+
+		w->size = out - w->data;
+	}
+
+	return _NO_CLAUSE;
+}
+
+/**
+ * Unassigns every variable above the given decision level.
+ */
+static void _backtrack(SentenceSolver s, uint32_t level)
+{
+	if (s->numLevels <= level) return;
+
+	for (uint32_t n = s->trailSize; n > s->levels[level]; n--)
+	{
+		uint32_t var = CNF_VARIABLE(s->trail[n-1]);
+		s->polarity[var] = s->values[var];
+		s->values[var] = _UNDEF;
+		_heapInsert(s, var);
+	}
+
+	s->trailSize = s->levels[level];
+	s->qhead = s->trailSize;
+	s->numLevels = level;
+}
+
+/**
+ * Checks if a literal of the learned clause is implied by the others,
+ * following reasons through literals that are not in the clause. The
+ * walk is iterative; visited literals are marked with seen 2 (implied)
+ * or 3 (not implied).
+ */
+static uint8_t _isRedundant(SentenceSolver s, uint32_t literal)
+{
+	uint32_t size = 0;
+	s->stack[size++] = literal;
+
+	while (size > 0)
+	{
+		uint32_t var = CNF_VARIABLE(s->stack[size-1]);
+		struct _Clause* c = &s->clauses[s->reason[var]];
+		uint8_t pushed = 0;
+
+		for (uint32_t n = 1; n < c->size && !pushed; n++)
+		{
+			uint32_t v = CNF_VARIABLE(c->literals[n]);
+			if (s->seen[v] == 1 || s->seen[v] == 2 || s->level[v] == 0)
+				continue;
+
+			if (s->seen[v] == 3 || s->reason[v] == _NO_CLAUSE)
+			{
+				// Mark the whole path as not implied
+				for (uint32_t k = 0; k < size; k++)
+				{
+					uint32_t u = CNF_VARIABLE(s->stack[k]);
+					if (s->seen[u] != 0) continue;
+					s->seen[u] = 3;
+					s->marked[s->numMarked++] = u;
+				}
+				return 0;
+			}
+
+			s->stack[size++] = c->literals[n];
+			pushed = 1;
+		}
+
+		if (!pushed)
+		{
+			if (s->seen[var] == 0)
+			{
+				s->seen[var] = 2;
+				s->marked[s->numMarked++] = var;
+			}
+			size--;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * Learns a clause from a conflict by resolving back to the first unique
+ * implication point, and minimizes it.
+ *
+ * @return Returns the size of the learned clause in s->learnt; the
+ *         asserting literal is first, and one from the highest remaining
+ *         level second. level receives the level to backtrack to.
+ */
+static uint32_t _analyze(SentenceSolver s, uint32_t conflict, uint32_t* level)
+{
+	uint32_t size = 1;
+	uint32_t paths = 0;
+	uint32_t literal = CNF_NONE;
+	uint32_t index = s->trailSize;
+
+	do
+	{
+		struct _Clause* c = &s->clauses[conflict];
+		if (c->learnt) _bumpClause(s, c);
+
+		for (uint32_t n = literal == CNF_NONE ? 0 : 1; n < c->size; n++)
+		{
+			uint32_t q = c->literals[n];
+			uint32_t var = CNF_VARIABLE(q);
+			if (s->seen[var] || s->level[var] == 0) continue;
+
+			_bumpVariable(s, var);
+			s->seen[var] = 1;
+			s->marked[s->numMarked++] = var;
+			if (s->level[var] >= s->numLevels) paths++;
+			else s->learnt[size++] = q;
+		}
+
+		while (!s->seen[CNF_VARIABLE(s->trail[--index])]);
+		literal = s->trail[index];
+		conflict = s->reason[CNF_VARIABLE(literal)];
+		s->seen[CNF_VARIABLE(literal)] = 0;
+		paths--;
+	}
+	while (paths > 0);
+
+	s->learnt[0] = CNF_NEGATE(literal);
+
+	// Drop literals implied by the rest of the clause
+	uint32_t kept = 1;
+	for (uint32_t n = 1; n < size; n++)
+	{
+		uint32_t var = CNF_VARIABLE(s->learnt[n]);
+		if (s->reason[var] == _NO_CLAUSE || !_isRedundant(s, s->learnt[n]))
+			s->learnt[kept++] = s->learnt[n];
+	}
+
+	// Clear the marks, including those left by _isRedundant()
+	for (uint32_t n = 0; n < s->numMarked; n++) s->seen[s->marked[n]] = 0;
+	s->numMarked = 0;
+	size = kept;
+
+	*level = 0;
+	for (uint32_t n = 1; n < size; n++)
+	{
+		uint32_t l = s->level[CNF_VARIABLE(s->learnt[n])];
+		if (l > *level)
+		{
+			*level = l;
+			uint32_t t = s->learnt[1];
+			s->learnt[1] = s->learnt[n];
+			s->learnt[n] = t;
+		}
+	}
+
+	return size;
+}
+
+/**
+ * Returns the n-th element (from 0) of the Luby sequence 1 1 2 1 1 2 4...
+ */
+static uint64_t _luby(uint64_t n)
+{
+	uint64_t size = 1;
+	uint64_t seq = 0;
+	while (size < n + 1)
+	{
+		seq++;
+		size = 2 * size + 1;
+	}
+
+	while (size - 1 != n)
+	{
+		size = (size - 1) / 2;
+		seq--;
+		n %= size;
+	}
+
+	return 1ULL << seq;
+}
+
+/**
+ * Searches until a model is found, the clauses are refuted, or the
+ * conflict budget runs out.
+ *
+ * @return Returns 1 for a model, 0 for a refutation, _UNDEF to restart.
+ */
+static uint8_t _search(
+	SentenceSolver s,
+	const uint32_t* assumptions,
+	uint32_t numAssumptions,
+	uint64_t budget)
+{
+	while (1)
+	{
+		uint32_t conflict = _propagate(s);
+
+		if (conflict != _NO_CLAUSE)
+		{
+			// The learned clause limit grows ever more slowly
+			if (++s->conflicts >= s->nextAdjust)
+			{
+				s->adjust *= 1.5;
+				s->nextAdjust += s->adjust;
+				s->maxLearnts *= 1.1;
+			}
+
+			if (s->numLevels == 0)
+			{
+				s->unsatisfiable = 1;
+				return 0;
+			}
+
+			uint32_t level;
+			uint32_t size = _analyze(s, conflict, &level);
+			_backtrack(s, level);
+
+			if (size == 1) _enqueue(s, s->learnt[0], _NO_CLAUSE);
+			else
+			{
+				uint32_t index = _addClause(s, s->learnt, size, 1);
+				_bumpClause(s, &s->clauses[index]);
+				_enqueue(s, s->learnt[0], index);
+			}
+
+			s->varInc /= SENTENCESAT_VAR_DECAY;
+			s->clauseInc /= SENTENCESAT_CLAUSE_DECAY;
+			if (budget > 0) budget--;
+			continue;
+		}
+
+		if (budget == 0)
+		{
+			_backtrack(s, 0);
+			return _UNDEF;
+		}
+
+		// Reduce at most once per conflict, in case most clauses are locked
+		if (s->numLearnts >= s->maxLearnts + s->trailSize
+			&& s->reduced != s->conflicts)
+		{
+			s->reduced = s->conflicts;
+			_reduce(s);
+		}
+
+		// Assumptions are decided first, one level each
+		uint32_t next = CNF_NONE;
+		while (s->numLevels < numAssumptions)
+		{
+			uint32_t a = assumptions[s->numLevels];
+			if (_value(s, a) == 0) return 0;
+			if (_value(s, a) == _UNDEF)
+			{
+				next = a;
+				break;
+			}
+			s->levels[s->numLevels++] = s->trailSize;
+		}
+
+		while (next == CNF_NONE && s->heapSize > 0)
+		{
+			uint32_t var = _heapPop(s);
+			if (s->values[var] == _UNDEF)
+				next = CNF_LITERAL(var, s->polarity[var] == 0);
+		}
+
+		if (next == CNF_NONE) return 1;
+
+		s->levels[s->numLevels++] = s->trailSize;
+		_enqueue(s, next, _NO_CLAUSE);
+	}
+}
+
+/**
+ * Makes room for the variables of the clause set.
+ */
+static void _addVariables(SentenceSolver s)
+{
+	uint32_t count = s->cnf->numVariables;
+	if (count <= s->numVariables && s->values != NULL) return;
+
+	if (count > s->maxVariables || s->values == NULL)
+	{
+		while (count > s->maxVariables) s->maxVariables *= 2;
+		uint32_t max = s->maxVariables;
+
+		s->values = realloc(s->values, max);
+		s->model = realloc(s->model, max);
+		s->polarity = realloc(s->polarity, max);
+		s->seen = realloc(s->seen, max);
+		s->level = realloc(s->level, max * sizeof(uint32_t));
+		s->reason = realloc(s->reason, max * sizeof(uint32_t));
+		s->activity = realloc(s->activity, max * sizeof(double));
+		s->heapIndex = realloc(s->heapIndex, max * sizeof(uint32_t));
+		s->heap = realloc(s->heap, max * sizeof(uint32_t));
+		s->trail = realloc(s->trail, max * sizeof(uint32_t));
+		s->learnt = realloc(s->learnt, max * sizeof(uint32_t));
+		s->stack = realloc(s->stack, max * sizeof(uint32_t));
+		s->marked = realloc(s->marked, 2 * max * sizeof(uint32_t));
+		s->watches = realloc(s->watches, 2 * max * sizeof(struct _Watches));
+	}
+
+	for (uint32_t var = s->numVariables; var < count; var++)
+	{
+		s->values[var] = _UNDEF;
+		s->model[var] = 0;
+		s->polarity[var] = 0;
+		s->seen[var] = 0;
+		s->level[var] = 0;
+		s->reason[var] = _NO_CLAUSE;
+		s->activity[var] = 0;
+		s->heapIndex[var] = _NOT_IN_HEAP;
+		memset(&s->watches[2 * var], 0, 2 * sizeof(struct _Watches));
+	}
+
+	uint32_t first = s->numVariables;
+	s->numVariables = count;
+	for (uint32_t var = first; var < count; var++) _heapInsert(s, var);
+}
+
+static int _compareLiterals(const void* a, const void* b)
+{
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Adds the clauses of the clause set that the solver has not seen,
+ * simplified by the assignments at level 0.
+ */
+static void _addClauses(SentenceSolver s)
+{
+	SentenceCNF cnf = s->cnf;
+	_addVariables(s);
+
+	for (; s->numSynced < cnf->numClauses; s->numSynced++)
+	{
+		size_t start = cnf->clauses[s->numSynced];
+		uint32_t size = cnf->clauses[s->numSynced + 1] - start;
+		uint32_t* lits = s->learnt;
+		if (size > s->numVariables)
+			lits = malloc(size * sizeof(uint32_t));
+
+		memcpy(lits, cnf->literals + start, size * sizeof(uint32_t));
+		qsort(lits, size, sizeof(uint32_t), _compareLiterals);
+
+		// Drop duplicates and false literals; skip satisfied clauses
+		uint32_t kept = 0;
+		uint8_t satisfied = 0;
+		for (uint32_t n = 0; n < size && !satisfied; n++)
+		{
+			uint8_t value = _value(s, lits[n]);
+			if (value == 1 || (n > 0 && lits[n] == CNF_NEGATE(lits[n-1])))
+				satisfied = 1;
+			else if (value == _UNDEF && (kept == 0 || lits[kept-1] != lits[n]))
+				lits[kept++] = lits[n];
+		}
+
+		if (!satisfied && kept == 0) s->unsatisfiable = 1;
+		else if (!satisfied && kept == 1) _enqueue(s, lits[0], _NO_CLAUSE);
+		else if (!satisfied) _addClause(s, lits, kept, 0);
+
+		if (lits != s->learnt) free(lits);
+	}
+
+	if (!s->unsatisfiable && _propagate(s) != _NO_CLAUSE)
+		s->unsatisfiable = 1;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceSolver SentenceSolver_create(const SentenceCNF cnf)
+{
+	SentenceSolver s = calloc(1, sizeof(struct SentenceSolver_s));
+	s->cnf = cnf;
+	s->maxClauses = SENTENCESET_BUFFER;
+	s->clauses = malloc(s->maxClauses * sizeof(struct _Clause));
+	s->freeClauses = malloc(s->maxClauses * sizeof(uint32_t));
+	s->varInc = 1;
+	s->clauseInc = 1;
+	s->adjust = 100;
+	s->nextAdjust = 100;
+
+	// Per variable arrays are allocated by _addVariables()
+	s->maxVariables = 1;
+	s->maxLevels = 1;
+	s->levels = malloc(sizeof(uint32_t));
+	return s;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceSolver_free(SentenceSolver s)
+{
+	for (uint32_t n = 0; n < s->numClauses; n++) free(s->clauses[n].literals);
+	for (uint32_t n = 0; n < 2 * s->numVariables; n++)
+		free(s->watches[n].data);
+
+	free(s->clauses);
+	free(s->freeClauses);
+	free(s->values);
+	free(s->model);
+	free(s->polarity);
+	free(s->seen);
+	free(s->level);
+	free(s->reason);
+	free(s->activity);
+	free(s->heapIndex);
+	free(s->heap);
+	free(s->trail);
+	free(s->levels);
+	free(s->learnt);
+	free(s->stack);
+	free(s->marked);
+	free(s->watches);
+	free(s);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+uint8_t SentenceSolver_solve(
+	SentenceSolver solver,
+	const uint32_t* assumptions,
+	const size_t numAssumptions)
+{
+	_backtrack(solver, 0);
+	_addClauses(solver);
+	if (solver->unsatisfiable) return 0;
+
+	// One level per assumption, plus one per decision
+	size_t maxLevels = solver->numVariables + numAssumptions + 1;
+	if (maxLevels > solver->maxLevels)
+	{
+		solver->maxLevels = maxLevels;
+		solver->levels = realloc(solver->levels,
+			maxLevels * sizeof(uint32_t));
+	}
+
+	if (solver->maxLearnts == 0)
+		solver->maxLearnts = solver->numClauses / 3.0 + 1000;
+
+	uint8_t result = _UNDEF;
+	for (uint64_t n = 0; result == _UNDEF; n++)
+	{
+		result = _search(solver, assumptions, numAssumptions,
+			_luby(n) * SENTENCESAT_RESTART);
+	}
+
+	if (result == 1)
+	{
+		memcpy(solver->model, solver->values, solver->numVariables);
+	}
+
+	_backtrack(solver, 0);
+	return result;
+}
+
+uint8_t SentenceSolver_value(const SentenceSolver solver, const uint32_t literal)
+{
+	return solver->model[CNF_VARIABLE(literal)] ^ CNF_IS_NEGATED(literal);
+}
+
+void SentenceSolver_model(const SentenceSolver solver, uint8_t* values)
+{
+	for (uint32_t var = 0; var < solver->numVariables; var++)
+	{
+		uint32_t symbol = solver->cnf->symbols[var];
+		if (symbol != SYMBOL_NONE) values[symbol] = solver->model[var];
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+uint8_t SentenceSAT_isSatisfiable(const Sentence sentence, uint8_t* values)
+{
+	return !SentenceSAT_entails(&sentence, 1, NULL, values);
+}
+
+uint8_t SentenceSAT_isValid(const Sentence sentence, uint8_t* values)
+{
+	return SentenceSAT_entails(NULL, 0, sentence, values);
+}
+
+uint8_t SentenceSAT_entails(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion,
+	uint8_t* values)
+{
+	SentenceCNF cnf = SentenceCNF_create();
+	for (size_t n = 0; n < numPremises; n++)
+	{
+		SentenceCNF_assert(cnf, premises[n]);
+	}
+
+	if (conclusion != NULL)
+	{
+		uint32_t literal = CNF_NEGATE(SentenceCNF_encode(cnf, conclusion));
+		SentenceCNF_addClause(cnf, &literal, 1);
+	}
+
+	SentenceSolver solver = SentenceSolver_create(cnf);
+	uint8_t found = SentenceSolver_solve(solver, NULL, 0);
+	if (found && values != NULL) SentenceSolver_model(solver, values);
+
+	SentenceSolver_free(solver);
+	SentenceCNF_free(cnf);
+	return !found;
+}
@@ -0,0 +1,85 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencesession.h.
+ *
+ * The clauses that define a conclusion are equivalences, so they hold in
+ * every model and can stay in the clause set after the question is
+ * answered. Only the conclusion itself is assumed false, for one call.
+ * Once a conclusion is entailed it is added as a unit clause, which
+ * helps later questions that depend on it.
+ */
+
+#include "sentencesession.h"
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceSession SentenceSession_create(
+	const Sentence* premises,
+	const size_t numPremises)
+{
+	SentenceSession session = malloc(sizeof(struct SentenceSession_s));
+	session->cnf = SentenceCNF_create();
+	session->solver = SentenceSolver_create(session->cnf);
+	session->entailed = SentenceMap_create();
+
+	for (size_t n = 0; n < numPremises; n++)
+	{
+		SentenceSession_addPremise(session, premises[n]);
+	}
+
+	return session;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceSession_free(SentenceSession session)
+{
+	SentenceMap_free(session->entailed);
+	SentenceSolver_free(session->solver);
+	SentenceCNF_free(session->cnf);
+	free(session);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void SentenceSession_addPremise(SentenceSession session, const Sentence premise)
+{
+	SentenceCNF_assert(session->cnf, premise);
+	SentenceMap_put(session->entailed, premise, NULL);
+}
+
+uint8_t SentenceSession_isConsistent(SentenceSession session, uint8_t* values)
+{
+	if (!SentenceSolver_solve(session->solver, NULL, 0)) return 0;
+	if (values != NULL) SentenceSolver_model(session->solver, values);
+	return 1;
+}
+
+uint8_t SentenceSession_entails(
+	SentenceSession session,
+	const Sentence conclusion,
+	uint8_t* values)
+{
+	if (SentenceMap_get(session->entailed, conclusion, NULL)) return 1;
+
+	uint32_t literal = SentenceCNF_encode(session->cnf, conclusion);
+	uint32_t assumption = CNF_NEGATE(literal);
+
+	if (SentenceSolver_solve(session->solver, &assumption, 1))
+	{
+		if (values != NULL) SentenceSolver_model(session->solver, values);
+		return 0;
+	}
+
+	SentenceCNF_addClause(session->cnf, &literal, 1);
+	SentenceMap_put(session->entailed, conclusion, NULL);
+	return 1;
+}
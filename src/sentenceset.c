@@ -3,12 +3,454 @@
  * @since 04-18-2019
  *
  * Source code for SentenceSets.
+ *
+ * A set is a hash-consing table. Every member is stored once in an
+ * open-addressing table keyed by a structural hash that is computed from
+ * the member's operator, negation flag, and the addresses of its (already
+ * unique) left and right sentences. Lookups therefore never have to walk
+ * more than one node of a member.
+ *
+ * A shared set freezes its table, so any number of threads can probe it
+ * without locking. Members created meanwhile go to SENTENCESET_SHARDS
+ * smaller tables, each behind its own lock and picked by the high bits
+ * of the hash, and are merged back into the main table on unshare.
  */
 
 #include "sentence.h"
+#include "sentencemap.h"
+#include "sentencewrite.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+
+/// ===========================================================================
+/// Structure definitions - Concurrency
+/// ===========================================================================
+
+struct _Shard
+{
+	pthread_mutex_t lock;
+	size_t size;
+	size_t tableSize;
+	struct SentenceSetEntry_s* table;
+};
+
+/**
+ * A member created while the set was shared. seq is taken from a global
+ * counter while the member's shard is locked, so children always have a
+ * smaller seq than their parents.
+ */
+struct _Created
+{
+	Sentence sentence;
+	uint64_t seq;
+};
+
+struct SentenceSetShared_s
+{
+	struct _Shard shards[SENTENCESET_SHARDS];
+	uint64_t next;
+
+	// Guards everything below, and the set's owned table, added list and
+	// arena
+	pthread_mutex_t lock;
+	struct _Created* created;
+	size_t numCreated;
+	size_t maxCreated;
+};
+
+/**
+ * State of a thread that joined a shared set.
+ */
+struct _Worker
+{
+	Arena arena;
+	struct _Created* created;
+	size_t numCreated;
+	size_t maxCreated;
+	Sentence* added;
+	size_t numAdded;
+	size_t maxAdded;
+};
+
+static _Thread_local struct _Worker* _worker = NULL;
+
+/// ===========================================================================
+/// Static functions - Hashing
+/// ===========================================================================
+
+static uint32_t _mix(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return (uint32_t) h;
+}
+
+/**
+ * Hashes the fields of a sentence. Compound sentences hash the addresses
+ * of their children, so the hash is only structural if the children are
+ * members of the set.
+ */
+static uint32_t _hash(const Sentence s)
+{
+	uint64_t h = (uint64_t) s->op << 1 | s->negated;
+
+	if (s->type == ATOMIC)
+	{
+		return _mix(h ^ (uint64_t) s->id << 32);
+	}
+
+	h ^= (uint64_t)(uintptr_t) s->left.sentence * 0x9e3779b97f4a7c15ULL;
+	h ^= (uint64_t)(uintptr_t) s->right.sentence * 0xc2b2ae3d27d4eb4fULL;
+	return _mix(h);
+}
+
+/**
+ * Checks if two sentences have the same fields, comparing children
+ * by address.
+ */
+static uint8_t _sameFields(const Sentence a, const Sentence b)
+{
+	if (a->type != b->type || a->op != b->op || a->negated != b->negated)
+		return 0;
+
+	if (a->type == ATOMIC)
+		return a->id == b->id;
+
+	return a->left.sentence == b->left.sentence
+		&& a->right.sentence == b->right.sentence;
+}
+
+/// ===========================================================================
+/// Static functions - Table
+/// ===========================================================================
+
+/**
+ * Returns the slot holding a member with the same fields as the sentence,
+ * or the empty slot where such a member would be inserted.
+ */
+static struct SentenceSetEntry_s* _probeTable(
+	struct SentenceSetEntry_s* table,
+	const size_t tableSize,
+	const Sentence sentence,
+	uint32_t hash)
+{
+	size_t mask = tableSize - 1;
+	size_t n = hash & mask;
+
+	while (1)
+	{
+		struct SentenceSetEntry_s* entry = &table[n];
+		if (entry->sentence == NULL) return entry;
+		if (entry->hash == hash && (entry->sentence == sentence
+			|| _sameFields(entry->sentence, sentence))) return entry;
+		n = (n + 1) & mask;
+	}
+}
+
+static struct SentenceSetEntry_s* _probe(
+	const SentenceSet set,
+	const Sentence sentence,
+	uint32_t hash)
+{
+	return _probeTable(set->table, set->tableSize, sentence, hash);
+}
+
+/**
+ * Doubles the size of a table, reinserting its entries.
+ */
+static void _rehash(struct SentenceSetEntry_s** table, size_t* tableSize)
+{
+	struct SentenceSetEntry_s* old = *table;
+	size_t oldSize = *tableSize;
+	*tableSize *= 2;
+	*table = calloc(*tableSize, sizeof(struct SentenceSetEntry_s));
+
+	for (size_t n = 0; n < oldSize; n++)
+	{
+		if (old[n].sentence == NULL) continue;
+		size_t mask = *tableSize - 1;
+		size_t i = old[n].hash & mask;
+		while ((*table)[i].sentence != NULL) i = (i + 1) & mask;
+		(*table)[i] = old[n];
+	}
+
+	free(old);
+}
+
+/**
+ * Doubles the table once it is half full.
+ */
+static void _growTable(SentenceSet set)
+{
+	if (set->size * 2 < set->tableSize) return;
+	_rehash(&set->table, &set->tableSize);
+}
+
+/**
+ * Stores a new member in an empty slot of the main table and appends it
+ * to the set.
+ */
+static void _insert(
+	SentenceSet set,
+	struct SentenceSetEntry_s* entry,
+	const Sentence member,
+	uint32_t hash)
+{
+	entry->sentence = member;
+	entry->hash = hash;
+
+	// Check buffer is big enough
+	if (set->size == set->buffer)
+	{
+		set->buffer *= 2;
+		set->sentences = realloc(set->sentences, set->buffer*sizeof(Sentence));
+	}
+
+	// Add sentence to the set
+	set->sentences[set->size++] = member;
+	_growTable(set);
+}
+
+static struct _Shard* _shard(const SentenceSet set, uint32_t hash)
+{
+	return &set->shared->shards[hash >> (32 - SENTENCESET_SHARD_BITS)];
+}
+
+/**
+ * Appends to a list of created members, growing it when full.
+ */
+static void _record(
+	struct _Created** list,
+	size_t* size,
+	size_t* max,
+	const struct _Created created)
+{
+	if (*size == *max)
+	{
+		*max = *max == 0 ? SENTENCESET_BUFFER : *max * 2;
+		*list = realloc(*list, *max * sizeof(struct _Created));
+	}
+
+	(*list)[(*size)++] = created;
+}
+
+/**
+ * Same as _intern(), for members that are not in the frozen main table of
+ * a shared set.
+ */
+static Sentence _internShared(
+	SentenceSet set,
+	const Sentence sentence,
+	uint32_t hash)
+{
+	struct _Shard* shard = _shard(set, hash);
+	pthread_mutex_lock(&shard->lock);
+
+	struct SentenceSetEntry_s* entry =
+		_probeTable(shard->table, shard->tableSize, sentence, hash);
+	Sentence member = entry->sentence;
+
+	if (member == NULL)
+	{
+		member = Arena_alloc(_worker->arena, sizeof(struct Sentence_s));
+		*member = *sentence;
+		entry->sentence = member;
+		entry->hash = hash;
+
+		struct _Created created;
+		created.sentence = member;
+		created.seq = __atomic_fetch_add(&set->shared->next, 1,
+			__ATOMIC_RELAXED);
+		_record(&_worker->created, &_worker->numCreated,
+			&_worker->maxCreated, created);
+
+		if (++shard->size * 2 >= shard->tableSize)
+			_rehash(&shard->table, &shard->tableSize);
+	}
+
+	pthread_mutex_unlock(&shard->lock);
+	return member;
+}
+
+/**
+ * Returns the member with the same fields as the sentence, or NULL.
+ * The children of the sentence must be members.
+ */
+static Sentence _lookup(const SentenceSet set, const Sentence sentence)
+{
+	uint32_t hash = _hash(sentence);
+	Sentence member = _probe(set, sentence, hash)->sentence;
+	if (member != NULL || set->shared == NULL) return member;
+
+	struct _Shard* shard = _shard(set, hash);
+	pthread_mutex_lock(&shard->lock);
+	member = _probeTable(shard->table, shard->tableSize, sentence, hash)
+		->sentence;
+	pthread_mutex_unlock(&shard->lock);
+	return member;
+}
+
+/**
+ * Returns the member with the same fields as the given sentence, copying
+ * it into the set's arena and appending it if it is new. The children of
+ * the sentence must already be members.
+ */
+static Sentence _intern(SentenceSet set, const Sentence sentence)
+{
+	uint32_t hash = _hash(sentence);
+	struct SentenceSetEntry_s* entry = _probe(set, sentence, hash);
+	if (entry->sentence != NULL) return entry->sentence;
+	if (set->shared != NULL) return _internShared(set, sentence, hash);
+
+	Sentence member = Arena_alloc(set->arena, sizeof(struct Sentence_s));
+	*member = *sentence;
+	_insert(set, entry, member, hash);
+	return member;
+}
+
+/**
+ * Returns the member equal to the sentence. If insert is set, missing
+ * members are created, otherwise NULL is returned for them.
+ */
+static Sentence _canonical(SentenceSet set, const Sentence s, uint8_t insert)
+{
+	// Members, and sentences whose children are members, need one probe
+	Sentence found = _lookup(set, s);
+	if (found != NULL) return found;
+	if (s->type == ATOMIC) return insert ? _intern(set, s) : NULL;
+
+	if (_lookup(set, s->left.sentence) == s->left.sentence
+		&& _lookup(set, s->right.sentence) == s->right.sentence)
+	{
+		return insert ? _intern(set, s) : NULL;
+	}
+
+	// Otherwise walk the foreign nodes bottom-up, mapping each to its member
+	SentenceMap members = SentenceMap_create();
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	Sentence result = NULL;
+	stack[size++] = s;
+
+	while (size > 0)
+	{
+		Sentence t = stack[size-1];
+		void* left = NULL;
+		void* right = NULL;
+
+		if (SentenceMap_get(members, t, NULL))
+		{
+			size--;
+			continue;
+		}
+
+		Sentence member = _lookup(set, t);
+
+		if (member == NULL && t->type == ATOMIC)
+		{
+			if (!insert) break;
+			member = _intern(set, t);
+		}
+
+		else if (member == NULL)
+		{
+			uint8_t hasLeft =
+				SentenceMap_get(members, t->left.sentence, &left);
+			uint8_t hasRight =
+				SentenceMap_get(members, t->right.sentence, &right);
+
+			if (!hasLeft || !hasRight)
+			{
+				if (size + 2 > buffer)
+				{
+					buffer *= 2;
+					stack = realloc(stack, buffer * sizeof(Sentence));
+				}
+
+				if (!hasRight) stack[size++] = t->right.sentence;
+				if (!hasLeft) stack[size++] = t->left.sentence;
+				continue;
+			}
+
+			struct Sentence_s key = *t;
+			key.left.sentence = left;
+			key.right.sentence = right;
+			if (insert) member = _intern(set, &key);
+			else member = _lookup(set, &key);
+			if (member == NULL) break;
+		}
+
+		SentenceMap_put(members, t, member);
+		size--;
+		if (size == 0) result = member;
+	}
+
+	SentenceMap_free(members);
+	free(stack);
+	return result;
+}
+
+/**
+ * Remembers a sentence that was handed to the set, so it can be freed
+ * with the set. Pointers are kept in an open-addressing table so the
+ * same sentence is never recorded twice.
+ */
+static void _own(SentenceSet set, const Sentence sentence)
+{
+	if (set->arenaOnly) return;
+
+	if ((set->ownedCount + 1) * 2 > set->ownedSize)
+	{
+		Sentence* old = set->owned;
+		size_t oldSize = set->ownedSize;
+		set->ownedSize = oldSize == 0 ? 16 : oldSize * 2;
+		set->owned = calloc(set->ownedSize, sizeof(Sentence));
+		set->ownedCount = 0;
+
+		for (size_t n = 0; n < oldSize; n++)
+		{
+			if (old[n] != NULL) _own(set, old[n]);
+		}
+
+		free(old);
+	}
+
+	size_t mask = set->ownedSize - 1;
+	size_t n = _mix((uintptr_t) sentence) & mask;
+
+	while (set->owned[n] != NULL)
+	{
+		if (set->owned[n] == sentence) return;
+		n = (n + 1) & mask;
+	}
+
+	set->owned[n] = sentence;
+	set->ownedCount++;
+}
+
+/**
+ * Lists a member as added, unless it already is.
+ */
+static void _added(SentenceSet set, const Sentence member)
+{
+	if (SentenceMap_get(set->addedIndex, member, NULL)) return;
+	SentenceMap_put(set->addedIndex, member, NULL);
+
+	if (set->addedCount == set->addedSize)
+	{
+		set->addedSize = set->addedSize == 0 ? 16 : set->addedSize * 2;
+		set->added = realloc(set->added, set->addedSize * sizeof(Sentence));
+	}
+
+	set->added[set->addedCount++] = member;
+}
 
 /// ===========================================================================
 /// Function definitions - Constructors
@@ -20,20 +462,103 @@ SentenceSet SentenceSet_create()
 	set->size = 0;
 	set->buffer = SENTENCESET_BUFFER;
 	set->sentences = calloc(SENTENCESET_BUFFER, sizeof(Sentence));
+	set->arena = Arena_create();
+	set->tableSize = 16;
+	set->table = calloc(set->tableSize, sizeof(struct SentenceSetEntry_s));
+	set->arenaOnly = 0;
+	set->ownedSize = 0;
+	set->ownedCount = 0;
+	set->owned = NULL;
+	set->addedSize = 0;
+	set->addedCount = 0;
+	set->added = NULL;
+	set->addedIndex = SentenceMap_create();
+	set->shared = NULL;
 	return set;
 }
 
+SentenceSet SentenceSet_createArena()
+{
+	SentenceSet set = SentenceSet_create();
+	set->arenaOnly = 1;
+	return set;
+}
+
+Sentence SentenceSet_createAtomic(
+	SentenceSet set,
+	const char* var,
+	const uint8_t negated)
+{
+	return SentenceSet_createVariable(
+		set, Symbol_intern(var, strlen(var)), negated);
+}
+
+Sentence SentenceSet_createVariable(
+	SentenceSet set,
+	const uint32_t id,
+	const uint8_t negated)
+{
+	struct Sentence_s key;
+	key.type = ATOMIC;
+	key.op = NO_OP;
+	key.id = id;
+	key.left.variable = (char*) Symbol_name(id);
+	key.right.variable = "\0";
+	key.negated = negated;
+	return _intern(set, &key);
+}
+
+Sentence SentenceSet_createCompound(
+	SentenceSet set,
+	const SentenceOperator op,
+	const Sentence left,
+	const Sentence right,
+	const uint8_t negated)
+{
+	struct Sentence_s key;
+	key.type = COMPOUND;
+	key.op = op;
+	key.id = SYMBOL_NONE;
+	key.left.sentence = left;
+	key.right.sentence = right;
+	key.negated = negated;
+	return _intern(set, &key);
+}
+
+Sentence SentenceSet_negate(
+	SentenceSet set,
+	const Sentence sentence,
+	const uint8_t negated)
+{
+	if (sentence->negated == negated) return sentence;
+
+	if (sentence->type == ATOMIC)
+	{
+		return SentenceSet_createVariable(set, sentence->id, negated);
+	}
+
+	return SentenceSet_createCompound(set, sentence->op,
+		sentence->left.sentence, sentence->right.sentence, negated);
+}
+
 /// ===========================================================================
 /// Function definitions - Destructors
 /// ===========================================================================
 
 void SentenceSet_free(SentenceSet set)
 {
-	for (size_t n = 0; n < set->size; n++)
+	if (set->shared != NULL) SentenceSet_unshare(set);
+
+	for (size_t n = 0; n < set->ownedSize; n++)
 	{
-		Sentence_free(set->sentences[n]);
+		if (set->owned[n] != NULL) Sentence_free(set->owned[n]);
 	}
 
+	Arena_free(set->arena);
+	SentenceMap_free(set->addedIndex);
+	free(set->added);
+	free(set->owned);
+	free(set->table);
 	free(set->sentences);
 	free(set);
 }
@@ -44,36 +569,135 @@ void SentenceSet_free(SentenceSet set)
 
 void SentenceSet_add(SentenceSet set, const Sentence sentence)
 {
-	// Check it hasn't been added already
-	for (size_t n = 0; n < set->size; n++)
+	Sentence member = _canonical(set, sentence, 1);
+	struct SentenceSetShared_s* shared = set->shared;
+	struct _Worker* worker = _worker;
+
+	// Workers list what they add, and hand it over when they leave
+	if (shared != NULL && worker != NULL && member == sentence)
 	{
-		// Compare pointers
-		if (set->sentences[n] == sentence)
+		if (worker->numAdded == worker->maxAdded)
 		{
-			return;
+			worker->maxAdded = worker->maxAdded == 0
+				? SENTENCESET_BUFFER : worker->maxAdded * 2;
+			worker->added = realloc(worker->added,
+				worker->maxAdded * sizeof(Sentence));
 		}
+
+		worker->added[worker->numAdded++] = member;
+		return;
 	}
 
-	// Check buffer is big enough
-	if (set->size == set->buffer)
+	if (shared != NULL) pthread_mutex_lock(&shared->lock);
+	if (member != sentence) _own(set, sentence);
+	_added(set, member);
+	if (shared != NULL) pthread_mutex_unlock(&shared->lock);
+}
+
+Sentence SentenceSet_find(const SentenceSet set, const Sentence sentence)
+{
+	return _canonical(set, sentence, 0);
+}
+
+uint8_t SentenceSet_contains(const SentenceSet set, const Sentence sentence)
+{
+	return SentenceSet_find(set, sentence) != NULL;
+}
+
+/// ===========================================================================
+/// Function definitions - Concurrency
+/// ===========================================================================
+
+void SentenceSet_share(SentenceSet set)
+{
+	struct SentenceSetShared_s* shared =
+		malloc(sizeof(struct SentenceSetShared_s));
+
+	for (size_t n = 0; n < SENTENCESET_SHARDS; n++)
 	{
-		set->buffer *= 2;
-		set->sentences = realloc(set->sentences, set->buffer*sizeof(Sentence));
+		struct _Shard* shard = &shared->shards[n];
+		pthread_mutex_init(&shard->lock, NULL);
+		shard->size = 0;
+		shard->tableSize = 16;
+		shard->table = calloc(shard->tableSize,
+			sizeof(struct SentenceSetEntry_s));
 	}
 
-	// Add sentence to the set
-	set->sentences[set->size++] = sentence;
+	pthread_mutex_init(&shared->lock, NULL);
+	shared->next = 0;
+	shared->created = NULL;
+	shared->numCreated = 0;
+	shared->maxCreated = 0;
+	set->shared = shared;
 }
 
-uint8_t SentenceSet_contains(const SentenceSet set, const Sentence sentence)
+void SentenceSet_join(SentenceSet set)
 {
-	for (size_t n = 0; n < set->size; n++)
+	(void) set;
+	struct _Worker* worker = malloc(sizeof(struct _Worker));
+	worker->arena = Arena_create();
+	worker->created = NULL;
+	worker->numCreated = 0;
+	worker->maxCreated = 0;
+	worker->added = NULL;
+	worker->numAdded = 0;
+	worker->maxAdded = 0;
+	_worker = worker;
+}
+
+void SentenceSet_leave(SentenceSet set)
+{
+	struct _Worker* worker = _worker;
+	struct SentenceSetShared_s* shared = set->shared;
+	pthread_mutex_lock(&shared->lock);
+
+	Arena_merge(set->arena, worker->arena);
+	for (size_t n = 0; n < worker->numCreated; n++)
 	{
-		Sentence other = set->sentences[n];
-		if (sentence == other || Sentence_equals(sentence, other)) return 1;
+		_record(&shared->created, &shared->numCreated,
+			&shared->maxCreated, worker->created[n]);
 	}
 
-	return 0;
+	for (size_t n = 0; n < worker->numAdded; n++)
+	{
+		_added(set, worker->added[n]);
+	}
+
+	pthread_mutex_unlock(&shared->lock);
+	free(worker->added);
+	free(worker->created);
+	free(worker);
+	_worker = NULL;
+}
+
+void SentenceSet_unshare(SentenceSet set)
+{
+	struct SentenceSetShared_s* shared = set->shared;
+	set->shared = NULL;
+
+	// Every seq below next belongs to exactly one member
+	Sentence* order = malloc((shared->next + 1) * sizeof(Sentence));
+	for (size_t n = 0; n < shared->numCreated; n++)
+	{
+		order[shared->created[n].seq] = shared->created[n].sentence;
+	}
+
+	for (uint64_t n = 0; n < shared->next; n++)
+	{
+		uint32_t hash = _hash(order[n]);
+		_insert(set, _probe(set, order[n], hash), order[n], hash);
+	}
+
+	for (size_t n = 0; n < SENTENCESET_SHARDS; n++)
+	{
+		pthread_mutex_destroy(&shared->shards[n].lock);
+		free(shared->shards[n].table);
+	}
+
+	pthread_mutex_destroy(&shared->lock);
+	free(shared->created);
+	free(shared);
+	free(order);
 }
 
 /// ===========================================================================
@@ -82,9 +706,5 @@ uint8_t SentenceSet_contains(const SentenceSet set, const Sentence sentence)
 
 void SentenceSet_print(const SentenceSet set)
 {
-	for (size_t n = 0; n < set->size; n++)
-	{
-		Sentence_print(set->sentences[n]);
-		printf("\n");
-	}
-}
\ No newline at end of file
+	SentenceSet_write(stdout, set, FORMAT_FULL);
+}
@@ -0,0 +1,153 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencestream.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sentencestream.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+/**
+ * Moves unconsumed data to the front of the buffer, grows the buffer if
+ * a single line fills it, and reads another chunk.
+ */
+static void _fill(SentenceReader reader)
+{
+	size_t pending = reader->end - reader->start;
+	memmove(reader->buffer, reader->buffer + reader->start, pending);
+	reader->scanned -= reader->start;
+	reader->start = 0;
+	reader->end = pending;
+
+	if (reader->end == reader->capacity)
+	{
+		reader->capacity *= 2;
+		reader->buffer = realloc(reader->buffer, reader->capacity);
+	}
+
+	ssize_t n;
+	do
+	{
+		n = read(reader->fd, reader->buffer + reader->end,
+			reader->capacity - reader->end);
+	}
+	while (n < 0 && errno == EINTR);
+
+	if (n < 0) reader->error = 1;
+	if (n <= 0) reader->eof = 1;
+	else reader->end += n;
+}
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceReader SentenceReader_create(const int fd)
+{
+	SentenceReader reader = malloc(sizeof(struct SentenceReader_s));
+	reader->fd = fd;
+	reader->ownsFd = 0;
+	reader->eof = 0;
+	reader->error = 0;
+	reader->capacity = SENTENCESTREAM_CHUNK;
+	reader->buffer = malloc(reader->capacity);
+	reader->start = 0;
+	reader->end = 0;
+	reader->scanned = 0;
+	reader->line = 0;
+	return reader;
+}
+
+SentenceReader SentenceReader_open(const char* path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return NULL;
+
+	SentenceReader reader = SentenceReader_create(fd);
+	reader->ownsFd = 1;
+	return reader;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceReader_free(SentenceReader reader)
+{
+	if (reader->ownsFd) close(reader->fd);
+	free(reader->buffer);
+	free(reader);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+uint8_t SentenceReader_next(
+	SentenceReader reader,
+	SentenceSet set,
+	Sentence* sentence)
+{
+	while (1)
+	{
+		char* line = reader->buffer + reader->start;
+		char* newline = memchr(reader->buffer + reader->scanned, '\n',
+			reader->end - reader->scanned);
+		size_t len;
+
+		if (newline != NULL)
+		{
+			len = newline - line;
+			reader->start += len + 1;
+		}
+		else if (!reader->eof)
+		{
+			reader->scanned = reader->end;
+			_fill(reader);
+			continue;
+		}
+		else if (reader->start < reader->end)
+		{
+			// Last line without a newline
+			len = reader->end - reader->start;
+			reader->start = reader->end;
+		}
+		else
+		{
+			return 0;
+		}
+
+		reader->scanned = reader->start;
+		reader->line++;
+		if (Sentence_parseLine(line, len, set, sentence)) return 1;
+	}
+}
+
+size_t SentenceReader_parseAll(
+	SentenceReader reader,
+	SentenceSet set,
+	SentenceCallback callback,
+	void* data)
+{
+	size_t errors = 0;
+	Sentence sentence;
+
+	while (SentenceReader_next(reader, set, &sentence))
+	{
+		if (sentence == NULL) errors++;
+		if (callback != NULL) callback(sentence, reader->line, data);
+	}
+
+	return errors;
+}
@@ -0,0 +1,154 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencesubstitution.h.
+ */
+
+#include "sentencesubstitution.h"
+
+/// ===========================================================================
+/// Function definitions - Constructors
+/// ===========================================================================
+
+SentenceSubstitution SentenceSubstitution_create(SentenceSet set)
+{
+	SentenceSubstitution substitution =
+		malloc(sizeof(struct SentenceSubstitution_s));
+	substitution->set = set;
+	substitution->replacements = SentenceMap_create();
+	substitution->memo = SentenceMap_create();
+	return substitution;
+}
+
+/// ===========================================================================
+/// Function definitions - Destructors
+/// ===========================================================================
+
+void SentenceSubstitution_free(SentenceSubstitution substitution)
+{
+	SentenceMap_free(substitution->replacements);
+	SentenceMap_free(substitution->memo);
+	free(substitution);
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+void SentenceSubstitution_put(
+	SentenceSubstitution substitution,
+	const Sentence from,
+	const Sentence to)
+{
+	SentenceMap_put(substitution->replacements, from, to);
+
+	if (substitution->memo->size)
+	{
+		SentenceMap_free(substitution->memo);
+		substitution->memo = SentenceMap_create();
+	}
+}
+
+void SentenceSubstitution_putVariable(
+	SentenceSubstitution substitution,
+	uint32_t id,
+	const Sentence to)
+{
+	SentenceSubstitution_put(substitution,
+		SentenceSet_createVariable(substitution->set, id, 0), to);
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+Sentence SentenceSubstitution_apply(
+	SentenceSubstitution substitution,
+	const Sentence sentence)
+{
+	SentenceMap memo = substitution->memo;
+	void* result;
+	if (SentenceMap_get(memo, sentence, &result)) return result;
+
+	// A member stays on the stack until both its children are done
+	size_t stackSize = 64;
+	Sentence* stack = malloc(stackSize * sizeof(Sentence));
+	size_t top = 0;
+	stack[top++] = sentence;
+
+	while (top > 0)
+	{
+		Sentence s = stack[top - 1];
+
+		if (SentenceMap_get(memo, s, NULL))
+		{
+			top--;
+			continue;
+		}
+
+		if (SentenceMap_get(substitution->replacements, s, &result))
+		{
+			SentenceMap_put(memo, s, result);
+			top--;
+			continue;
+		}
+
+		// ~S takes the negated replacement of S, looked up without
+		// creating S
+		struct Sentence_s base = *s;
+		base.negated = 0;
+		Sentence from = s->negated
+			? SentenceSet_find(substitution->set, &base) : NULL;
+
+		if (from && SentenceMap_get(substitution->replacements, from,
+			&result))
+		{
+			Sentence to = result;
+			SentenceMap_put(memo, s, SentenceSet_negate(substitution->set,
+				to, !to->negated));
+			top--;
+			continue;
+		}
+
+		if (s->type == ATOMIC)
+		{
+			SentenceMap_put(memo, s, s);
+			top--;
+			continue;
+		}
+
+		void* left;
+		void* right;
+		uint8_t leftDone = SentenceMap_get(memo, s->left.sentence, &left);
+		uint8_t rightDone = SentenceMap_get(memo, s->right.sentence, &right);
+
+		if (leftDone && rightDone)
+		{
+			Sentence done = s;
+
+			if (left != s->left.sentence || right != s->right.sentence)
+			{
+				done = SentenceSet_createCompound(
+					substitution->set, s->op, left, right, s->negated);
+			}
+
+			SentenceMap_put(memo, s, done);
+			top--;
+			continue;
+		}
+
+		if (top + 2 > stackSize)
+		{
+			stackSize *= 2;
+			stack = realloc(stack, stackSize * sizeof(Sentence));
+		}
+
+		if (!rightDone) stack[top++] = s->right.sentence;
+		if (!leftDone) stack[top++] = s->left.sentence;
+	}
+
+	free(stack);
+	SentenceMap_get(memo, sentence, &result);
+	return result;
+}
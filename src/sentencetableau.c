@@ -0,0 +1,462 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencetableau.h.
+ *
+ * The tree is built from signed sentences: a node that must be true or
+ * false. The negation flag is folded into the sign, so a negated
+ * conditional or biconditional needs no rules of its own and no new
+ * sentences are created.
+ *
+ * The open branch is held as a set of literals, one per symbol, and a
+ * flag for each signed compound node it contains. Either set shows a
+ * contradiction in O(1) as soon as it is added. Signed nodes wait in two
+ * queues, one for each kind of rule. Nothing is removed from a queue
+ * except by moving its head, so going back to a branching point only
+ * restores the heads and sizes and undoes the trail.
+ */
+
+#include "sentencetableau.h"
+#include "sentencemap.h"
+#include <string.h>
+
+/// ===========================================================================
+/// Structure definitions
+/// ===========================================================================
+
+#define _UNKNOWN 2
+
+/**
+ * A sentence that must have the given value, negation flag included.
+ */
+struct _Signed
+{
+	Sentence sentence;
+	uint8_t value;
+};
+
+/**
+ * Something the branch added: the literal of a symbol, or a flag.
+ */
+struct _Undo
+{
+	size_t index;
+	uint8_t flag;
+};
+
+/**
+ * Where a branching rule was applied, to try its second alternative.
+ */
+struct _Choice
+{
+	struct _Signed formula;
+	size_t trail;
+	size_t alphaHead;
+	size_t alphaSize;
+	size_t betaHead;
+	size_t betaSize;
+};
+
+/**
+ * indices maps compound nodes to their index, plus 1, and atomic nodes
+ * to the index of their symbol in symbols, plus 1. flags[2 * index +
+ * value] is set while that signed node is on the branch, and literals
+ * holds the value of each symbol on it.
+ */
+struct _Tableau
+{
+	SentenceMap indices;
+	size_t numNodes;
+	uint32_t* symbols;
+	size_t numSymbols;
+
+	uint8_t* literals;
+	uint8_t* flags;
+	struct _Undo* trail;
+	size_t trailSize;
+
+	struct _Signed* alpha;
+	size_t alphaHead;
+	size_t alphaSize;
+	struct _Signed* beta;
+	size_t betaHead;
+	size_t betaSize;
+
+	struct _Choice* choices;
+	size_t numChoices;
+	uint8_t closed;
+};
+
+/// ===========================================================================
+/// Static functions - Branches
+/// ===========================================================================
+
+static size_t _indexOf(const struct _Tableau* t, const Sentence s)
+{
+	void* index = NULL;
+	SentenceMap_get(t->indices, s, &index);
+	return (uintptr_t) index - 1;
+}
+
+static size_t _flag(const struct _Tableau* t, struct _Signed f)
+{
+	return 2 * _indexOf(t, f.sentence) + f.value;
+}
+
+/**
+ * Checks if the branch already contains the signed sentence.
+ */
+static uint8_t _holds(const struct _Tableau* t, struct _Signed f)
+{
+	if (f.sentence->type == ATOMIC)
+		return t->literals[_indexOf(t, f.sentence)]
+			== (f.value ^ f.sentence->negated);
+	return t->flags[_flag(t, f)];
+}
+
+/**
+ * Adds a signed sentence to the branch, closing it on a contradiction.
+ */
+static void _push(struct _Tableau* t, struct _Signed f)
+{
+	if (t->closed) return;
+	Sentence s = f.sentence;
+
+	if (s->type == ATOMIC)
+	{
+		uint8_t value = f.value ^ s->negated;
+		size_t index = _indexOf(t, s);
+		uint8_t* literal = &t->literals[index];
+		if (*literal == value) return;
+		if (*literal != _UNKNOWN)
+		{
+			t->closed = 1;
+			return;
+		}
+
+		*literal = value;
+		t->trail[t->trailSize++] = (struct _Undo) {index, 0};
+		return;
+	}
+
+	size_t flag = _flag(t, f);
+	if (t->flags[flag]) return;
+	if (t->flags[flag ^ 1])
+	{
+		t->closed = 1;
+		return;
+	}
+
+	t->flags[flag] = 1;
+	t->trail[t->trailSize++] = (struct _Undo) {flag, 1};
+	t->alpha[t->alphaSize++] = f;
+}
+
+static void _undo(struct _Tableau* t, size_t mark)
+{
+	while (t->trailSize > mark)
+	{
+		struct _Undo u = t->trail[--t->trailSize];
+		if (u.flag) t->flags[u.index] = 0;
+		else t->literals[u.index] = _UNKNOWN;
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Rules
+/// ===========================================================================
+
+/**
+ * Decomposes a signed compound sentence. Each alternative is a pair of
+ * signed sentences, the second of which is unused when size is 1.
+ *
+ * @return Returns the number of alternatives: 1 for a rule that does not
+ *         branch, 2 for one that does.
+ */
+static uint8_t _rule(struct _Signed f, struct _Signed parts[2][2], uint8_t* size)
+{
+	Sentence l = f.sentence->left.sentence;
+	Sentence r = f.sentence->right.sentence;
+	uint8_t value = f.value ^ f.sentence->negated;
+	uint8_t branches;
+
+	switch (f.sentence->op)
+	{
+		case AND:
+			branches = !value;
+			parts[0][0] = (struct _Signed) {l, value};
+			parts[1][0] = (struct _Signed) {r, value};
+			break;
+		case OR:
+			branches = value;
+			parts[0][0] = (struct _Signed) {l, value};
+			parts[1][0] = (struct _Signed) {r, value};
+			break;
+		case MATERIAL_CONDITIONAL:
+			branches = value;
+			parts[0][0] = (struct _Signed) {l, !value};
+			parts[1][0] = (struct _Signed) {r, value};
+			break;
+		default:
+			parts[0][0] = (struct _Signed) {l, 1};
+			parts[0][1] = (struct _Signed) {r, value};
+			parts[1][0] = (struct _Signed) {l, 0};
+			parts[1][1] = (struct _Signed) {r, !value};
+			*size = 2;
+			return 2;
+	}
+
+	if (branches)
+	{
+		*size = 1;
+		return 2;
+	}
+
+	// Both parts go on the one branch
+	parts[0][1] = parts[1][0];
+	*size = 2;
+	return 1;
+}
+
+static void _pushAlternative(
+	struct _Tableau* t,
+	struct _Signed parts[2][2],
+	uint8_t size,
+	uint8_t alternative)
+{
+	for (uint8_t n = 0; n < size; n++) _push(t, parts[alternative][n]);
+}
+
+/**
+ * Grows the tree depth-first.
+ *
+ * @return Returns 1 if a branch is complete and open, 0 if all close.
+ */
+static uint8_t _expand(struct _Tableau* t)
+{
+	struct _Signed parts[2][2];
+	uint8_t size;
+
+	while (1)
+	{
+		if (t->closed)
+		{
+			if (t->numChoices == 0) return 0;
+
+			struct _Choice* c = &t->choices[--t->numChoices];
+			_undo(t, c->trail);
+			t->alphaHead = c->alphaHead;
+			t->alphaSize = c->alphaSize;
+			t->betaHead = c->betaHead;
+			t->betaSize = c->betaSize;
+			t->closed = 0;
+
+			_rule(c->formula, parts, &size);
+			_pushAlternative(t, parts, size, 1);
+			continue;
+		}
+
+		if (t->alphaHead < t->alphaSize)
+		{
+			struct _Signed f = t->alpha[t->alphaHead++];
+			if (_rule(f, parts, &size) == 1) _pushAlternative(t, parts, size, 0);
+			else t->beta[t->betaSize++] = f;
+			continue;
+		}
+
+		if (t->betaHead < t->betaSize)
+		{
+			struct _Signed f = t->beta[t->betaHead++];
+			_rule(f, parts, &size);
+
+			uint8_t satisfied = 0;
+			for (uint8_t k = 0; k < 2 && !satisfied; k++)
+			{
+				satisfied = _holds(t, parts[k][0])
+					&& (size == 1 || _holds(t, parts[k][1]));
+			}
+			if (satisfied) continue;
+
+			t->choices[t->numChoices++] = (struct _Choice) {f, t->trailSize,
+				t->alphaHead, t->alphaSize, t->betaHead, t->betaSize};
+			_pushAlternative(t, parts, size, 0);
+			continue;
+		}
+
+		return 1;
+	}
+}
+
+/// ===========================================================================
+/// Static functions - Trees
+/// ===========================================================================
+
+static int _compareIds(const void* a, const void* b)
+{
+	uint32_t x = (*(const Sentence*) a)->id;
+	uint32_t y = (*(const Sentence*) b)->id;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Numbers the compound nodes below the roots, and their symbols.
+ */
+static void _index(struct _Tableau* t, const struct _Signed* roots, size_t n)
+{
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	Sentence* stack = malloc(buffer * sizeof(Sentence));
+	size_t numAtoms = 0;
+	size_t maxAtoms = SENTENCESET_BUFFER;
+	Sentence* atoms = malloc(maxAtoms * sizeof(Sentence));
+
+	for (size_t k = 0; k < n; k++)
+	{
+		stack[size++] = roots[k].sentence;
+
+		while (size > 0)
+		{
+			Sentence s = stack[--size];
+			if (SentenceMap_get(t->indices, s, NULL)) continue;
+
+			if (s->type == ATOMIC)
+			{
+				SentenceMap_put(t->indices, s, NULL);
+
+				if (numAtoms == maxAtoms)
+				{
+					maxAtoms *= 2;
+					atoms = realloc(atoms, maxAtoms * sizeof(Sentence));
+				}
+
+				atoms[numAtoms++] = s;
+				continue;
+			}
+
+			SentenceMap_put(t->indices, s, (void*)(uintptr_t)(++t->numNodes));
+
+			if (size + 2 > buffer)
+			{
+				buffer *= 2;
+				stack = realloc(stack, buffer * sizeof(Sentence));
+			}
+
+			stack[size++] = s->right.sentence;
+			stack[size++] = s->left.sentence;
+		}
+	}
+
+	// a and ~a are different nodes, so sort them by symbol to number it
+	qsort(atoms, numAtoms, sizeof(Sentence), _compareIds);
+	t->symbols = malloc((numAtoms + 1) * sizeof(uint32_t));
+
+	for (size_t k = 0; k < numAtoms; k++)
+	{
+		if (k == 0 || atoms[k]->id != atoms[k - 1]->id)
+		{
+			t->symbols[t->numSymbols++] = atoms[k]->id;
+		}
+
+		SentenceMap_put(t->indices, atoms[k],
+			(void*)(uintptr_t) t->numSymbols);
+	}
+
+	free(atoms);
+	free(stack);
+}
+
+/**
+ * Builds the tree of the signed roots.
+ *
+ * @return Returns 1 if it has an open branch, 0 if it closes.
+ */
+static uint8_t _decide(const struct _Signed* roots, size_t n, uint8_t* values)
+{
+	struct _Tableau t;
+	t.indices = SentenceMap_create();
+	t.numNodes = 0;
+	t.numSymbols = 0;
+	_index(&t, roots, n);
+
+	// Each signed node is on a branch at most once
+	size_t signedNodes = 2 * t.numNodes + 1;
+	t.literals = malloc(t.numSymbols + 1);
+	memset(t.literals, _UNKNOWN, t.numSymbols + 1);
+	t.flags = calloc(signedNodes, 1);
+	t.trail = malloc((signedNodes + t.numSymbols) * sizeof(struct _Undo));
+	t.trailSize = 0;
+	t.alpha = malloc(signedNodes * sizeof(struct _Signed));
+	t.beta = malloc(signedNodes * sizeof(struct _Signed));
+	t.alphaHead = t.alphaSize = t.betaHead = t.betaSize = 0;
+	t.choices = malloc(signedNodes * sizeof(struct _Choice));
+	t.numChoices = 0;
+	t.closed = 0;
+
+	for (size_t k = 0; k < n; k++) _push(&t, roots[k]);
+	uint8_t open = _expand(&t);
+
+	if (open && values != NULL)
+	{
+		for (size_t k = 0; k < t.numSymbols; k++)
+		{
+			values[t.symbols[k]] = t.literals[k] == 1;
+		}
+	}
+
+	free(t.choices);
+	free(t.beta);
+	free(t.alpha);
+	free(t.trail);
+	free(t.flags);
+	free(t.literals);
+	free(t.symbols);
+	SentenceMap_free(t.indices);
+	return open;
+}
+
+/// ===========================================================================
+/// Function definitions
+/// ===========================================================================
+
+uint8_t SentenceTableau_isSatisfiable(
+	const Sentence* sentences,
+	const size_t numSentences,
+	uint8_t* values)
+{
+	struct _Signed* roots = malloc((numSentences + 1) * sizeof(struct _Signed));
+	for (size_t n = 0; n < numSentences; n++)
+	{
+		roots[n] = (struct _Signed) {sentences[n], 1};
+	}
+
+	uint8_t open = _decide(roots, numSentences, values);
+	free(roots);
+	return open;
+}
+
+uint8_t SentenceTableau_isValid(const Sentence sentence, uint8_t* values)
+{
+	struct _Signed root = {sentence, 0};
+	return !_decide(&root, 1, values);
+}
+
+uint8_t SentenceTableau_entails(
+	const Sentence* premises,
+	const size_t numPremises,
+	const Sentence conclusion,
+	uint8_t* values)
+{
+	struct _Signed* roots = malloc((numPremises + 1) * sizeof(struct _Signed));
+	for (size_t n = 0; n < numPremises; n++)
+	{
+		roots[n] = (struct _Signed) {premises[n], 1};
+	}
+
+	size_t n = numPremises;
+	if (conclusion != NULL) roots[n++] = (struct _Signed) {conclusion, 0};
+
+	uint8_t open = _decide(roots, n, values);
+	free(roots);
+	return !open;
+}
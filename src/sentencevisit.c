@@ -0,0 +1,105 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Iterative depth-first traversal of sentences.
+ */
+
+#include "sentence.h"
+#include "sentencemap.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+/**
+ * A node on the traversal stack and how far its visit has progressed:
+ * 0 before pre, 1 after the left sentence, 2 after the right sentence.
+ */
+struct _Step
+{
+	Sentence sentence;
+	uint8_t state;
+};
+
+static void _walk(
+	const Sentence sentence,
+	const SentenceVisitor* visitor,
+	SentenceMap seen)
+{
+	size_t size = 0;
+	size_t buffer = SENTENCESET_BUFFER;
+	struct _Step* stack = malloc(buffer * sizeof(struct _Step));
+	stack[size++] = (struct _Step) {sentence, 0};
+
+	while (size > 0)
+	{
+		struct _Step* step = &stack[size-1];
+		Sentence s = step->sentence;
+		Sentence next = NULL;
+
+		if (step->state == 0)
+		{
+			step->state = 1;
+
+			if (seen != NULL && SentenceMap_get(seen, s, NULL))
+			{
+				size--;
+				continue;
+			}
+
+			if (seen != NULL) SentenceMap_put(seen, s, NULL);
+			uint8_t descend = visitor->pre == NULL
+				|| visitor->pre(s, visitor->data);
+
+			if (descend && s->type == COMPOUND) next = s->left.sentence;
+			else step->state = 2;
+		}
+
+		else if (step->state == 1)
+		{
+			step->state = 2;
+			if (visitor->in != NULL) visitor->in(s, visitor->data);
+			next = s->right.sentence;
+		}
+
+		else
+		{
+			if (visitor->post != NULL) visitor->post(s, visitor->data);
+			size--;
+		}
+
+		if (next != NULL)
+		{
+			if (size == buffer)
+			{
+				buffer *= 2;
+				stack = realloc(stack, buffer * sizeof(struct _Step));
+			}
+
+			stack[size++] = (struct _Step) {next, 0};
+		}
+	}
+
+	free(stack);
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+void Sentence_visit(const Sentence sentence, const SentenceVisitor* visitor)
+{
+	_walk(sentence, visitor, NULL);
+}
+
+void Sentence_visitUnique(
+	const Sentence sentence,
+	const SentenceVisitor* visitor)
+{
+	SentenceMap seen = SentenceMap_create();
+	_walk(sentence, visitor, seen);
+	SentenceMap_free(seen);
+}
@@ -0,0 +1,264 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for sentencewrite.h.
+ *
+ * Every output function runs the same iterative walk and feeds the text
+ * to a writer, which either just counts it, copies it to an array or a
+ * SentenceText, or batches it into chunks for fwrite().
+ */
+
+#include "sentencewrite.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// ===========================================================================
+/// Writer
+/// ===========================================================================
+
+/**
+ * A node on the stack and how far it has been written: 0 before its
+ * left sentence, 1 before its right sentence, 2 after both. tail is set
+ * for the root and for right-hand sentences, which the parser reads to
+ * the end of their group.
+ */
+struct _Step
+{
+	Sentence sentence;
+	uint8_t state;
+	uint8_t tail;
+};
+
+enum _Target
+{
+	_COUNT,
+	_ARRAY,
+	_TEXT,
+	_FILE
+};
+
+struct _Writer
+{
+	enum _Target target;
+	size_t length;
+	char* out;
+	size_t size;
+	SentenceText* text;
+	FILE* file;
+	size_t used;
+	char chunk[SENTENCEWRITE_CHUNK];
+	struct _Step* stack;
+	size_t buffer;
+};
+
+static void _init(struct _Writer* w, enum _Target target)
+{
+	w->target = target;
+	w->length = 0;
+	w->used = 0;
+	w->buffer = SENTENCESET_BUFFER;
+	w->stack = malloc(w->buffer * sizeof(struct _Step));
+}
+
+static void _flushChunk(struct _Writer* w)
+{
+	fwrite(w->chunk, 1, w->used, w->file);
+	w->used = 0;
+}
+
+static void _put(struct _Writer* w, const char* s, size_t len)
+{
+	switch (w->target)
+	{
+		case _COUNT:
+			break;
+
+		case _ARRAY:
+			if (w->length + 1 < w->size)
+			{
+				size_t room = w->size - 1 - w->length;
+				memcpy(w->out + w->length, s, len < room ? len : room);
+			}
+			break;
+
+		case _TEXT:
+		{
+			SentenceText* t = w->text;
+			if (t->length + len + 1 > t->capacity)
+			{
+				t->capacity = t->capacity == 0 ? 64 : t->capacity;
+				while (t->length + len + 1 > t->capacity) t->capacity *= 2;
+				t->data = realloc(t->data, t->capacity);
+			}
+			memcpy(t->data + t->length, s, len);
+			t->length += len;
+			break;
+		}
+
+		case _FILE:
+			if (w->used + len > SENTENCEWRITE_CHUNK) _flushChunk(w);
+			if (len > SENTENCEWRITE_CHUNK) fwrite(s, 1, len, w->file);
+			else
+			{
+				memcpy(w->chunk + w->used, s, len);
+				w->used += len;
+			}
+			break;
+	}
+
+	w->length += len;
+}
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+static uint8_t _wrap(const Sentence s, uint8_t tail, SentenceFormat format)
+{
+	if (format == FORMAT_FULL) return 1;
+	return s->negated || !tail;
+}
+
+static void _writeSentence(
+	struct _Writer* w,
+	const Sentence sentence,
+	const SentenceFormat format)
+{
+	size_t size = 0;
+	struct _Step* stack = w->stack;
+	stack[size++] = (struct _Step) {sentence, 0, 1};
+
+	while (size > 0)
+	{
+		struct _Step* step = &stack[size-1];
+		Sentence s = step->sentence;
+		Sentence next = NULL;
+		uint8_t tail = 0;
+
+		if (s->type == ATOMIC)
+		{
+			uint8_t wrap = format == FORMAT_MINIMAL
+				&& s->negated && !step->tail;
+			if (wrap) _put(w, "(", 1);
+			if (s->negated) _put(w, "~", 1);
+			_put(w, s->left.variable, strlen(s->left.variable));
+			if (wrap) _put(w, ")", 1);
+			size--;
+		}
+
+		else if (step->state == 0)
+		{
+			if (s->negated) _put(w, "~", 1);
+			if (_wrap(s, step->tail, format)) _put(w, "(", 1);
+			step->state = 1;
+			next = s->left.sentence;
+		}
+
+		else if (step->state == 1)
+		{
+			const char* op = SentenceOperator_toString(s->op);
+			_put(w, " ", 1);
+			_put(w, op, strlen(op));
+			_put(w, " ", 1);
+			step->state = 2;
+			next = s->right.sentence;
+			tail = 1;
+		}
+
+		else
+		{
+			if (_wrap(s, step->tail, format)) _put(w, ")", 1);
+			size--;
+		}
+
+		if (next != NULL)
+		{
+			if (size == w->buffer)
+			{
+				w->buffer *= 2;
+				stack = realloc(stack, w->buffer * sizeof(struct _Step));
+				w->stack = stack;
+			}
+
+			stack[size++] = (struct _Step) {next, 0, tail};
+		}
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - Utility
+/// ===========================================================================
+
+size_t Sentence_length(const Sentence sentence, const SentenceFormat format)
+{
+	struct _Writer w;
+	_init(&w, _COUNT);
+	_writeSentence(&w, sentence, format);
+	free(w.stack);
+	return w.length;
+}
+
+size_t Sentence_toString(
+	const Sentence sentence,
+	const SentenceFormat format,
+	char* out,
+	const size_t size)
+{
+	struct _Writer w;
+	_init(&w, _ARRAY);
+	w.out = out;
+	w.size = size;
+	_writeSentence(&w, sentence, format);
+	free(w.stack);
+	if (size > 0) out[w.length < size ? w.length : size - 1] = '\0';
+	return w.length;
+}
+
+void Sentence_append(
+	SentenceText* text,
+	const Sentence sentence,
+	const SentenceFormat format)
+{
+	struct _Writer w;
+	_init(&w, _TEXT);
+	w.text = text;
+	_writeSentence(&w, sentence, format);
+	free(w.stack);
+	text->data[text->length] = '\0';
+}
+
+size_t Sentence_write(
+	FILE* file,
+	const Sentence sentence,
+	const SentenceFormat format)
+{
+	struct _Writer w;
+	_init(&w, _FILE);
+	w.file = file;
+	_writeSentence(&w, sentence, format);
+	_flushChunk(&w);
+	free(w.stack);
+	return w.length;
+}
+
+size_t SentenceSet_write(
+	FILE* file,
+	const SentenceSet set,
+	const SentenceFormat format)
+{
+	struct _Writer w;
+	_init(&w, _FILE);
+	w.file = file;
+
+	for (size_t n = 0; n < set->size; n++)
+	{
+		_writeSentence(&w, set->sentences[n], format);
+		_put(&w, "\n", 1);
+	}
+
+	_flushChunk(&w);
+	free(w.stack);
+	return w.length;
+}
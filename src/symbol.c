@@ -0,0 +1,189 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Source code for symbol.h.
+ *
+ * The table is safe to use from several threads. Names are kept in
+ * fixed-size pages that never move, so Symbol_name() needs no lock;
+ * interning takes a mutex, but each thread first checks a small cache
+ * of the names it interned recently.
+ */
+
+#include "symbol.h"
+#include "arena.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// ===========================================================================
+/// Definitions
+/// ===========================================================================
+
+#define _PAGE_BITS 12
+#define _PAGE_SIZE (1 << _PAGE_BITS)
+#define _MAX_PAGES (1 << 16)
+#define _CACHE_SIZE 256
+
+/// ===========================================================================
+/// Static variables
+/// ===========================================================================
+
+struct _Symbol
+{
+	const char* name;
+	uint32_t length;
+};
+
+/**
+ * Names are copied into an arena so their addresses never change. The
+ * hash table stores id + 1, with 0 marking an empty slot.
+ */
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct
+{
+	Arena arena;
+	struct _Symbol* pages[_MAX_PAGES];
+	uint32_t count;
+	uint32_t* table;
+	size_t tableSize;
+} _symbols;
+
+/**
+ * Per-thread cache of recent lookups, indexed by hash. Entries store
+ * id + 1, with 0 marking an empty entry.
+ */
+static _Thread_local uint32_t _cache[_CACHE_SIZE];
+
+/// ===========================================================================
+/// Static functions
+/// ===========================================================================
+
+static uint64_t _hash(const char* name, size_t len)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+
+	for (size_t n = 0; n < len; n++)
+	{
+		h ^= (unsigned char) name[n];
+		h *= 0x100000001b3ULL;
+	}
+
+	return h ^ (h >> 29);
+}
+
+static const struct _Symbol* _get(uint32_t id)
+{
+	return &_symbols.pages[id >> _PAGE_BITS][id & (_PAGE_SIZE - 1)];
+}
+
+static uint8_t _matches(uint32_t id, const char* name, size_t len)
+{
+	const struct _Symbol* symbol = _get(id);
+	return symbol->length == len && memcmp(symbol->name, name, len) == 0;
+}
+
+/**
+ * Returns the table slot holding the name, or the empty slot where it
+ * would be inserted. Caller holds _lock.
+ */
+static uint32_t* _probe(const char* name, size_t len, uint64_t hash)
+{
+	size_t mask = _symbols.tableSize - 1;
+	size_t n = hash & mask;
+
+	while (_symbols.table[n] != 0)
+	{
+		if (_matches(_symbols.table[n] - 1, name, len)) break;
+		n = (n + 1) & mask;
+	}
+
+	return &_symbols.table[n];
+}
+
+/**
+ * Doubles the hash table once it is half full. Caller holds _lock.
+ */
+static void _growTable()
+{
+	if (_symbols.count * 2 < _symbols.tableSize) return;
+
+	free(_symbols.table);
+	_symbols.tableSize *= 2;
+	_symbols.table = calloc(_symbols.tableSize, sizeof(uint32_t));
+
+	for (uint32_t id = 0; id < _symbols.count; id++)
+	{
+		const struct _Symbol* symbol = _get(id);
+		uint64_t hash = _hash(symbol->name, symbol->length);
+		*_probe(symbol->name, symbol->length, hash) = id + 1;
+	}
+}
+
+/// ===========================================================================
+/// Function definitions - Accessors
+/// ===========================================================================
+
+uint32_t Symbol_intern(const char* name, size_t len)
+{
+	uint64_t hash = _hash(name, len);
+	uint32_t* cached = &_cache[hash % _CACHE_SIZE];
+	if (*cached != 0 && _matches(*cached - 1, name, len)) return *cached - 1;
+
+	pthread_mutex_lock(&_lock);
+
+	if (_symbols.arena == NULL)
+	{
+		_symbols.arena = Arena_create();
+		_symbols.tableSize = 64;
+		_symbols.table = calloc(_symbols.tableSize, sizeof(uint32_t));
+	}
+
+	uint32_t* slot = _probe(name, len, hash);
+	uint32_t id = *slot - 1;
+
+	if (*slot == 0)
+	{
+		id = _symbols.count;
+		struct _Symbol** page = &_symbols.pages[id >> _PAGE_BITS];
+		if (*page == NULL) *page = malloc(_PAGE_SIZE * sizeof(struct _Symbol));
+
+		struct _Symbol* symbol = &(*page)[id & (_PAGE_SIZE - 1)];
+		symbol->name = Arena_copyString(_symbols.arena, name, len);
+		symbol->length = len;
+		*slot = id + 1;
+
+		__atomic_store_n(&_symbols.count, id + 1, __ATOMIC_RELEASE);
+		_growTable();
+	}
+
+	pthread_mutex_unlock(&_lock);
+	*cached = id + 1;
+	return id;
+}
+
+uint32_t Symbol_find(const char* name, size_t len)
+{
+	uint32_t id = SYMBOL_NONE;
+	pthread_mutex_lock(&_lock);
+
+	if (_symbols.arena != NULL)
+	{
+		uint32_t slot = *_probe(name, len, _hash(name, len));
+		if (slot != 0) id = slot - 1;
+	}
+
+	pthread_mutex_unlock(&_lock);
+	return id;
+}
+
+const char* Symbol_name(uint32_t id)
+{
+	return _get(id)->name;
+}
+
+uint32_t Symbol_count()
+{
+	return __atomic_load_n(&_symbols.count, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,446 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Unit testing for derivations in SD
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sd.h"
+#include "sentenceeval.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdarg.h>
+
+/**
+ * Checks that every line of the derivation follows from the premises and
+ * the assumptions open at that line, that citations point back, and that
+ * the derivation ends with the goal outside every subproof.
+ */
+static void _checkDerivation(const SDDerivation d, const Sentence goal)
+{
+	Sentence* given = malloc(d->size * sizeof(Sentence));
+	size_t numPremises = 0;
+
+	for (size_t i = 0; i < d->size; i++)
+	{
+		SDLine* line = &d->lines[i];
+
+		if (line->rule == SD_PREMISE)
+		{
+			assert(line->depth == 0 && numPremises == i);
+			given[numPremises++] = line->sentence;
+		}
+
+		else if (line->rule == SD_ASSUMPTION)
+		{
+			given[numPremises + line->depth - 1] = line->sentence;
+		}
+
+		for (uint8_t j = 0; j < line->numCitations; j++)
+		{
+			assert(line->citations[j].first >= 1);
+			assert(line->citations[j].first <= line->citations[j].last);
+			assert(line->citations[j].last <= i);
+		}
+
+		assert(Sentence_entails(given, numPremises + line->depth,
+			line->sentence));
+	}
+
+	assert(d->size > 0);
+	assert(d->lines[d->size - 1].sentence == goal);
+	assert(d->lines[d->size - 1].depth == 0);
+	assert(SDDerivation_check(d) == 0);
+	assert(SDDerivation_proves(d, given, numPremises, goal));
+	free(given);
+}
+
+/**
+ * Parses the premises and goal, and derives the goal with the given
+ * number of threads, or with SD_derive() if threads is 1.
+ */
+static SDDerivation _deriveWith(
+	SentenceSet set,
+	const char** premises,
+	size_t numPremises,
+	const char* goal,
+	size_t threads)
+{
+	Sentence parsed[8];
+
+	for (size_t i = 0; i < numPremises; i++)
+	{
+		parsed[i] = Sentence_parse(premises[i], set);
+	}
+
+	Sentence target = Sentence_parse(goal, set);
+	SDDerivation d = threads == 1
+		? SD_derive(set, parsed, numPremises, target, SD_DEPTH, SD_NODES)
+		: SD_deriveParallel(set, parsed, numPremises, target,
+			SD_DEPTH, SD_NODES, threads);
+	if (d) _checkDerivation(d, target);
+	return d;
+}
+
+static SDDerivation _derive(
+	SentenceSet set,
+	const char** premises,
+	size_t numPremises,
+	const char* goal)
+{
+	return _deriveWith(set, premises, numPremises, goal, 1);
+}
+
+static void _TEST_SD_DERIVE()
+{
+	SentenceSet set = SentenceSet_create();
+
+	const char* commute[] = {"a & b"};
+	const char* syllogism[] = {"a > b", "b > c"};
+	const char* disjunctive[] = {"a v b", "~a"};
+	const char* deMorgan[] = {"~(a v b)"};
+	const char* deMorganBack[] = {"(~a) & (~b)"};
+	const char* contraposition[] = {"a > b"};
+	const char* transitive[] = {"a = b", "b = c"};
+	const char* distribution[] = {"a & (b v c)"};
+	const char* exportation[] = {"(a & b) > c"};
+	const char* cases[] = {"a v b", "a > c", "b > c"};
+	const char* inconsistent[] = {"a", "~a"};
+	const char* weak[] = {"a v b"};
+
+	struct
+	{
+		const char** premises;
+		size_t numPremises;
+		const char* goal;
+	}
+	problems[] =
+	{
+		{commute, 1, "b & a"},
+		{syllogism, 2, "a > c"},
+		{NULL, 0, "a v ~a"},
+		{NULL, 0, "a > a"},
+		{disjunctive, 2, "b"},
+		{deMorgan, 1, "(~a) & (~b)"},
+		{deMorganBack, 1, "~(a v b)"},
+		{contraposition, 1, "(~b) > (~a)"},
+		{NULL, 0, "((a > b) > a) > a"},
+		{transitive, 2, "a = c"},
+		{distribution, 1, "(a & b) v (a & c)"},
+		{exportation, 1, "a > (b > c)"},
+		{cases, 3, "c"},
+		{inconsistent, 2, "b"},
+		{NULL, 0, "~(a & ~a)"},
+		{NULL, 0, "(a = b) = (b = a)"}
+	};
+
+	for (size_t i = 0; i < sizeof(problems) / sizeof(problems[0]); i++)
+	{
+		SDDerivation d = _derive(set, problems[i].premises,
+			problems[i].numPremises, problems[i].goal);
+		assert(d);
+		SDDerivation_free(d);
+	}
+
+	// Premises come first, and a premise that is the goal is reiterated
+	const char* both[] = {"a", "b"};
+	SDDerivation d = _derive(set, both, 2, "a");
+	assert(d && d->size == 3);
+	assert(d->lines[0].rule == SD_PREMISE && d->lines[1].rule == SD_PREMISE);
+	assert(d->lines[2].rule == SD_REITERATION);
+	assert(d->lines[2].citations[0].first == 1);
+	SDDerivation_free(d);
+
+	// Conditional proof cites its subproof
+	d = _derive(set, syllogism, 2, "a > c");
+	SDLine* last = &d->lines[d->size - 1];
+	assert(last->rule == SD_IMPLIES_INTRO && last->numCitations == 1);
+	assert(d->lines[last->citations[0].first - 1].rule == SD_ASSUMPTION);
+	assert(last->citations[0].last == d->size - 1);
+
+	char buffer[4096];
+	FILE* file = fmemopen(buffer, sizeof(buffer), "w");
+	size_t written = SDDerivation_write(file, d);
+	fclose(file);
+	assert(written == strlen(buffer));
+	assert(strstr(buffer, "1  a > b"));
+	assert(strstr(buffer, "3  | a"));
+	assert(strstr(buffer, ">I 3-"));
+	SDDerivation_write(stdout, d);
+	SDDerivation_free(d);
+
+	// Not valid, or not found within the limits
+	assert(!_derive(set, weak, 1, "a"));
+	assert(!_derive(set, NULL, 0, "a > b"));
+	Sentence goal = Sentence_parse("((a > b) > a) > a", set);
+	assert(!SD_derive(set, NULL, 0, goal, 2, SD_NODES));
+	assert(!SD_derive(set, NULL, 0, goal, SD_DEPTH, 3));
+
+	SentenceSet_free(set);
+	printf("_TEST_SD_DERIVE() : SUCCESS\n");
+}
+
+static void _TEST_SD_DERIVE_PARALLEL()
+{
+	SentenceSet set = SentenceSet_create();
+
+	const char* disjunctions[] = {"a v b", "c v d", "e v f"};
+	const char* syllogism[] = {"a > b", "b > c", "c > d", "d > e"};
+	const char* weak[] = {"a v b", "c v d"};
+
+	for (size_t threads = 2; threads <= 8; threads *= 2)
+	{
+		for (size_t n = 0; n < 10; n++)
+		{
+			SDDerivation d = _deriveWith(set, disjunctions, 3,
+				"(b v a) & ((d v c) & (f v e))", threads);
+			assert(d);
+			SDDerivation_free(d);
+
+			d = _deriveWith(set, syllogism, 4, "(~e) > (~a)", threads);
+			assert(d);
+			SDDerivation_free(d);
+
+			d = _deriveWith(set, NULL, 0, "((a > b) > a) > a", threads);
+			assert(d);
+			SDDerivation_free(d);
+
+		}
+
+		Sentence premises[2] = {Sentence_parse(weak[0], set),
+			Sentence_parse(weak[1], set)};
+		Sentence goal = Sentence_parse("a v c", set);
+		assert(!SD_deriveParallel(set, premises, 2, goal, SD_DEPTH, 20000,
+			threads));
+	}
+
+	// New sentences made by the threads join the set
+	size_t size = set->size;
+	SDDerivation d = _deriveWith(set, weak, 2, "(b v a) & (d v c)", 0);
+	assert(d && set->size > size);
+	SDDerivation_free(d);
+
+	SentenceSet_free(set);
+	printf("_TEST_SD_DERIVE_PARALLEL() : SUCCESS\n");
+}
+
+/**
+ * Appends a line citing lines or subproofs, given as first and last
+ * line numbers.
+ */
+static void _line(
+	SDDerivation d,
+	SentenceSet set,
+	const char* sentence,
+	SDRule rule,
+	uint32_t depth,
+	size_t numCitations,
+	...)
+{
+	SDCitation citations[3];
+	va_list args;
+	va_start(args, numCitations);
+
+	for (size_t i = 0; i < numCitations; i++)
+	{
+		citations[i].first = va_arg(args, size_t);
+		citations[i].last = va_arg(args, size_t);
+	}
+
+	va_end(args);
+	SDDerivation_add(d, Sentence_parse(sentence, set), rule, depth,
+		citations, numCitations);
+}
+
+static void _TEST_SDDERIVATION_CHECK()
+{
+	SentenceSet set = SentenceSet_create();
+	SDDerivation d = SDDerivation_create();
+	assert(SDDerivation_check(d) == 0);
+
+	_line(d, set, "a > b", SD_PREMISE, 0, 0);
+	_line(d, set, "b > c", SD_PREMISE, 0, 0);
+	_line(d, set, "a", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "b", SD_IMPLIES_ELIM, 1, 2, (size_t) 3, (size_t) 3,
+		(size_t) 1, (size_t) 1);
+	_line(d, set, "c", SD_IMPLIES_ELIM, 1, 2, (size_t) 2, (size_t) 2,
+		(size_t) 4, (size_t) 4);
+	_line(d, set, "a > c", SD_IMPLIES_INTRO, 0, 1, (size_t) 3, (size_t) 5);
+	assert(SDDerivation_check(d) == 0);
+
+	Sentence premises[2] = {d->lines[0].sentence, d->lines[1].sentence};
+	Sentence goal = d->lines[5].sentence;
+	assert(SDDerivation_proves(d, premises, 2, goal));
+	assert(!SDDerivation_proves(d, premises, 1, goal));
+	assert(!SDDerivation_proves(d, premises, 2, premises[0]));
+
+	// Lines of a closed subproof are not accessible
+	_line(d, set, "c", SD_REITERATION, 0, 1, (size_t) 5, (size_t) 5);
+	assert(SDDerivation_check(d) == 7);
+	d->size--;
+
+	// Nor is a subproof that is still open
+	d->lines[5].depth = 1;
+	assert(SDDerivation_check(d) == 6);
+	d->lines[5].depth = 0;
+
+	// Nor a cited range that is not a whole subproof
+	d->lines[5].citations[0].last = 4;
+	assert(SDDerivation_check(d) == 6);
+	d->lines[5].citations[0].last = 5;
+
+	// Premises come first, and subproofs open with assumptions
+	_line(d, set, "c > a", SD_PREMISE, 0, 0);
+	assert(SDDerivation_check(d) == 7);
+	d->size--;
+	_line(d, set, "a > c", SD_REITERATION, 1, 1, (size_t) 6, (size_t) 6);
+	assert(SDDerivation_check(d) == 7);
+	d->size--;
+
+	// Wrong sentences
+	d->lines[3].sentence = Sentence_parse("c", set);
+	assert(SDDerivation_check(d) == 4);
+	d->lines[3].sentence = Sentence_parse("b", set);
+	d->lines[3].rule = SD_IFF_ELIM;
+	assert(SDDerivation_check(d) == 4);
+	d->lines[3].rule = SD_IMPLIES_ELIM;
+	d->lines[3].numCitations = 1;
+	assert(SDDerivation_check(d) == 4);
+	d->lines[3].numCitations = 2;
+	assert(SDDerivation_check(d) == 0);
+	SDDerivation_free(d);
+
+	// Q and ~Q must be inside the ~I subproof
+	d = SDDerivation_create();
+	_line(d, set, "a", SD_PREMISE, 0, 0);
+	_line(d, set, "~a", SD_PREMISE, 0, 0);
+	_line(d, set, "b", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "a", SD_REITERATION, 1, 1, (size_t) 1, (size_t) 1);
+	_line(d, set, "~b", SD_NOT_INTRO, 0, 1, (size_t) 3, (size_t) 4);
+	assert(SDDerivation_check(d) == 5);
+
+	d->size = 4;
+	_line(d, set, "~a", SD_REITERATION, 1, 1, (size_t) 2, (size_t) 2);
+	_line(d, set, "~b", SD_NOT_INTRO, 0, 1, (size_t) 3, (size_t) 5);
+	assert(SDDerivation_check(d) == 0);
+	d->lines[5].rule = SD_NOT_ELIM;
+	assert(SDDerivation_check(d) == 6);
+	SDDerivation_free(d);
+
+	// Not in a subproof of its own either
+	d = SDDerivation_create();
+	_line(d, set, "a", SD_PREMISE, 0, 0);
+	_line(d, set, "~b", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "~a", SD_ASSUMPTION, 2, 0);
+	_line(d, set, "a", SD_REITERATION, 2, 1, (size_t) 1, (size_t) 1);
+	_line(d, set, "a", SD_NOT_ELIM, 1, 1, (size_t) 3, (size_t) 4);
+	_line(d, set, "b", SD_NOT_ELIM, 0, 1, (size_t) 2, (size_t) 5);
+	assert(SDDerivation_check(d) == 6);
+	SDDerivation_free(d);
+
+	// vE and =I take their subproofs in either order
+	d = SDDerivation_create();
+	_line(d, set, "a v b", SD_PREMISE, 0, 0);
+	_line(d, set, "b", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "b v a", SD_OR_INTRO, 1, 1, (size_t) 2, (size_t) 2);
+	_line(d, set, "a", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "b v a", SD_OR_INTRO, 1, 1, (size_t) 4, (size_t) 4);
+	_line(d, set, "b v a", SD_OR_ELIM, 0, 3, (size_t) 1, (size_t) 1,
+		(size_t) 2, (size_t) 3, (size_t) 4, (size_t) 5);
+	_line(d, set, "a", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "a", SD_ASSUMPTION, 1, 0);
+	_line(d, set, "a = a", SD_IFF_INTRO, 0, 2, (size_t) 7, (size_t) 7,
+		(size_t) 8, (size_t) 8);
+	assert(SDDerivation_check(d) == 0);
+	SDDerivation_free(d);
+
+	// Every derivation found by the search checks
+	const char* problems[][3] =
+	{
+		{"a & b", NULL, "b & a"},
+		{"~(a v b)", NULL, "(~a) & (~b)"},
+		{"a = b", "b = c", "a = c"},
+		{"a v b", "~a", "b"},
+		{NULL, NULL, "((a > b) > a) > a"}
+	};
+
+	for (size_t i = 0; i < sizeof(problems) / sizeof(problems[0]); i++)
+	{
+		size_t n = 0;
+		while (n < 2 && problems[i][n]) n++;
+		d = _derive(set, problems[i], n, problems[i][2]);
+		assert(d && SDDerivation_check(d) == 0);
+
+		// Breaking any citation is caught
+		for (size_t line = 0; line < d->size; line++)
+		{
+			for (uint8_t j = 0; j < d->lines[line].numCitations; j++)
+			{
+				SDCitation saved = d->lines[line].citations[j];
+				d->lines[line].citations[j].first = line + 1;
+				d->lines[line].citations[j].last = line + 1;
+				assert(SDDerivation_check(d) == line + 1);
+				d->lines[line].citations[j] = saved;
+			}
+		}
+
+		SDDerivation_free(d);
+	}
+
+	// Long derivations
+	d = SDDerivation_create();
+	_line(d, set, "a", SD_PREMISE, 0, 0);
+	Sentence a = d->lines[0].sentence;
+
+	for (size_t i = 0; i < 30000; i++)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "q%zu", i % 100);
+		Sentence q = SentenceSet_createAtomic(set, name, 0);
+		Sentence conditional = SentenceSet_createCompound(set,
+			MATERIAL_CONDITIONAL, q, a, 0);
+		SDCitation first = {1, 1};
+		SDCitation range = {d->size + 1, d->size + 2};
+
+		SDDerivation_add(d, q, SD_ASSUMPTION, 1, NULL, 0);
+		SDDerivation_add(d, a, SD_REITERATION, 1, &first, 1);
+		SDDerivation_add(d, conditional, SD_IMPLIES_INTRO, 0, &range, 1);
+	}
+
+	assert(SDDerivation_check(d) == 0);
+	SDDerivation_free(d);
+
+	SentenceSet_free(set);
+	printf("_TEST_SDDERIVATION_CHECK() : SUCCESS\n");
+}
+
+static void _TEST_SDRULE_TOSTRING()
+{
+	assert(strcmp(SDRule_toString(SD_PREMISE), "Premise") == 0);
+	assert(strcmp(SDRule_toString(SD_OR_ELIM), "vE") == 0);
+	assert(strcmp(SDRule_toString(SD_NOT_INTRO), "~I") == 0);
+	assert(strcmp(SDRule_toString(SD_IFF_ELIM), "=E") == 0);
+
+	for (SDRule rule = SD_PREMISE; rule <= SD_NOT_ELIM; rule++)
+	{
+		SDRule parsed;
+		assert(SDRule_parse(SDRule_toString(rule), &parsed));
+		assert(parsed == rule);
+	}
+
+	SDRule parsed;
+	assert(!SDRule_parse("&", &parsed));
+	assert(!SDRule_parse("", &parsed));
+	printf("_TEST_SDRULE_TOSTRING() : SUCCESS\n");
+}
+
+int main()
+{
+	_TEST_SDRULE_TOSTRING();
+	_TEST_SD_DERIVE();
+	_TEST_SD_DERIVE_PARALLEL();
+	_TEST_SDDERIVATION_CHECK();
+}
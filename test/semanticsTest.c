@@ -0,0 +1,1020 @@
+/**
+ * @author Michael Bianconi
+ * @since 04-18-2019
+ *
+ * Unit testing for the semantics of Sentences
+ */
+
+#include "sentence.h"
+#include "sentenceeval.h"
+#include "sentenceprogram.h"
+#include "sentencecnf.h"
+#include "sentencesat.h"
+#include "sentencesession.h"
+#include "sentencecount.h"
+#include "sentencebdd.h"
+#include "sentencetableau.h"
+#include "sentencenormal.h"
+#include "sentencemap.h"
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <pthread.h>
+
+/**
+ * Builds a random sentence over the variables p0 ... p(vars-1).
+ */
+static Sentence _randomSentence(
+	SentenceSet set,
+	uint32_t* seed,
+	int depth,
+	int vars)
+{
+	*seed = *seed * 1103515245 + 12345;
+	uint32_t r = (*seed >> 16) % 8;
+	uint8_t negated = (*seed >> 8) % 3 == 0;
+
+	if (depth == 0 || r < 2)
+	{
+		char name[16];
+		snprintf(name, sizeof(name), "p%u", (*seed >> 4) % vars);
+		return SentenceSet_createAtomic(set, name, negated);
+	}
+
+	Sentence left = _randomSentence(set, seed, depth - 1, vars);
+	Sentence right = _randomSentence(set, seed, depth - 1, vars);
+	return SentenceSet_createCompound(set, 1 + r % 4, left, right, negated);
+}
+
+/**
+ * Checks a sentence against every assignment of p0 ... p(vars-1), one
+ * at a time. Returns a bit mask of the truth values seen.
+ */
+static uint8_t _bruteForce(const Sentence s, int vars)
+{
+	uint8_t* values = calloc(Symbol_count(), 1);
+	uint8_t seen = 0;
+
+	for (uint32_t row = 0; row < (1u << vars); row++)
+	{
+		for (int k = 0; k < vars; k++)
+		{
+			char name[16];
+			snprintf(name, sizeof(name), "p%d", k);
+			values[Symbol_intern(name, strlen(name))] = (row >> k) & 1;
+		}
+		seen |= 1 << Sentence_evaluate(s, values);
+	}
+
+	free(values);
+	return seen;
+}
+
+static void _TEST_EVALUATE()
+{
+	SentenceSet set = SentenceSet_create();
+	Sentence s = Sentence_parse("(a & b) > ~(c v d)", set);
+	uint8_t* values = calloc(Symbol_count(), 1);
+	uint32_t a = Symbol_find("a", 1);
+	uint32_t c = Symbol_find("c", 1);
+
+	assert(Sentence_evaluate(s, values));
+	values[a] = 1;
+	values[Symbol_find("b", 1)] = 1;
+	assert(Sentence_evaluate(s, values));
+	values[c] = 1;
+	assert(!Sentence_evaluate(s, values));
+	values[a] = 0;
+	assert(Sentence_evaluate(s, values));
+
+	// Every operator, and negated atoms
+	values[c] = 0;
+	assert(!Sentence_evaluate(Sentence_parse("a = b", set), values));
+	assert(Sentence_evaluate(Sentence_parse("c = a", set), values));
+	assert(Sentence_evaluate(Sentence_parse("a > c", set), values));
+	assert(!Sentence_evaluate(Sentence_parse("b > c", set), values));
+	assert(Sentence_evaluate(Sentence_parse("(~a) & b", set), values));
+	assert(!Sentence_evaluate(Sentence_parse("a v c", set), values));
+
+	free(values);
+	SentenceSet_free(set);
+
+	printf("_TEST_EVALUATE() : SUCCESS\n");
+}
+
+static void _TEST_TRUTH_TABLE()
+{
+	SentenceSet set = SentenceSet_create();
+
+	assert(Sentence_isTautology(Sentence_parse("a v ~a", set)));
+	assert(Sentence_isTautology(Sentence_parse("(a & b) > a", set)));
+	assert(Sentence_isTautology(
+		Sentence_parse("((a > b) & (b > c)) > (a > c)", set)));
+	assert(!Sentence_isTautology(Sentence_parse("a > b", set)));
+	assert(Sentence_isContradiction(Sentence_parse("a & ~a", set)));
+	assert(Sentence_isContradiction(Sentence_parse("~(a > a)", set)));
+	assert(!Sentence_isContradiction(Sentence_parse("a = b", set)));
+
+	// De Morgan, and the definition of the conditional
+	assert(Sentence_areEquivalent(
+		Sentence_parse("~(a & b)", set), Sentence_parse("(~a) v ~b", set)));
+	assert(Sentence_areEquivalent(
+		Sentence_parse("a > b", set), Sentence_parse("(~a) v b", set)));
+	assert(!Sentence_areEquivalent(
+		Sentence_parse("a > b", set), Sentence_parse("b > a", set)));
+
+	// Modus ponens, and a fallacy with its counterexample
+	Sentence premises[2] =
+	{
+		Sentence_parse("a > b", set),
+		Sentence_parse("a", set)
+	};
+	assert(Sentence_entails(premises, 2, Sentence_parse("b", set)));
+	premises[1] = Sentence_parse("b", set);
+	Sentence conclusion = Sentence_parse("a", set);
+	assert(!Sentence_entails(premises, 2, conclusion));
+
+	uint8_t* values = calloc(Symbol_count(), 1);
+	assert(Sentence_findCounterexample(premises, 2, conclusion, 1, values));
+	assert(Sentence_evaluate(premises[0], values));
+	assert(Sentence_evaluate(premises[1], values));
+	assert(!Sentence_evaluate(conclusion, values));
+	free(values);
+
+	// Inconsistent premises entail anything, including a contradiction
+	premises[1] = Sentence_parse("a & ~b", set);
+	assert(Sentence_entails(premises, 2, NULL));
+	assert(!Sentence_entails(premises, 1, NULL));
+	assert(!Sentence_entails(NULL, 0, NULL));
+
+	SentenceSet_free(set);
+
+	printf("_TEST_TRUTH_TABLE() : SUCCESS\n");
+}
+
+static void _TEST_TRUTH_TABLE_RANDOM()
+{
+	SentenceSet set = SentenceSet_create();
+	uint32_t seed = 3;
+
+	for (int n = 0; n < 300; n++)
+	{
+		int vars = 1 + n % 9;
+		Sentence s = _randomSentence(set, &seed, 7, vars);
+		Sentence t = _randomSentence(set, &seed, 3, vars);
+		uint8_t seen = _bruteForce(s, vars);
+
+		assert(Sentence_isTautology(s) == (seen == 2));
+		assert(Sentence_isContradiction(s) == (seen == 1));
+		assert(Sentence_areEquivalent(s, t) == (_bruteForce(
+			SentenceSet_createCompound(set, MATERIAL_BICONDITIONAL, s, t, 0),
+			vars) == 2));
+	}
+
+	SentenceSet_free(set);
+
+	printf("_TEST_TRUTH_TABLE_RANDOM() : SUCCESS\n");
+}
+
+static void _TEST_TRUTH_TABLE_THREADS()
+{
+	// 2^24 rows, and the only counterexample is the last one
+	SentenceSet set = SentenceSet_create();
+	Sentence all = SentenceSet_createAtomic(set, "x0", 0);
+
+	for (int k = 1; k < 24; k++)
+	{
+		char name[16];
+		snprintf(name, sizeof(name), "x%d", k);
+		all = SentenceSet_createCompound(
+			set, AND, SentenceSet_createAtomic(set, name, 0), all, 0);
+	}
+
+	Sentence none = SentenceSet_createCompound(
+		set, all->op, all->left.sentence, all->right.sentence, 1);
+	uint8_t* values = calloc(Symbol_count(), 1);
+
+	assert(Sentence_findCounterexample(NULL, 0, none, 4, values));
+	for (int k = 0; k < 24; k++)
+	{
+		char name[16];
+		snprintf(name, sizeof(name), "x%d", k);
+		assert(values[Symbol_find(name, strlen(name))] == 1);
+	}
+
+	Sentence x0 = SentenceSet_createAtomic(set, "x0", 0);
+	assert(!Sentence_findCounterexample(&all, 1, x0, 4, NULL));
+	assert(Sentence_entails(&all, 1, x0));
+
+	free(values);
+	SentenceSet_free(set);
+
+	printf("_TEST_TRUTH_TABLE_THREADS() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCEPROGRAM()
+{
+	SentenceSet set = SentenceSet_create();
+
+	// The shared subsentence is computed once
+	Sentence s = Sentence_parse("(a & b) v ~((a & b) > c)", set);
+	SentenceProgram program = SentenceProgram_compile(s);
+	assert(program->numVariables == 3 && program->numSlots == 1);
+	assert(program->size == 9);
+	assert(program->code[3].opcode == OPCODE_STORE);
+	assert(program->code[4].opcode == OPCODE_FETCH);
+	SentenceProgram_free(program);
+
+	// Programs agree with the sentence, one at a time and in batches
+	const size_t count = 1000;
+	size_t stride = Symbol_count() + 16;
+	uint8_t* assignments = malloc(count * stride);
+	uint8_t* results = malloc(count);
+	uint32_t seed = 5;
+
+	for (int n = 0; n < 100; n++)
+	{
+		s = _randomSentence(set, &seed, 8, 1 + n % 12);
+		program = SentenceProgram_compile(s);
+		assert(Symbol_count() <= stride);
+
+		for (size_t i = 0; i < count * stride; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			assignments[i] = (seed >> 16) % 3 == 0 ? 0 : (seed >> 20) % 4;
+		}
+
+		SentenceProgram_evaluateBatch(
+			program, assignments, count - n, stride, results);
+
+		for (size_t i = 0; i < count - n; i++)
+		{
+			const uint8_t* values = assignments + i * stride;
+			uint8_t expected = Sentence_evaluate(s, values);
+			assert(SentenceProgram_evaluate(program, values) == expected);
+			assert(results[i] == expected);
+		}
+
+		SentenceProgram_free(program);
+	}
+
+	free(assignments);
+	free(results);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCEPROGRAM() : SUCCESS\n");
+}
+
+/**
+ * Returns the atomic sentence named prefix followed by the numbers.
+ */
+static Sentence _variable(SentenceSet set, const char* prefix, int i, int j)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%s%d_%d", prefix, i, j);
+	return SentenceSet_createAtomic(set, name, 0);
+}
+
+static void _TEST_SENTENCECNF()
+{
+	SentenceSet set = SentenceSet_create();
+	SentenceCNF cnf = SentenceCNF_create();
+
+	// One definition per compound node, negation is free
+	uint32_t literal = SentenceCNF_encode(cnf,
+		Sentence_parse("~((a & b) = a)", set));
+	assert(cnf->numVariables == 4 && cnf->numClauses == 7);
+	assert(CNF_IS_NEGATED(literal));
+	assert(cnf->symbols[0] == Symbol_find("a", 1));
+	assert(cnf->symbols[2] == SYMBOL_NONE);
+
+	// Shared nodes are encoded once
+	assert(SentenceCNF_encode(cnf, Sentence_parse("a & b", set))
+		== CNF_LITERAL(2, 0));
+	SentenceCNF_assert(cnf, Sentence_parse("(a & b) v c", set));
+	assert(cnf->numVariables == 6 && cnf->numClauses == 11);
+	assert(cnf->clauses[11] - cnf->clauses[10] == 1);
+
+	SentenceCNF_free(cnf);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCECNF() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCESAT()
+{
+	SentenceSet set = SentenceSet_create();
+	uint8_t* values = calloc(Symbol_count() + 1000, 1);
+
+	assert(SentenceSAT_isValid(Sentence_parse("a v ~a", set), NULL));
+	assert(!SentenceSAT_isSatisfiable(Sentence_parse("a & ~a", set), NULL));
+	assert(!SentenceSAT_isValid(Sentence_parse("a > b", set), values));
+	assert(!Sentence_evaluate(Sentence_parse("a > b", set), values));
+
+	Sentence s = Sentence_parse("(a = ~b) & (b v c) & ~c", set);
+	assert(SentenceSAT_isSatisfiable(s, values));
+	assert(Sentence_evaluate(s, values));
+
+	// Agrees with the truth table
+	uint32_t seed = 9;
+	for (int n = 0; n < 300; n++)
+	{
+		int vars = 1 + n % 10;
+		Sentence t = _randomSentence(set, &seed, 8, vars);
+		Sentence u = _randomSentence(set, &seed, 4, vars);
+
+		assert(SentenceSAT_isValid(t, NULL) == Sentence_isTautology(t));
+		assert(SentenceSAT_isSatisfiable(t, values)
+			== !Sentence_isContradiction(t));
+		if (!Sentence_isContradiction(t)) assert(Sentence_evaluate(t, values));
+		assert(SentenceSAT_entails(&t, 1, u, NULL) == Sentence_entails(&t, 1, u));
+	}
+
+	// Seven pigeons do not fit in six holes
+	const int pigeons = 7;
+	Sentence premises[64];
+	size_t numPremises = 0;
+
+	for (int i = 0; i < pigeons; i++)
+	{
+		Sentence somewhere = _variable(set, "p", i, 0);
+		for (int h = 1; h < pigeons - 1; h++)
+		{
+			somewhere = SentenceSet_createCompound(
+				set, OR, _variable(set, "p", i, h), somewhere, 0);
+		}
+		premises[numPremises++] = somewhere;
+	}
+
+	for (int h = 0; h < pigeons - 1; h++)
+	{
+		Sentence alone = NULL;
+		for (int i = 0; i < pigeons; i++)
+		{
+			for (int j = i + 1; j < pigeons; j++)
+			{
+				Sentence both = SentenceSet_createCompound(set, AND,
+					_variable(set, "p", i, h), _variable(set, "p", j, h), 1);
+				alone = alone == NULL ? both
+					: SentenceSet_createCompound(set, AND, both, alone, 0);
+			}
+		}
+		premises[numPremises++] = alone;
+	}
+
+	assert(SentenceSAT_entails(premises, numPremises, NULL, NULL));
+	assert(!SentenceSAT_entails(premises, numPremises - 1, NULL, NULL));
+
+	// Hundreds of variables: a chain of conditionals
+	Sentence chain[400];
+	for (int i = 0; i < 400; i++)
+	{
+		chain[i] = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+			_variable(set, "x", i, 0), _variable(set, "x", i + 1, 0), 0);
+	}
+
+	Sentence first = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+		_variable(set, "x", 0, 0), _variable(set, "x", 400, 0), 0);
+	Sentence last = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+		_variable(set, "x", 400, 0), _variable(set, "x", 0, 0), 0);
+	assert(SentenceSAT_entails(chain, 400, first, NULL));
+	assert(Sentence_entails(chain, 400, first));
+	free(values);
+	values = calloc(Symbol_count(), 1);
+	assert(Sentence_findCounterexample(chain, 400, last, 0, NULL));
+	assert(!SentenceSAT_entails(chain, 400, last, values));
+	assert(values[Symbol_find("x0_0", 4)] == 0);
+	assert(values[Symbol_find("x400_0", 6)] == 1);
+
+	free(values);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCESAT() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCESOLVER()
+{
+	// Clauses can be added between calls, and assumptions hold for one
+	SentenceCNF cnf = SentenceCNF_create();
+	uint32_t a = SentenceCNF_newVariable(cnf, SYMBOL_NONE);
+	uint32_t b = SentenceCNF_newVariable(cnf, SYMBOL_NONE);
+	uint32_t clause[2] = {CNF_LITERAL(a, 0), CNF_LITERAL(b, 0)};
+	SentenceCNF_addClause(cnf, clause, 2);
+
+	SentenceSolver solver = SentenceSolver_create(cnf);
+	assert(SentenceSolver_solve(solver, NULL, 0));
+
+	uint32_t notA = CNF_LITERAL(a, 1);
+	assert(SentenceSolver_solve(solver, &notA, 1));
+	assert(SentenceSolver_value(solver, CNF_LITERAL(b, 0)));
+
+	uint32_t notB = CNF_LITERAL(b, 1);
+	SentenceCNF_addClause(cnf, &notB, 1);
+	assert(!SentenceSolver_solve(solver, &notA, 1));
+	assert(SentenceSolver_solve(solver, NULL, 0));
+	assert(SentenceSolver_value(solver, CNF_LITERAL(a, 0)));
+
+	SentenceCNF_addClause(cnf, &notA, 1);
+	assert(!SentenceSolver_solve(solver, NULL, 0));
+
+	SentenceSolver_free(solver);
+	SentenceCNF_free(cnf);
+
+	printf("_TEST_SENTENCESOLVER() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCESESSION()
+{
+	SentenceSet set = SentenceSet_create();
+
+	// A chain of implications, asked about many times
+	const int length = 200;
+	Sentence premises[200];
+	for (int n = 0; n < length; n++)
+	{
+		premises[n] = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+			_variable(set, "q", n, 0), _variable(set, "q", n + 1, 0), 0);
+	}
+
+	SentenceSession session = SentenceSession_create(premises, length);
+	uint8_t* values = calloc(Symbol_count() + 1000, 1);
+	assert(SentenceSession_isConsistent(session, values));
+	for (int n = 0; n < length; n++) assert(Sentence_evaluate(premises[n], values));
+
+	Sentence first = _variable(set, "q", 0, 0);
+	for (int n = 1; n <= length; n += 7)
+	{
+		Sentence last = _variable(set, "q", n, 0);
+		Sentence forward = SentenceSet_createCompound(set,
+			MATERIAL_CONDITIONAL, first, last, 0);
+		Sentence backward = SentenceSet_createCompound(set,
+			MATERIAL_CONDITIONAL, last, first, 0);
+
+		assert(SentenceSession_entails(session, forward, NULL));
+		assert(SentenceSession_entails(session, forward, NULL));
+		assert(SentenceSession_entails(session, premises[n - 1], NULL));
+		assert(!SentenceSession_entails(session, backward, values));
+		assert(!Sentence_evaluate(backward, values));
+		for (int m = 0; m < length; m++) assert(Sentence_evaluate(premises[m], values));
+	}
+
+	// Premises can be added between questions
+	Sentence end = _variable(set, "q", length, 0);
+	Sentence loop = SentenceSet_createCompound(set,
+		MATERIAL_CONDITIONAL, end, first, 0);
+	Sentence back = SentenceSet_createCompound(set,
+		MATERIAL_CONDITIONAL, _variable(set, "q", 5, 0), first, 0);
+	assert(!SentenceSession_entails(session, back, NULL));
+	SentenceSession_addPremise(session, loop);
+	assert(SentenceSession_entails(session, back, NULL));
+
+	Sentence notFirst = SentenceSet_createAtomic(set, "q0_0", 1);
+	SentenceSession_addPremise(session, first);
+	assert(SentenceSession_isConsistent(session, NULL));
+	SentenceSession_addPremise(session, notFirst);
+	assert(!SentenceSession_isConsistent(session, NULL));
+	assert(SentenceSession_entails(session, notFirst, NULL));
+	SentenceSession_free(session);
+
+	// Agrees with the truth table
+	uint32_t seed = 21;
+	for (int n = 0; n < 20; n++)
+	{
+		Sentence library[4];
+		for (int m = 0; m < 4; m++) library[m] = _randomSentence(set, &seed, 4, 6);
+		session = SentenceSession_create(library, 4);
+
+		for (int m = 0; m < 20; m++)
+		{
+			Sentence u = _randomSentence(set, &seed, 4, 6);
+			uint8_t entailed = Sentence_entails(library, 4, u);
+			assert(SentenceSession_entails(session, u, values) == entailed);
+			if (!entailed) assert(!Sentence_evaluate(u, values));
+		}
+
+		SentenceSession_free(session);
+	}
+
+	free(values);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCESESSION() : SUCCESS\n");
+}
+
+/**
+ * Counts the models of the sentence by its truth table.
+ */
+static uint64_t _countByTable(const Sentence s)
+{
+	SentenceProgram program = SentenceProgram_compile(s);
+	uint8_t* values = calloc(Symbol_count() + 1, 1);
+	uint64_t count = 0;
+
+	for (uint64_t row = 0; row < (1ULL << program->numVariables); row++)
+	{
+		for (size_t n = 0; n < program->numVariables; n++)
+		{
+			values[program->variables[n]] = (row >> n) & 1;
+		}
+
+		count += SentenceProgram_evaluate(program, values);
+	}
+
+	free(values);
+	SentenceProgram_free(program);
+	return count;
+}
+
+struct _Models
+{
+	Sentence sentence;
+	SentenceProgram program;
+	uint64_t found;
+	uint64_t last;
+	uint64_t limit;
+};
+
+static uint8_t _checkModel(const uint8_t* values, void* data)
+{
+	struct _Models* m = data;
+	assert(Sentence_evaluate(m->sentence, values));
+
+	// Models arrive in increasing order, so none is repeated
+	uint64_t key = 0;
+	for (size_t n = 0; n < m->program->numVariables; n++)
+	{
+		key = key << 1 | values[m->program->variables[n]];
+	}
+
+	assert(m->found == 0 || key > m->last);
+	m->last = key;
+	return ++m->found < m->limit;
+}
+
+/**
+ * Counts the models of a 2-CNF chain, ~u0 v u1, ~u1 v u2 and on.
+ */
+static void* _countChain(void* arg)
+{
+	SentenceSet set = arg;
+	Sentence* clauses = malloc(8000 * sizeof(Sentence));
+	for (int n = 0; n < 8000; n++)
+	{
+		Sentence u = _variable(set, "u", n, 0);
+		clauses[n] = SentenceSet_createCompound(set, OR,
+			SentenceSet_createAtomic(set, Symbol_name(u->id), 1),
+			_variable(set, "u", n + 1, 0), 0);
+	}
+
+	assert(Sentence_countModels(clauses, 8000) == 8002);
+	free(clauses);
+	return NULL;
+}
+
+static void _TEST_SENTENCECOUNT()
+{
+	SentenceSet set = SentenceSet_create();
+
+	Sentence s = Sentence_parse("a v b", set);
+	assert(Sentence_countModels(&s, 1) == 3);
+	s = Sentence_parse("a & ~a", set);
+	assert(Sentence_countModels(&s, 1) == 0);
+	assert(Sentence_countModels(NULL, 0) == 1);
+
+	// Agrees with the truth table
+	uint32_t seed = 33;
+	for (int n = 0; n < 300; n++)
+	{
+		Sentence t = _randomSentence(set, &seed, 7, 1 + n % 12);
+		uint64_t count = _countByTable(t);
+		assert(Sentence_countModels(&t, 1) == count);
+
+		struct _Models m = {t, SentenceProgram_compile(t), 0, 0, UINT64_MAX};
+		assert(Sentence_enumerateModels(&t, 1, _checkModel, &m) == count);
+		assert(m.found == count);
+
+		m.found = 0;
+		m.limit = 3;
+		uint64_t expect = count < 3 ? count : 3;
+		assert(Sentence_enumerateModels(&t, 1, _checkModel, &m) == expect);
+		SentenceProgram_free(m.program);
+	}
+
+	// Independent parts are counted apart: 3^20 models over 40 variables
+	Sentence parts[20];
+	for (int n = 0; n < 20; n++)
+	{
+		parts[n] = SentenceSet_createCompound(set, OR,
+			_variable(set, "r", n, 0), _variable(set, "r", n, 1), 0);
+	}
+	assert(Sentence_countModels(parts, 20) == 3486784401ULL);
+
+	// A chain of 300 implications has 302 models
+	Sentence chain[300];
+	for (int n = 0; n < 300; n++)
+	{
+		chain[n] = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+			_variable(set, "s", n, 0), _variable(set, "s", n + 1, 0), 0);
+	}
+	assert(Sentence_countModels(chain, 300) == 302);
+
+	// Long chains do not recurse, so a small stack is enough
+	pthread_attr_t attributes;
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, 256 * 1024);
+	pthread_t thread;
+	assert(pthread_create(&thread, &attributes, _countChain, set) == 0);
+	pthread_join(thread, NULL);
+	pthread_attr_destroy(&attributes);
+
+	// 2^100 models saturate
+	Sentence wide[100];
+	for (int n = 0; n < 100; n++)
+	{
+		Sentence v = _variable(set, "t", n, 0);
+		wide[n] = SentenceSet_createCompound(set, OR, v,
+			SentenceSet_createAtomic(set, Symbol_name(v->id), 1), 0);
+	}
+	assert(Sentence_countModels(wide, 100) == UINT64_MAX);
+	SentenceSet_free(set);
+
+	// A set counts the sentences added to it, even those inside others
+	set = SentenceSet_create();
+	Sentence_parse("a > b", set);
+	Sentence_parse("b > c", set);
+	assert(SentenceSet_countModels(set) == 4);
+	Sentence_parse("a", set);
+	assert(SentenceSet_countModels(set) == 1);
+
+	s = Sentence_parse("((a > b) & (b > c)) & a", set);
+	struct _Models m = {s, SentenceProgram_compile(s), 0, 0, UINT64_MAX};
+	assert(SentenceSet_enumerateModels(set, _checkModel, &m) == 1);
+	SentenceProgram_free(m.program);
+	SentenceSet_free(set);
+
+	// Parsing a negated premise also creates its unnegated base
+	set = SentenceSet_create();
+	s = Sentence_parse("~(a & b)", set);
+	assert(set->addedCount == 1 && set->added[0] == s);
+	assert(SentenceSet_countModels(set) == 3);
+	SentenceSet_add(set, SentenceSet_createAtomic(set, "a", 0));
+	assert(SentenceSet_countModels(set) == 1);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCECOUNT() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCEBDD()
+{
+	SentenceSet set = SentenceSet_create();
+	SentenceBDDManager manager = SentenceBDDManager_create();
+	uint8_t* values = calloc(Symbol_count() + 1000, 1);
+
+	// Equivalent sentences are the same node
+	SentenceBDD f = SentenceBDD_fromSentence(manager,
+		Sentence_parse("a > b", set));
+	SentenceBDD g = SentenceBDD_fromSentence(manager,
+		Sentence_parse("(~a) v b", set));
+	assert(f == g);
+	f = SentenceBDD_fromSentence(manager, Sentence_parse("(a & b) > c", set));
+	g = SentenceBDD_fromSentence(manager, Sentence_parse("a > (b > c)", set));
+	assert(f == g);
+	assert(SentenceBDD_countModels(manager, f) == 7);
+
+	f = SentenceBDD_fromSentence(manager, Sentence_parse("a v ~a", set));
+	assert(SentenceBDD_isTautology(manager, f));
+	f = SentenceBDD_fromSentence(manager, Sentence_parse("a & ~a", set));
+	assert(!SentenceBDD_isSatisfiable(manager, f, values));
+
+	Sentence s = Sentence_parse("(a = ~b) & (b v c) & ~c", set);
+	f = SentenceBDD_fromSentence(manager, s);
+	assert(SentenceBDD_isSatisfiable(manager, f, values));
+	assert(Sentence_evaluate(s, values));
+
+	// Agrees with the truth table and the counter
+	uint32_t seed = 45;
+	for (int n = 0; n < 200; n++)
+	{
+		Sentence t = _randomSentence(set, &seed, 6, 8);
+		Sentence u = _randomSentence(set, &seed, 6, 8);
+		f = SentenceBDD_fromSentence(manager, t);
+		g = SentenceBDD_fromSentence(manager, u);
+
+		assert((f == g) == Sentence_areEquivalent(t, u));
+		assert(SentenceBDD_isTautology(manager, f) == Sentence_isTautology(t));
+		assert(SentenceBDD_isSatisfiable(manager, f, values)
+			== !Sentence_isContradiction(t));
+		if (f != SENTENCEBDD_FALSE) assert(Sentence_evaluate(t, values));
+
+		SentenceBDDManager bdds = SentenceBDDManager_create();
+		SentenceBDD h = SentenceBDD_fromSentence(bdds, t);
+		assert(SentenceBDD_countModels(bdds, h) == _countByTable(t));
+		SentenceBDDManager_free(bdds);
+
+		SentenceBDD_release(manager, f);
+		SentenceBDD_release(manager, g);
+	}
+
+	SentenceBDDManager_collect(manager);
+	SentenceBDDManager_free(manager);
+
+	// (x0 & y0) v ... v (x9 & y9) is exponential with every x first, and
+	// linear with each x next to its y
+	const size_t pairs = 10;
+	manager = SentenceBDDManager_create();
+	uint32_t symbols[20];
+	for (size_t n = 0; n < pairs; n++)
+	{
+		symbols[n] = _variable(set, "x", (int) n, 0)->id;
+		symbols[pairs + n] = _variable(set, "y", (int) n, 0)->id;
+	}
+	SentenceBDDManager_setOrder(manager, symbols, 2 * pairs);
+
+	Sentence sum = NULL;
+	for (size_t n = 0; n < pairs; n++)
+	{
+		Sentence term = SentenceSet_createCompound(set, AND,
+			_variable(set, "x", (int) n, 0), _variable(set, "y", (int) n, 0), 0);
+		sum = sum == NULL ? term
+			: SentenceSet_createCompound(set, OR, sum, term, 0);
+	}
+
+	f = SentenceBDD_fromSentence(manager, sum);
+	uint64_t count = SentenceBDD_countModels(manager, f);
+	assert(SentenceBDD_size(manager, f) > 2000);
+
+	SentenceBDDManager_reorder(manager);
+	assert(SentenceBDD_size(manager, f) == 2 * pairs + 2);
+	assert(SentenceBDD_countModels(manager, f) == count);
+	assert(SentenceBDDManager_size(manager) == 2 * pairs);
+	assert(SentenceBDD_fromSentence(manager, sum) == f);
+
+	for (size_t n = 0; n < pairs; n++)
+	{
+		uint32_t x = SentenceBDDManager_level(manager, symbols[n]);
+		uint32_t y = SentenceBDDManager_level(manager, symbols[pairs + n]);
+		assert(x == y + 1 || y == x + 1);
+	}
+
+	SentenceBDDManager_setOrder(manager, symbols, 2 * pairs);
+	assert(SentenceBDD_size(manager, f) > 2000);
+	assert(SentenceBDD_countModels(manager, f) == count);
+	SentenceBDDManager_free(manager);
+
+	// Sets build the conjunction of the sentences added to them
+	SentenceSet_free(set);
+	set = SentenceSet_create();
+	Sentence_parse("a > b", set);
+	Sentence_parse("b > c", set);
+	manager = SentenceBDDManager_create();
+	f = SentenceBDD_fromSet(manager, set);
+	g = SentenceBDD_fromSentence(manager,
+		Sentence_parse("(a > b) & (b > c)", set));
+	assert(f == g);
+	assert(SentenceBDD_countModels(manager, f) == 4);
+	Sentence_parse("~(a & c)", set);
+	f = SentenceBDD_fromSet(manager, set);
+	assert(SentenceBDD_countModels(manager, f) == 3);
+	SentenceBDDManager_free(manager);
+
+	free(values);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCEBDD() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCETABLEAU()
+{
+	SentenceSet set = SentenceSet_create();
+	uint8_t* values = calloc(Symbol_count() + 1000, 1);
+
+	assert(SentenceTableau_isValid(Sentence_parse("a v ~a", set), NULL));
+	assert(SentenceTableau_isValid(
+		Sentence_parse("((a > b) & (b > c)) > (a > c)", set), NULL));
+	assert(SentenceTableau_isValid(
+		Sentence_parse("~(a = b) = (a = ~b)", set), NULL));
+
+	Sentence s = Sentence_parse("~((a > b) v (b = c))", set);
+	assert(SentenceTableau_isSatisfiable(&s, 1, values));
+	assert(Sentence_evaluate(s, values));
+
+	s = Sentence_parse("a > b", set);
+	assert(!SentenceTableau_isValid(s, values));
+	assert(!Sentence_evaluate(s, values));
+
+	// Agrees with the truth table
+	uint32_t seed = 57;
+	for (int n = 0; n < 300; n++)
+	{
+		int vars = 1 + n % 10;
+		Sentence t = _randomSentence(set, &seed, 8, vars);
+		Sentence u = _randomSentence(set, &seed, 4, vars);
+
+		assert(SentenceTableau_isValid(t, NULL) == Sentence_isTautology(t));
+		assert(SentenceTableau_isSatisfiable(&t, 1, values)
+			== !Sentence_isContradiction(t));
+		if (!Sentence_isContradiction(t)) assert(Sentence_evaluate(t, values));
+
+		uint8_t entailed = Sentence_entails(&t, 1, u);
+		assert(SentenceTableau_entails(&t, 1, u, values) == entailed);
+		if (!entailed)
+		{
+			assert(Sentence_evaluate(t, values));
+			assert(!Sentence_evaluate(u, values));
+		}
+	}
+
+	// Many variables but little branching
+	Sentence chain[300];
+	for (int n = 0; n < 300; n++)
+	{
+		chain[n] = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+			_variable(set, "u", n, 0), _variable(set, "u", n + 1, 0), 0);
+	}
+
+	Sentence first = _variable(set, "u", 0, 0);
+	Sentence last = _variable(set, "u", 300, 0);
+	Sentence conclusion = SentenceSet_createCompound(set,
+		MATERIAL_CONDITIONAL, first, last, 0);
+	assert(SentenceTableau_entails(chain, 300, conclusion, NULL));
+	assert(SentenceTableau_entails(chain, 300, NULL, NULL) == 0);
+
+	conclusion = SentenceSet_createCompound(set,
+		MATERIAL_CONDITIONAL, last, first, 0);
+	values = realloc(values, Symbol_count() + 1);
+	assert(!SentenceTableau_entails(chain, 300, conclusion, values));
+	assert(!Sentence_evaluate(conclusion, values));
+
+	free(values);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCETABLEAU() : SUCCESS\n");
+}
+
+/**
+ * Checks that the sentence is in the normal form: negations only on
+ * variables, only & and v, and for DNF and CNF no inner operator above
+ * an outer one. Visits each member once per place it can be in.
+ */
+static void _checkNormal(const Sentence sentence, NormalForm form)
+{
+	SentenceMap seen[2] = {SentenceMap_create(), SentenceMap_create()};
+	size_t stackSize = 64;
+	Sentence* stack = malloc(stackSize * sizeof(Sentence));
+	uint8_t* inTerm = malloc(stackSize);
+	size_t top = 0;
+	stack[top] = sentence;
+	inTerm[top++] = 0;
+
+	while (top > 0)
+	{
+		Sentence s = stack[--top];
+		uint8_t term = inTerm[top];
+		if (s->type == ATOMIC || SentenceMap_get(seen[term], s, NULL))
+			continue;
+		SentenceMap_put(seen[term], s, NULL);
+
+		assert(!s->negated);
+		assert(s->op == AND || s->op == OR);
+
+		uint8_t inner = (form == NORMAL_DNF && s->op == AND)
+			|| (form == NORMAL_CNF && s->op == OR);
+		if (form != NORMAL_NNF) assert(inner || !term);
+
+		if (top + 2 > stackSize)
+		{
+			stackSize *= 2;
+			stack = realloc(stack, stackSize * sizeof(Sentence));
+			inTerm = realloc(inTerm, stackSize);
+		}
+
+		stack[top] = s->left.sentence;
+		inTerm[top++] = term || inner;
+		stack[top] = s->right.sentence;
+		inTerm[top++] = term || inner;
+	}
+
+	free(stack);
+	free(inTerm);
+	SentenceMap_free(seen[0]);
+	SentenceMap_free(seen[1]);
+}
+
+static void _TEST_SENTENCENORMAL()
+{
+	SentenceSet set = SentenceSet_create();
+	SentenceNormalizer nnf = SentenceNormalizer_create(set, NORMAL_NNF, 0);
+	SentenceNormalizer dnf = SentenceNormalizer_create(set, NORMAL_DNF,
+		NORMAL_BUDGET);
+	SentenceNormalizer cnf = SentenceNormalizer_create(set, NORMAL_CNF,
+		NORMAL_BUDGET);
+
+	// Negations move inward, and double negations cancel
+	assert(SentenceNormalizer_apply(nnf, Sentence_parse("~(a & b)", set))
+		== Sentence_parse("(~a) v ~b", set));
+	assert(SentenceNormalizer_apply(nnf, Sentence_parse("~(a > ~b)", set))
+		== Sentence_parse("a & b", set));
+	assert(SentenceNormalizer_apply(nnf, Sentence_parse("~(a = b)", set))
+		== Sentence_parse("((~a) & b) v (a & ~b)", set));
+
+	// Idempotence and absorption
+	Sentence a = Sentence_parse("a", set);
+	assert(SentenceNormalizer_apply(nnf, Sentence_parse("a v a", set)) == a);
+	assert(SentenceNormalizer_apply(nnf,
+		Sentence_parse("(a v b) & a", set)) == a);
+	assert(SentenceNormalizer_apply(nnf,
+		Sentence_parse("~((~a) & ~(a & b))", set)) == a);
+
+	// Distribution, into the same member for equivalent inputs
+	Sentence s = SentenceNormalizer_apply(dnf,
+		Sentence_parse("(a v b) & c", set));
+	assert(s == SentenceNormalizer_apply(dnf,
+		Sentence_parse("(c & b) v (a & c)", set)));
+	assert(Sentence_areEquivalent(s, Sentence_parse("(a v b) & c", set)));
+	assert(SentenceNormalizer_apply(dnf,
+		Sentence_parse("(a & b) v (a & (b & c))", set))
+		== SentenceNormalizer_apply(dnf, Sentence_parse("b & a", set)));
+	assert(SentenceNormalizer_apply(cnf, Sentence_parse("a > (b > a)", set))
+		== SentenceNormalizer_apply(cnf, Sentence_parse("~(b & ~a) v ~a", set)));
+
+	// Agrees with the truth table
+	uint32_t seed = 91;
+	for (int n = 0; n < 200; n++)
+	{
+		int vars = 1 + n % 6;
+		Sentence t = _randomSentence(set, &seed, 5, vars);
+		SentenceNormalizer normalizers[3] = {nnf, dnf, cnf};
+
+		for (int k = 0; k < 3; k++)
+		{
+			Sentence u = SentenceNormalizer_apply(normalizers[k], t);
+			assert(u);
+			_checkNormal(u, normalizers[k]->form);
+			assert(Sentence_areEquivalent(t, u));
+		}
+	}
+
+	// Distribution gives up past the budget
+	Sentence product = NULL;
+	for (int n = 0; n < 13; n++)
+	{
+		Sentence clause = SentenceSet_createCompound(set, OR,
+			_variable(set, "w", 2 * n, 0), _variable(set, "w", 2 * n + 1, 0),
+			0);
+		product = product
+			? SentenceSet_createCompound(set, AND, clause, product, 0)
+			: clause;
+	}
+
+	assert(SentenceNormalizer_apply(dnf, product) == NULL);
+	s = SentenceNormalizer_apply(cnf, product);
+	assert(s == SentenceNormalizer_apply(cnf, s));
+	_checkNormal(s, NORMAL_CNF);
+
+	// Shared subsentences are transformed once, not once per path
+	Sentence chain = _variable(set, "v", 0, 0);
+	for (int n = 1; n < 40; n++)
+	{
+		chain = SentenceSet_createCompound(set, MATERIAL_BICONDITIONAL,
+			chain, _variable(set, "v", n, 0), n % 3 == 0);
+	}
+
+	size_t size = set->size;
+	s = SentenceNormalizer_apply(nnf, chain);
+	_checkNormal(s, NORMAL_NNF);
+	assert(set->size - size < 40 * 8);
+
+	// Deep sentences do not use the call stack
+	Sentence deep = a;
+	for (int n = 0; n < 200000; n++)
+	{
+		deep = SentenceSet_createCompound(set, MATERIAL_CONDITIONAL,
+			_variable(set, "v", n % 2, 0), deep, n % 2);
+	}
+
+	_checkNormal(SentenceNormalizer_apply(nnf, deep), NORMAL_NNF);
+
+	SentenceNormalizer_free(nnf);
+	SentenceNormalizer_free(dnf);
+	SentenceNormalizer_free(cnf);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCENORMAL() : SUCCESS\n");
+}
+
+int main()
+{
+	_TEST_EVALUATE();
+	_TEST_TRUTH_TABLE();
+	_TEST_TRUTH_TABLE_RANDOM();
+	_TEST_TRUTH_TABLE_THREADS();
+	_TEST_SENTENCEPROGRAM();
+	_TEST_SENTENCECNF();
+	_TEST_SENTENCESAT();
+	_TEST_SENTENCESOLVER();
+	_TEST_SENTENCESESSION();
+	_TEST_SENTENCECOUNT();
+	_TEST_SENTENCEBDD();
+	_TEST_SENTENCETABLEAU();
+	_TEST_SENTENCENORMAL();
+}
@@ -6,6 +6,15 @@
  */
 
 #include "sentence.h"
+#include "sentencepack.h"
+#include "sentencewrite.h"
+#include "sentencefile.h"
+#include "sentencestream.h"
+#include "sentenceparallel.h"
+#include "sentencemap.h"
+#include "sentencepattern.h"
+#include "sentenceoccurrence.h"
+#include "sentencesubstitution.h"
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
@@ -194,6 +203,964 @@ static void _TEST_SENTENCE_PARSE(char* in)
 	printf("_TEST_SENTENCE_PARSE() : SUCCESS\n");
 }
 
+static void _TEST_SENTENCE_PARSE_GRAMMAR()
+{
+	SentenceSet set = SentenceSet_create();
+
+	// Operators associate to the right
+	Sentence s = Sentence_parse("a & b v c", set);
+	assert(s->op == AND);
+	assert(s->left.sentence->type == ATOMIC);
+	assert(s->right.sentence->op == OR);
+
+	// Parens group, ~( negates only the group
+	s = Sentence_parse(" ( a & b )  v ~(c)", set);
+	assert(s->op == OR);
+	assert(s->left.sentence->op == AND);
+	assert(s->right.sentence->negated == 1);
+	assert(strcmp(s->right.sentence->left.variable, "c") == 0);
+
+	// A bare ~ negates the rest of its group
+	s = Sentence_parse("(~a > b) = c", set);
+	assert(s->left.sentence->op == MATERIAL_CONDITIONAL);
+	assert(s->left.sentence->negated == 1);
+
+	// Malformed input is rejected
+	assert(Sentence_parse("", set) == NULL);
+	assert(Sentence_parse("(a & b", set) == NULL);
+	assert(Sentence_parse("a & b)", set) == NULL);
+	assert(Sentence_parse("a & ", set) == NULL);
+	assert(Sentence_parse("a (b)", set) == NULL);
+
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCE_PARSE_GRAMMAR() : SUCCESS\n");
+}
+
+static void _TEST_ARENA()
+{
+	Arena arena = Arena_create();
+
+	// Allocations are aligned and do not overlap
+	char* a = Arena_alloc(arena, 3);
+	char* b = Arena_alloc(arena, 40);
+	assert(((uintptr_t) b) % ARENA_ALIGNMENT == 0);
+	assert(b >= a + 3);
+
+	// Oversized allocations get their own block
+	char* big = Arena_alloc(arena, ARENA_BLOCK_SIZE * 2);
+	memset(big, 1, ARENA_BLOCK_SIZE * 2);
+
+	Sentence atomic = Sentence_createAtomicIn(arena, "abc", 1);
+	assert(strcmp(atomic->left.variable, "abc") == 0);
+	assert(atomic->negated == 1);
+
+	Arena_reset(arena);
+	Arena_free(arena);
+
+	// Arena-backed sets release everything at once
+	SentenceSet set = SentenceSet_createArena();
+	Sentence s = Sentence_parse("(a & b) > ~(c v d)", set);
+	assert(s->op == MATERIAL_CONDITIONAL);
+	assert(set->size == 8);
+	SentenceSet_free(set);
+
+	printf("_TEST_ARENA() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCESET_HASHCONS()
+{
+	SentenceSet set = SentenceSet_create();
+
+	// Equal subsentences share one node
+	Sentence s = Sentence_parse("(a & ~b) v (a & ~b)", set);
+	assert(s->left.sentence == s->right.sentence);
+	assert(set->size == 5);
+
+	// Parsing an equal sentence returns the same node
+	assert(Sentence_parse("((a & ~b)) v ( a&~b )", set) == s);
+
+	// Constructors return members
+	Sentence a = SentenceSet_createAtomic(set, "a", 0);
+	Sentence nb = SentenceSet_createAtomic(set, "b", 1);
+	assert(a == s->left.sentence->left.sentence);
+	assert(SentenceSet_createCompound(set, AND, a, nb, 0) == s->left.sentence);
+
+	// Foreign sentences are found by structure
+	Sentence b2 = Sentence_createAtomic("b", 1);
+	Sentence c2 = Sentence_createCompound(AND, a, b2, 0);
+	assert(SentenceSet_find(set, c2) == s->left.sentence);
+	Sentence d2 = Sentence_createCompound(OR, b2, a, 0);
+	assert(SentenceSet_find(set, d2) == NULL);
+
+	// Adding a foreign sentence copies it in and keeps it alive
+	SentenceSet_add(set, d2);
+	SentenceSet_add(set, d2);
+	assert(SentenceSet_find(set, d2) != d2);
+	assert(SentenceSet_contains(set, d2));
+	assert(set->size == 6);
+
+	// Many members
+	char buf[32];
+	for (int n = 0; n < 10000; n++)
+	{
+		sprintf(buf, "x%d > ~y%d", n, n % 100);
+		Sentence_parse(buf, set);
+	}
+	assert(SentenceSet_contains(set, Sentence_parse("x9999 > ~y99", set)));
+	assert(set->size == 6 + 10000 * 2 + 100 * 2);
+
+	SentenceSet_free(set);
+	Sentence_free(b2);
+	Sentence_free(c2);
+
+	printf("_TEST_SENTENCESET_HASHCONS() : SUCCESS\n");
+}
+
+static void _TEST_SYMBOL()
+{
+	// Names are interned once, ids are dense
+	uint32_t count = Symbol_count();
+	uint32_t p = Symbol_intern("p_sym", 5);
+	uint32_t q = Symbol_intern("q_sym and more", 5);
+	assert(p == count && q == count + 1);
+	assert(Symbol_intern("p_sym", 5) == p);
+	assert(Symbol_find("q_sym", 5) == q);
+	assert(Symbol_find("r_sym", 5) == SYMBOL_NONE);
+	assert(strcmp(Symbol_name(q), "q_sym") == 0);
+
+	// Atomic sentences carry the id and resolve the name
+	Sentence a = Sentence_createAtomic("p_sym", 0);
+	assert(a->id == p);
+	assert(a->left.variable == Symbol_name(p));
+
+	SentenceSet set = SentenceSet_create();
+	Sentence s = Sentence_parse("p_sym & q_sym", set);
+	assert(s->left.sentence->id == p);
+	assert(s->right.sentence->id == q);
+	assert(SentenceSet_createVariable(set, q, 0) == s->right.sentence);
+	SentenceSet_free(set);
+	Sentence_free(a);
+
+	printf("_TEST_SYMBOL() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCEPACK()
+{
+	SentenceSet set = SentenceSet_create();
+	Sentence s = Sentence_parse("(a & ~b) = ~((a & ~b) v c)", set);
+
+	assert(sizeof(PackedSentence) <= 12);
+
+	// Shared subsentences are packed once, children before parents
+	SentencePack pack = SentencePack_create();
+	uint32_t root = SentencePack_add(pack, s);
+	assert(root == pack->size - 1);
+	assert(pack->size == 6);
+
+	for (uint32_t n = 0; n < pack->size; n++)
+	{
+		if (!PACKED_IS_COMPOUND(pack->nodes[n])) continue;
+		assert(pack->nodes[n].left < n && pack->nodes[n].right < n);
+	}
+
+	PackedSentence top = pack->nodes[root];
+	assert(PACKED_OP(top) == MATERIAL_BICONDITIONAL);
+	assert(!PACKED_IS_NEGATED(top));
+	assert(PACKED_IS_NEGATED(pack->nodes[top.right]));
+
+	// Round trip into the same set gives back the same member
+	assert(SentencePack_toSentence(pack, root, set) == s);
+
+	// Round trip into another set gives an equal sentence
+	SentenceSet other = SentenceSet_create();
+	assert(Sentence_equals(SentencePack_toSentence(pack, root, other), s));
+
+	// Packing a whole set keeps member order
+	SentencePack all = SentencePack_fromSet(set);
+	assert(all->size == set->size);
+	assert(SentencePack_toSentence(all, set->size - 1, other)
+		== SentenceSet_find(other, set->sentences[set->size - 1]));
+
+	SentencePack_free(all);
+	SentencePack_free(pack);
+	SentenceSet_free(other);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCEPACK() : SUCCESS\n");
+}
+
+static uint8_t _countPre(const Sentence sentence, void* data)
+{
+	(void) sentence;
+	(*(size_t*) data)++;
+	return 1;
+}
+
+static void _TEST_DEEP_SENTENCE()
+{
+	const size_t depth = 200000;
+	char* in = malloc(depth * 4 + 2);
+	char* out = in;
+
+	// a > a > ... > a nests to the right, ~ scopes nest as well
+	for (size_t n = 0; n < depth; n++)
+	{
+		memcpy(out, n % 2 ? "a > " : "~b& ", 4);
+		out += 4;
+	}
+	strcpy(out, "c");
+
+	SentenceSet set = SentenceSet_create();
+	SentenceSet other = SentenceSet_create();
+	Sentence s1 = Sentence_parse(in, set);
+	Sentence s2 = Sentence_parse(in, other);
+	assert(s1 != NULL && s2 != NULL);
+	assert(Sentence_equals(s1, s2));
+	assert(SentenceSet_find(other, s1) == s2);
+
+	// Every occurrence is visited, but shared atoms only once when unique
+	size_t count = 0;
+	SentenceVisitor visitor = {_countPre, NULL, NULL, &count};
+	Sentence_visit(s1, &visitor);
+	assert(count == depth * 2 + 1);
+	count = 0;
+	Sentence_visitUnique(s1, &visitor);
+	assert(count < depth * 2 + 1);
+
+	free(in);
+	SentenceSet_free(set);
+	SentenceSet_free(other);
+
+	printf("_TEST_DEEP_SENTENCE() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCE_PARSE_BUFFER()
+{
+	// Parse slices of a read-only buffer without terminating them
+	static const char corpus[] = "a & b\n~(c v a)\n(a & b";
+	SentenceSet set = SentenceSet_create();
+
+	Sentence s1 = Sentence_parseBuffer(corpus, 5, set);
+	Sentence s2 = Sentence_parseBuffer(corpus + 6, 8, set);
+	assert(s1 == Sentence_parse("a & b", set));
+	assert(s2 == Sentence_parse("~(c v a)", set));
+	assert(s2->right.sentence == s1->left.sentence);
+
+	// A slice that ends inside a group is malformed
+	assert(Sentence_parseBuffer(corpus + 15, 4, set) == NULL);
+
+	// Embedded null characters are rejected
+	assert(Sentence_parseBuffer("a\0 & b", 6, set) == NULL);
+
+	// Lines skip blanks and drop a trailing carriage return
+	Sentence line = s2;
+	assert(Sentence_parseLine(" \t\r", 3, set, &line) == 0);
+	assert(line == s2);
+	assert(Sentence_parseLine("a & b\r", 6, set, &line) && line == s1);
+	assert(Sentence_parseLine("(a & b", 6, set, &line) && line == NULL);
+
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCE_PARSE_BUFFER() : SUCCESS\n");
+}
+
+/**
+ * Builds a pseudo-random sentence in the set from the given seed.
+ */
+static Sentence _randomSentence(SentenceSet set, uint32_t* seed, int depth)
+{
+	*seed = *seed * 1103515245 + 12345;
+	uint32_t r = (*seed >> 16) % 8;
+	uint8_t negated = (*seed >> 8) % 3 == 0;
+
+	if (depth == 0 || r < 2)
+	{
+		const char* names[] = {"p", "q", "r", "s"};
+		return SentenceSet_createAtomic(set, names[r % 4], negated);
+	}
+
+	Sentence left = _randomSentence(set, seed, depth - 1);
+	Sentence right = _randomSentence(set, seed, depth - 1);
+	return SentenceSet_createCompound(set, 1 + r % 4, left, right, negated);
+}
+
+static void _TEST_SENTENCE_WRITE()
+{
+	SentenceSet set = SentenceSet_create();
+	Sentence s = Sentence_parse("(a & ~b) > ~(c v d) = ~e", set);
+	char out[64];
+
+	// Both formats, with precomputed lengths
+	assert(Sentence_toString(s, FORMAT_FULL, out, sizeof(out)) == 28);
+	assert(strcmp(out, "((a & ~b) > (~(c v d) = ~e))") == 0);
+	assert(Sentence_length(s, FORMAT_FULL) == 28);
+	Sentence_toString(s, FORMAT_MINIMAL, out, sizeof(out));
+	assert(strcmp(out, "(a & ~b) > ~(c v d) = ~e") == 0);
+	assert(Sentence_length(s, FORMAT_MINIMAL) == strlen(out));
+
+	// Negated atoms that are not last keep their own group
+	s = Sentence_parse("(~a) & b", set);
+	Sentence_toString(s, FORMAT_MINIMAL, out, sizeof(out));
+	assert(strcmp(out, "(~a) & b") == 0);
+
+	// Truncation behaves like snprintf
+	assert(Sentence_toString(s, FORMAT_FULL, out, 4) == 8);
+	assert(strcmp(out, "(~a") == 0);
+
+	// Minimal output reads back as the same member
+	SentenceText text = {0};
+	uint32_t seed = 7;
+	for (int n = 0; n < 500; n++)
+	{
+		s = _randomSentence(set, &seed, 6);
+		text.length = 0;
+		Sentence_append(&text, s, FORMAT_FULL);
+		assert(text.length == Sentence_length(s, FORMAT_FULL));
+		text.length = 0;
+		Sentence_append(&text, s, FORMAT_MINIMAL);
+		assert(text.length == Sentence_length(s, FORMAT_MINIMAL));
+		assert(Sentence_parse(text.data, set) == s);
+	}
+	free(text.data);
+
+	// Files get the same text
+	FILE* file = tmpfile();
+	size_t written = SentenceSet_write(file, set, FORMAT_MINIMAL);
+	assert((size_t) ftell(file) == written);
+	fclose(file);
+
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCE_WRITE() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCEFILE()
+{
+	const char* path = "_TEST_SENTENCEFILE.bin";
+	SentenceSet set = SentenceSet_create();
+	Sentence_parse("(alpha & ~beta) = ~((alpha & ~beta) v gamma)", set);
+	Sentence_parse("gamma > delta", set);
+	assert(SentenceSet_save(set, path));
+
+	SentenceImage image = SentenceImage_load(path);
+	assert(image != NULL);
+	assert(image->numNodes == set->size);
+	assert(image->numVariables == 4);
+	assert(strcmp(SentenceImage_variable(image, 0), "alpha") == 0);
+	assert(SentenceImage_variable(image, 4) == NULL);
+
+	// Nodes map back to the members, in order, in the original set
+	for (uint32_t n = 0; n < image->numNodes; n++)
+	{
+		assert(SentenceImage_toSentence(image, n, set) == set->sentences[n]);
+	}
+
+	assert(SentenceImage_toSentence(image, image->numNodes, set) == NULL);
+	assert(SentenceImage_toSentence(image, UINT32_MAX, set) == NULL);
+
+	// and to equal members in a fresh set
+	SentenceSet other = SentenceSet_create();
+	SentenceImage_toSet(image, other);
+	assert(other->size == set->size);
+	for (size_t n = 0; n < set->size; n++)
+	{
+		assert(Sentence_equals(other->sentences[n], set->sentences[n]));
+	}
+	SentenceImage_free(image);
+
+	// Corrupt files are rejected
+	FILE* file = fopen(path, "r+b");
+	fseek(file, -1, SEEK_END);
+	fputc('x', file);
+	fclose(file);
+	assert(SentenceImage_load(path) == NULL);
+	assert(SentenceImage_load("_TEST_SENTENCEFILE.missing") == NULL);
+
+	remove(path);
+	SentenceSet_free(other);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCEFILE() : SUCCESS\n");
+}
+
+static void _countLines(const Sentence sentence, const size_t line, void* data)
+{
+	size_t* counts = data;
+	counts[sentence == NULL]++;
+	counts[2] = line;
+}
+
+static void _TEST_SENTENCESTREAM()
+{
+	const char* path = "_TEST_SENTENCESTREAM.txt";
+	FILE* file = fopen(path, "w");
+	fprintf(file, "a & b\r\n\n  \n(a & b\nc > ~d\n");
+
+	// A line longer than one chunk
+	for (size_t n = 0; n < SENTENCESTREAM_CHUNK / 4; n++) fputs("e & ", file);
+	fputs("e\n~(a & b)", file);
+	fclose(file);
+
+	SentenceSet set = SentenceSet_create();
+	SentenceReader reader = SentenceReader_open(path);
+	Sentence s;
+
+	// Blank lines are skipped, malformed lines are reported
+	assert(SentenceReader_next(reader, set, &s));
+	assert(s == Sentence_parse("a & b", set) && reader->line == 1);
+	assert(SentenceReader_next(reader, set, &s));
+	assert(s == NULL && reader->line == 4);
+
+	// The rest goes through the callback
+	size_t counts[3] = {0, 0, 0};
+	assert(SentenceReader_parseAll(reader, set, _countLines, counts) == 0);
+	assert(counts[0] == 3 && counts[1] == 0 && counts[2] == 7);
+	assert(SentenceSet_contains(set, Sentence_parse("~(a & b)", set)));
+	assert(!reader->error);
+
+	SentenceReader_free(reader);
+	SentenceSet_free(set);
+	remove(path);
+	assert(SentenceReader_open(path) == NULL);
+
+	printf("_TEST_SENTENCESTREAM() : SUCCESS\n");
+}
+
+static void _storeLine(const Sentence sentence, const size_t line, void* data)
+{
+	((Sentence*) data)[line] = sentence;
+}
+
+static void _TEST_PARALLEL_PARSE()
+{
+	// A corpus of random sentences, with blank and malformed lines
+	const char* path = "_TEST_PARALLEL_PARSE.txt";
+	const size_t lines = 20000;
+	SentenceSet source = SentenceSet_create();
+	FILE* file = fopen(path, "w");
+	uint32_t seed = 11;
+
+	for (size_t n = 1; n <= lines; n++)
+	{
+		if (n % 1000 == 0) fputs("(a & b", file);
+		else if (n % 100 != 0)
+			Sentence_write(file, _randomSentence(source, &seed, 8),
+				FORMAT_MINIMAL);
+		fputs(n % 7 == 0 ? "\r\n" : "\n", file);
+	}
+
+	size_t len = (size_t) ftell(file);
+	fclose(file);
+	SentenceSet_free(source);
+
+	char* corpus = malloc(len);
+	file = fopen(path, "r");
+	assert(fread(corpus, 1, len, file) == len);
+	fclose(file);
+
+	// Parse on four threads, then one line at a time
+	Sentence* parallel = calloc(lines + 1, sizeof(Sentence));
+	SentenceSet set = SentenceSet_create();
+	assert(SentenceSet_parseParallel(
+		set, corpus, len, 4, _storeLine, parallel) == 20);
+	assert(set->shared == NULL);
+
+	SentenceSet sequential = SentenceSet_create();
+	char* line = corpus;
+
+	for (size_t n = 1; n <= lines; n++)
+	{
+		char* newline = memchr(line, '\n', corpus + len - line);
+		size_t length = newline - line;
+		if (length > 0 && line[length-1] == '\r') length--;
+
+		if (n % 100 == 0 && n % 1000 != 0)
+		{
+			assert(parallel[n] == NULL);
+		}
+		else
+		{
+			Sentence s = Sentence_parseBuffer(line, length, sequential);
+			assert((s == NULL) == (n % 1000 == 0));
+			assert(s == NULL || Sentence_equals(s, parallel[n]));
+
+			// Members found by different threads are still shared
+			size_t size = set->size;
+			assert(Sentence_parseBuffer(line, length, set) == parallel[n]);
+			assert(set->size == size);
+		}
+
+		line = newline + 1;
+	}
+
+	assert(set->size == sequential->size);
+	assert(set->addedCount == sequential->addedCount);
+
+	// Children come before their parents
+	SentenceMap index = SentenceMap_create();
+	for (size_t n = 0; n < set->size; n++)
+	{
+		Sentence s = set->sentences[n];
+		if (s->type == COMPOUND)
+		{
+			assert(SentenceMap_get(index, s->left.sentence, NULL));
+			assert(SentenceMap_get(index, s->right.sentence, NULL));
+		}
+		SentenceMap_put(index, s, NULL);
+	}
+	SentenceMap_free(index);
+
+	// Files are mapped, and the thread count can be left to the library
+	SentenceSet mapped = SentenceSet_create();
+	assert(SentenceSet_parseFileParallel(mapped, path, 0, NULL, NULL) == 20);
+	assert(mapped->size == set->size);
+	assert(mapped->addedCount == set->addedCount);
+	remove(path);
+	assert(SentenceSet_parseFileParallel(mapped, path, 0, NULL, NULL)
+		== SIZE_MAX);
+
+	SentenceSet_free(mapped);
+	SentenceSet_free(sequential);
+	SentenceSet_free(set);
+	free(parallel);
+	free(corpus);
+
+	printf("_TEST_PARALLEL_PARSE() : SUCCESS\n");
+}
+
+static uint8_t _collect(
+	const Sentence sentence,
+	const Sentence* bindings,
+	void* data)
+{
+	(void) bindings;
+	SentenceMap found = data;
+	assert(!SentenceMap_get(found, sentence, NULL));
+	SentenceMap_put(found, sentence, NULL);
+	return 1;
+}
+
+static uint8_t _first(
+	const Sentence sentence,
+	const Sentence* bindings,
+	void* data)
+{
+	(void) sentence;
+	(void) bindings;
+	(void) data;
+	return 0;
+}
+
+/**
+ * Checks the index against matching every indexed member of the set, one
+ * at a time. Returns the number of matches.
+ */
+static size_t _matchAll(SentenceIndex index, SentenceSet set, const char* text)
+{
+	SentenceSet patterns = SentenceSet_create();
+	SentencePattern pattern = SentencePattern_create(
+		Sentence_parse(text, patterns));
+	SentenceMap found = SentenceMap_create();
+
+	size_t size = SentenceIndex_size(index);
+	size_t matches = SentenceIndex_match(index, pattern, _collect, found);
+	size_t expected = 0;
+
+	for (size_t n = 0; n < size; n++)
+	{
+		uint8_t match = SentencePattern_match(set, pattern,
+			set->sentences[n], NULL);
+		assert(match == SentenceMap_get(found, set->sentences[n], NULL));
+		expected += match;
+	}
+
+	assert(matches == expected);
+
+	SentenceMap_free(found);
+	SentencePattern_free(pattern);
+	SentenceSet_free(patterns);
+	return matches;
+}
+
+static void _TEST_SENTENCEPATTERN()
+{
+	SentenceSet set = SentenceSet_create();
+	Sentence ab = Sentence_parse("a > b", set);
+	Sentence nab = Sentence_parse("~(a & b)", set);
+	Sentence_parse("(a & b) > c", set);
+	Sentence_parse("a v a", set);
+	Sentence_parse("b v a", set);
+	Sentence_parse("~(a v b)", set);
+	Sentence a = Sentence_parse("a", set);
+	SentenceSet patterns = SentenceSet_create();
+
+	// Bindings follow the first occurrences of the metavariables
+	SentencePattern pattern = SentencePattern_create(
+		Sentence_parse("(Q & P) > Q", patterns));
+	assert(pattern->numVariables == 2);
+	assert(strcmp(Symbol_name(pattern->variables[0]), "Q") == 0);
+	SentencePattern_free(pattern);
+
+	pattern = SentencePattern_create(Sentence_parse("P > Q", patterns));
+	Sentence bindings[2];
+	assert(SentencePattern_match(set, pattern, ab, bindings));
+	assert(bindings[0] == a);
+	assert(bindings[1] == SentenceSet_createAtomic(set, "b", 0));
+	assert(!SentencePattern_match(set, pattern, nab, bindings));
+	SentencePattern_free(pattern);
+
+	// A negated metavariable binds to the negation of what it matches
+	pattern = SentencePattern_create(Sentence_parse("~P", patterns));
+	assert(SentencePattern_match(set, pattern, nab, bindings));
+	assert(bindings[0] == Sentence_parse("a & b", set));
+	assert(SentencePattern_match(set, pattern, ab, bindings));
+	assert(bindings[0] == Sentence_parse("~(a > b)", set));
+	SentencePattern_free(pattern);
+
+	// Either part of a contradiction can be the negated one
+	Sentence ana = Sentence_parse("a & ~a", set);
+	Sentence naa = Sentence_parse("(~a) & a", set);
+	pattern = SentencePattern_create(Sentence_parse("P & ~P", patterns));
+	assert(SentencePattern_match(set, pattern, ana, bindings));
+	assert(bindings[0] == a);
+	assert(SentencePattern_match(set, pattern, naa, bindings));
+	assert(bindings[0] == Sentence_parse("~a", set));
+	assert(!SentencePattern_match(set, pattern,
+		Sentence_parse("a & a", set), NULL));
+	SentencePattern_free(pattern);
+
+	// Only bindings handed out add negations to the set
+	SentenceSet other = SentenceSet_create();
+	Sentence ba = Sentence_parse("b v a", other);
+	pattern = SentencePattern_create(Sentence_parse("~P v ~P", patterns));
+	assert(!SentencePattern_match(other, pattern, ba, NULL));
+	SentencePattern_free(pattern);
+	pattern = SentencePattern_create(Sentence_parse("~P", patterns));
+	assert(SentencePattern_match(other, pattern, ba, NULL));
+	assert(other->size == 3);
+	assert(SentencePattern_match(other, pattern, ba, bindings));
+	assert(other->size == 4 && bindings[0]->negated);
+	SentencePattern_free(pattern);
+	SentenceSet_free(other);
+
+	SentenceIndex index = SentenceIndex_create(set);
+	assert(SentenceIndex_size(index) == set->size);
+	assert(_matchAll(index, set, "P > Q") == 2);
+	assert(_matchAll(index, set, "P v P") == 1);
+	assert(_matchAll(index, set, "~(P & Q)") == 1);
+	assert(_matchAll(index, set, "~(P v a)") == 0);
+	assert(_matchAll(index, set, "P") == set->size);
+	assert(_matchAll(index, set, "~P") == SentenceIndex_size(index));
+	assert(_matchAll(index, set, "P & ~P") == 2);
+
+	// The index only sees members once it is updated
+	Sentence_parse("(a & b) > (a & b)", set);
+	assert(_matchAll(index, set, "P > P") == 0);
+	SentenceIndex_update(index);
+	assert(SentenceIndex_size(index) == set->size);
+	assert(_matchAll(index, set, "P > P") == 1);
+	assert(_matchAll(index, set, "(P & Q) > R") == 2);
+
+	// The callback can stop the search
+	pattern = SentencePattern_create(Sentence_parse("P", patterns));
+	assert(SentenceIndex_match(index, pattern, _first, NULL) == 1);
+	assert(SentenceIndex_match(index, pattern, NULL, NULL) == set->size);
+	SentencePattern_free(pattern);
+	SentenceIndex_free(index);
+
+	// Random members, with patterns deeper than the index, and members
+	// differing from the patterns only below the levels told apart
+	Sentence_parse("(((p & a) v b) > (c & ~d)) & e", set);
+	Sentence_parse("(((q & a) v b) > (c & ~d)) & e", set);
+	Sentence_parse("((((a & b) v c) > d) & e) = (a v ~f)", set);
+	Sentence_parse("((((a & b) v c) > d) & e) = (b v ~f)", set);
+	Sentence_parse("(p & q) = (q & p)", set);
+	uint32_t seed = 7;
+	index = SentenceIndex_create(set);
+	for (int round = 0; round < 4; round++)
+	{
+		for (int n = 0; n < 500; n++) _randomSentence(set, &seed, 7);
+		SentenceIndex_update(index);
+
+		_matchAll(index, set, "P > Q");
+		_matchAll(index, set, "~P v ~Q");
+		_matchAll(index, set, "(P & Q) = (Q & P)");
+		_matchAll(index, set, "~(P v (Q > ~R))");
+		_matchAll(index, set, "(((p & P) v Q) > (R & ~S)) & T");
+		_matchAll(index, set, "((((P & Q) v R) > S) & T) = (P v ~U)");
+		_matchAll(index, set, "~((((~P > Q) v R) & S) = T)");
+	}
+
+	SentenceIndex_free(index);
+	SentenceSet_free(patterns);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCEPATTERN() : SUCCESS\n");
+}
+
+/**
+ * Marks every member the sentence contains, itself included.
+ */
+static void _contained(const Sentence sentence, SentenceMap found)
+{
+	if (SentenceMap_get(found, sentence, NULL)) return;
+	SentenceMap_put(found, sentence, NULL);
+	if (sentence->type != COMPOUND) return;
+	_contained(sentence->left.sentence, found);
+	_contained(sentence->right.sentence, found);
+}
+
+/**
+ * Checks every member's parents and roots against a walk of the whole
+ * set and of its added sentences.
+ */
+static void _checkOccurrences(SentenceOccurrences occurrences, SentenceSet set)
+{
+	SentenceMap* contents = malloc(set->addedCount * sizeof(SentenceMap));
+
+	for (size_t m = 0; m < set->addedCount; m++)
+	{
+		contents[m] = SentenceMap_create();
+		_contained(set->added[m], contents[m]);
+	}
+
+	for (size_t n = 0; n < set->size; n++)
+	{
+		Sentence s = set->sentences[n];
+		size_t size;
+		const Sentence* parents = SentenceOccurrences_parents(occurrences, s,
+			&size);
+		size_t expected = 0;
+
+		for (size_t p = 0; p < set->size; p++)
+		{
+			Sentence parent = set->sentences[p];
+			if (parent->type != COMPOUND) continue;
+			if (parent->left.sentence != s && parent->right.sentence != s)
+				continue;
+			assert(expected < size && parents[expected] == parent);
+			expected++;
+		}
+
+		assert(size == expected);
+
+		const Sentence* roots = SentenceOccurrences_roots(occurrences, s,
+			&size);
+		expected = 0;
+
+		for (size_t m = 0; m < set->addedCount; m++)
+		{
+			if (!SentenceMap_get(contents[m], s, NULL)) continue;
+			assert(expected < size && roots[expected] == set->added[m]);
+			expected++;
+		}
+
+		assert(size == expected);
+	}
+
+	for (size_t m = 0; m < set->addedCount; m++)
+	{
+		SentenceMap_free(contents[m]);
+	}
+
+	free(contents);
+}
+
+static void _TEST_SENTENCEOCCURRENCES()
+{
+	SentenceSet set = SentenceSet_create();
+	Sentence ab = Sentence_parse("a & b", set);
+	Sentence abc = Sentence_parse("(a & b) > c", set);
+	Sentence nac = Sentence_parse("(~a) v c", set);
+	SentenceOccurrences occurrences = SentenceOccurrences_create(set);
+
+	size_t size;
+	const Sentence* found = SentenceOccurrences_parents(occurrences, ab,
+		&size);
+	assert(size == 1 && found[0] == abc);
+	assert(!SentenceOccurrences_parents(occurrences, abc, &size));
+	assert(size == 0);
+
+	// The negated variable is a member of its own
+	Sentence a = SentenceOccurrences_variable(occurrences,
+		Symbol_find("a", 1), 0);
+	Sentence na = SentenceOccurrences_variable(occurrences,
+		Symbol_find("a", 1), 1);
+	assert(a == SentenceSet_createAtomic(set, "a", 0));
+	assert(!SentenceOccurrences_variable(occurrences, Symbol_find("c", 1), 1));
+	found = SentenceOccurrences_roots(occurrences, a, &size);
+	assert(size == 2 && found[0] == ab && found[1] == abc);
+	found = SentenceOccurrences_roots(occurrences, na, &size);
+	assert(size == 1 && found[0] == nac);
+	_checkOccurrences(occurrences, set);
+
+	// Members are found once the index is updated
+	Sentence cd = Sentence_parse("c & d", set);
+	Sentence c = SentenceSet_createAtomic(set, "c", 0);
+	SentenceOccurrences_roots(occurrences, c, &size);
+	assert(size == 2);
+	assert(!SentenceOccurrences_roots(occurrences, cd, &size));
+	SentenceOccurrences_update(occurrences);
+	found = SentenceOccurrences_roots(occurrences, c, &size);
+	assert(size == 3 && found[2] == cd);
+
+	// Added sentences stay roots inside later ones
+	Sentence abcd = Sentence_parse("((a & b) > c) & d", set);
+	SentenceOccurrences_update(occurrences);
+	found = SentenceOccurrences_roots(occurrences, ab, &size);
+	assert(size == 3 && found[0] == ab && found[2] == abcd);
+	found = SentenceOccurrences_roots(occurrences, c, &size);
+	assert(size == 4 && found[3] == abcd);
+	_checkOccurrences(occurrences, set);
+
+	// Adding a member that is already indexed makes it a root
+	SentenceSet_add(set, c);
+	SentenceOccurrences_update(occurrences);
+	found = SentenceOccurrences_roots(occurrences, c, &size);
+	assert(size == 5 && found[4] == c);
+
+	// Random members, a batch per update
+	uint32_t seed = 11;
+	for (int round = 0; round < 6; round++)
+	{
+		for (int n = 0; n < 40 * round; n++)
+		{
+			Sentence s = _randomSentence(set, &seed, 6);
+			if (n % 3) SentenceSet_add(set, s);
+		}
+
+		SentenceOccurrences_update(occurrences);
+		_checkOccurrences(occurrences, set);
+	}
+
+	SentenceOccurrences_free(occurrences);
+	SentenceSet_free(set);
+
+	// Subsentences of a negated premise are not roots, the premise is
+	set = SentenceSet_create();
+	Sentence premise = Sentence_parse("~(a & b)", set);
+	Sentence ca = Sentence_parse("c > a", set);
+	a = Sentence_parse("a", set);
+	occurrences = SentenceOccurrences_create(set);
+	found = SentenceOccurrences_roots(occurrences, a, &size);
+	assert(size == 3 && found[0] == premise && found[1] == ca);
+	assert(found[2] == a);
+	found = SentenceOccurrences_roots(occurrences, SentenceSet_createCompound(
+		set, AND, premise->left.sentence, premise->right.sentence, 0), &size);
+	assert(size == 0);
+	_checkOccurrences(occurrences, set);
+	SentenceOccurrences_free(occurrences);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCEOCCURRENCES() : SUCCESS\n");
+}
+
+static void _TEST_SENTENCESUBSTITUTION()
+{
+	SentenceSet set = SentenceSet_create();
+	Sentence a = SentenceSet_createAtomic(set, "a", 0);
+	Sentence bc = Sentence_parse("b & c", set);
+	SentenceSubstitution substitution = SentenceSubstitution_create(set);
+	SentenceSubstitution_put(substitution, a, bc);
+
+	// Negated occurrences get the negated replacement
+	Sentence s = Sentence_parse("(a > d) & ~a", set);
+	assert(SentenceSubstitution_apply(substitution, s)
+		== Sentence_parse("((b & c) > d) & ~(b & c)", set));
+
+	// Unchanged subsentences are the same members
+	s = Sentence_parse("(d v e) & (a v (d v e))", set);
+	Sentence t = SentenceSubstitution_apply(substitution, s);
+	assert(t == Sentence_parse("(d v e) & ((b & c) v (d v e))", set));
+	assert(t->left.sentence == s->left.sentence);
+	assert(t->right.sentence->right.sentence == s->left.sentence);
+	s = Sentence_parse("d > ~e", set);
+	assert(SentenceSubstitution_apply(substitution, s) == s);
+	SentenceSubstitution_free(substitution);
+
+	// A replacement put for a negation is kept, whatever the order
+	Sentence x = SentenceSet_createAtomic(set, "x", 0);
+	Sentence y = SentenceSet_createAtomic(set, "y", 0);
+	Sentence na = SentenceSet_createAtomic(set, "a", 1);
+	substitution = SentenceSubstitution_create(set);
+	SentenceSubstitution_put(substitution, na, y);
+	SentenceSubstitution_put(substitution, a, x);
+	assert(SentenceSubstitution_apply(substitution, na) == y);
+	assert(SentenceSubstitution_apply(substitution, a) == x);
+	SentenceSubstitution_free(substitution);
+
+	substitution = SentenceSubstitution_create(set);
+	size_t size = set->size;
+	SentenceSubstitution_put(substitution, Sentence_parse("x & y", set), a);
+	assert(set->size == size + 1);
+	SentenceSubstitution_put(substitution, a, x);
+	assert(set->size == size + 1);
+	assert(SentenceSubstitution_apply(substitution, na)
+		== SentenceSet_createAtomic(set, "x", 1));
+	assert(SentenceSubstitution_apply(substitution,
+		Sentence_parse("~(x & y)", set)) == na);
+	SentenceSubstitution_put(substitution, na, y);
+	assert(SentenceSubstitution_apply(substitution, na) == y);
+	SentenceSubstitution_put(substitution, a, bc);
+	assert(SentenceSubstitution_apply(substitution, na) == y);
+	SentenceSubstitution_free(substitution);
+
+	// Replacements are made at once, and cancel negations
+	substitution = SentenceSubstitution_create(set);
+	SentenceSubstitution_putVariable(substitution, Symbol_find("a", 1),
+		SentenceSet_createAtomic(set, "b", 0));
+	SentenceSubstitution_putVariable(substitution, Symbol_find("b", 1),
+		SentenceSet_createAtomic(set, "a", 1));
+	s = Sentence_parse("(a > b) v (~b)", set);
+	assert(SentenceSubstitution_apply(substitution, s)
+		== Sentence_parse("(b > ~a) v a", set));
+
+	// Any subsentence can be replaced, and changes clear the memo
+	SentenceSubstitution_put(substitution, bc, a);
+	s = Sentence_parse("~(b & c) v (b & c)", set);
+	assert(SentenceSubstitution_apply(substitution, s)
+		== Sentence_parse("(~a) v a", set));
+	SentenceSubstitution_put(substitution, bc, Sentence_parse("d", set));
+	assert(SentenceSubstitution_apply(substitution, s)
+		== Sentence_parse("(~d) v d", set));
+	SentenceSubstitution_free(substitution);
+
+	// Shared subsentences are visited once, not once per path
+	Sentence from = a;
+	Sentence to = SentenceSet_createAtomic(set, "b", 0);
+	for (int n = 0; n < 64; n++)
+	{
+		from = SentenceSet_createCompound(set, AND, from, from, n % 2);
+		to = SentenceSet_createCompound(set, AND, to, to, n % 2);
+	}
+
+	substitution = SentenceSubstitution_create(set);
+	SentenceSubstitution_putVariable(substitution, Symbol_find("a", 1),
+		SentenceSet_createAtomic(set, "b", 0));
+	assert(SentenceSubstitution_apply(substitution, from) == to);
+	assert(substitution->memo->size == 65);
+	SentenceSubstitution_free(substitution);
+
+	// Deep sentences do not use the call stack
+	Sentence deep = a;
+	Sentence expected = bc;
+	for (int n = 0; n < 200000; n++)
+	{
+		Sentence e = SentenceSet_createAtomic(set, "e", 0);
+		deep = SentenceSet_createCompound(set, OR, e, deep, 0);
+		expected = SentenceSet_createCompound(set, OR, e, expected, 0);
+	}
+
+	substitution = SentenceSubstitution_create(set);
+	SentenceSubstitution_put(substitution, a, bc);
+	assert(SentenceSubstitution_apply(substitution, deep) == expected);
+	SentenceSubstitution_free(substitution);
+	SentenceSet_free(set);
+
+	printf("_TEST_SENTENCESUBSTITUTION() : SUCCESS\n");
+}
+
 int main(int argc, char** argv)
 {
 	(void) argc;
@@ -204,5 +1171,19 @@ int main(int argc, char** argv)
 	_TEST_SET();
 	_TEST_SENTENCE_EQUALS();
 	_TEST_SENTENCESET_CONTAINS();
+	_TEST_SENTENCE_PARSE_GRAMMAR();
+	_TEST_SENTENCE_PARSE_BUFFER();
+	_TEST_ARENA();
+	_TEST_SENTENCESET_HASHCONS();
+	_TEST_SYMBOL();
+	_TEST_SENTENCEPACK();
+	_TEST_DEEP_SENTENCE();
+	_TEST_SENTENCE_WRITE();
+	_TEST_SENTENCEFILE();
+	_TEST_SENTENCESTREAM();
+	_TEST_PARALLEL_PARSE();
+	_TEST_SENTENCEPATTERN();
+	_TEST_SENTENCEOCCURRENCES();
+	_TEST_SENTENCESUBSTITUTION();
 	_TEST_SENTENCE_PARSE(argv[1]);
 }
\ No newline at end of file